@@ -1,5 +1,7 @@
 #pragma once
 #include <JuceHeader.h>
+#include "ControlRate.h"
+#include "LevelDetector.h"
 
 /**
  * AutoWah - Memberikan efek wah otomatis yang "kental" (vocal character).
@@ -13,67 +15,85 @@ public:
     void prepare(const juce::dsp::ProcessSpec& spec)
     {
         sampleRate = spec.sampleRate;
-        for (int i = 0; i < 2; ++i)
-        {
-            filterStage1[i].prepare(spec);
-            filterStage2[i].prepare(spec);
-            filterStage1[i].setType(juce::dsp::StateVariableTPTFilterType::bandpass);
-            filterStage2[i].setType(juce::dsp::StateVariableTPTFilterType::bandpass);
-        }
-        
-        envelope = 0.0f;
+        for (auto& stage : filterStages)
+            for (auto& channel : stage)
+                channel = {};
+
+        gRamp.reset();
+        r2Ramp.reset();
+        sidechain.prepare((int) spec.maximumBlockSize, sampleRate);
+        follower.reset();
     }
 
     void setParameters(float sensitivity, float attackMs, float releaseMs, float baseFreq)
     {
         this->sensitivity = sensitivity;
-        attackCoeff = std::exp(-1.0f / (juce::jmax(1.0f, attackMs) * 0.001f * sampleRate));
-        releaseCoeff = std::exp(-1.0f / (juce::jmax(1.0f, releaseMs) * 0.001f * sampleRate));
+        follower.setCoefficients(EnvelopeFollower::getCoefficient(juce::jmax(1.0f, attackMs) * 0.001, sampleRate),
+                                 EnvelopeFollower::getCoefficient(juce::jmax(1.0f, releaseMs) * 0.001, sampleRate));
         this->baseFreq = baseFreq;
     }
 
+    struct Parameters
+    {
+        float sensitivity = 0.5f;
+        float attackMs = 10.0f;
+        float releaseMs = 100.0f;
+        float range = 400.0f;
+    };
+
+    void setParameters(const Parameters& p)
+    {
+        setParameters(p.sensitivity, p.attackMs, p.releaseMs, p.range);
+    }
+
+    /** Starts channel to from channel from's filter state. */
+    void copyChannelState(int from, int to)
+    {
+        for (auto& stage : filterStages)
+            stage[to] = stage[from];
+    }
+
     void process(juce::AudioBuffer<float>& buffer)
     {
         auto numChannels = buffer.getNumChannels();
         auto numSamples = buffer.getNumSamples();
 
+        sidechain.rectify(buffer);
+        const float* level = sidechain.getRectified();
+
         for (int i = 0; i < numSamples; ++i)
         {
             // Detect envelope (smooth follower)
-            float envIn = 0.0f;
-            for (int ch = 0; ch < numChannels; ++ch)
-                envIn = std::max(envIn, std::abs(buffer.getSample(ch, i)));
-
-            if (envIn > envelope)
-                envelope = envIn + attackCoeff * (envelope - envIn);
-            else
-                envelope = envIn + releaseCoeff * (envelope - envIn);
+            const float envelope = follower.process(level[i]);
 
-            // Calculate target frequency with nonlinear response
-            float sweep = std::pow(envelope * sensitivity, 0.7f); // Curves for more "vocal" response
-            float cutoff = baseFreq + (sweep * 6000.0f);
-            cutoff = juce::jlimit(100.0f, 10000.0f, cutoff);
+            // Filter sweep at control rate; the coefficients glide in between
+            if (gRamp.isDue())
+            {
+                // Calculate target frequency with nonlinear response
+                float sweep = std::pow(envelope * sensitivity, 0.7f); // Curves for more "vocal" response
+                float cutoff = baseFreq + (sweep * 6000.0f);
+                cutoff = juce::jlimit(100.0f, 10000.0f, cutoff);
 
-            // Dynamic resonance (higher resonance at higher frequency)
-            float res = 2.0f + (envelope * sensitivity * 4.0f); 
+                // Dynamic resonance (higher resonance at higher frequency)
+                float res = 2.0f + (envelope * sensitivity * 4.0f);
 
-            // Update cascaded filters
-            for (int ch = 0; ch < juce::jmin(2, (int)numChannels); ++ch)
-            {
-                filterStage1[ch].setCutoffFrequency(cutoff);
-                filterStage2[ch].setCutoffFrequency(cutoff);
-                filterStage1[ch].setResonance(res);
-                filterStage2[ch].setResonance(res);
+                gRamp.rampTo((float) std::tan(juce::MathConstants<double>::pi * cutoff / sampleRate));
+                r2Ramp.rampTo(1.0f / res);
             }
 
+            // Topology-preserving state variable bandpass, shared by both stages
+            const float g = gRamp.next();
+            const float r2 = r2Ramp.next();
+            const float h = 1.0f / (1.0f + r2 * g + g * g);
+
             // Process samples with saturation
             for (int ch = 0; ch < numChannels; ++ch)
             {
                 float in = buffer.getSample(ch, i);
                 
                 // Cascade for steeper slope (24dB style)
-                float s1 = filterStage1[ch % 2].processSample(ch % 2, in);
-                float s2 = filterStage2[ch % 2].processSample(ch % 2, s1);
+                float s1 = filterStages[0][ch % 2].bandpass(in, g, r2, h);
+                float s2 = filterStages[1][ch % 2].bandpass(s1, g, r2, h);
                 
                 // Add internal saturation to make it "kental"
                 float saturated = std::tanh(s2 * 2.5f);
@@ -85,14 +105,28 @@ public:
     }
 
 private:
+    struct SvfState
+    {
+        float s1 = 0.0f, s2 = 0.0f;
+
+        float bandpass(float x, float g, float r2, float h)
+        {
+            const float hp = h * (x - s1 * (g + r2) - s2);
+            const float bp = hp * g + s1;
+            s1 = hp * g + bp;
+            const float lp = bp * g + s2;
+            s2 = bp * g + lp;
+            return bp;
+        }
+    };
+
     double sampleRate = 44100.0;
     float sensitivity = 0.5f;
     float baseFreq = 400.0f;
-    float attackCoeff = 0.99f;
-    float releaseCoeff = 0.999f;
-    float envelope = 0.0f;
+    LevelDetector sidechain;
+    EnvelopeFollower follower;
 
-    // Use cascaded SVF filters for steeper (kental) response
-    juce::dsp::StateVariableTPTFilter<float> filterStage1[2];
-    juce::dsp::StateVariableTPTFilter<float> filterStage2[2];
+    // Use cascaded SVF filters for steeper (kental) response: [stage][channel]
+    SvfState filterStages[2][2];
+    ControlRamp gRamp, r2Ramp; // Cutoff as tan(pi fc / fs), and 1 / resonance
 };
@@ -0,0 +1,175 @@
+#pragma once
+#include <JuceHeader.h>
+
+/**
+ * Biquad - Allocation-free RBJ biquad with shared coefficients and
+ * per-channel transposed direct form II state.
+ *
+ * Coefficients are designed in place (no ref-counted Coefficients::Ptr) and
+ * only recomputed when the design inputs actually change, so it is safe to
+ * retune from the audio thread on every block. Gain factors are linear
+ * amplitude, matching juce::dsp::IIR::Coefficients::make*, so a module can
+ * switch over without changing its curves.
+ */
+class Biquad
+{
+public:
+    enum class Type { lowPass, highPass, bandPass, lowShelf, highShelf, peak };
+
+    struct Coefficients { float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f; };
+
+    static constexpr int maxChannels = 2;
+    static constexpr float defaultQ = 0.70710678f;
+
+    Biquad() = default;
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        designed = false; // Force a redesign at the new rate
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& s : state)
+            s = {};
+    }
+
+    /** Starts channel to from channel from's filter memory. */
+    void copyChannelState(int from, int to) { state[to] = state[from]; }
+
+    void setLowPass(float freq, float q = defaultQ)     { setDesign(Type::lowPass, freq, q, 1.0f); }
+    void setHighPass(float freq, float q = defaultQ)    { setDesign(Type::highPass, freq, q, 1.0f); }
+    void setBandPass(float freq, float q = defaultQ)    { setDesign(Type::bandPass, freq, q, 1.0f); }
+    void setLowShelf(float freq, float q, float gain)   { setDesign(Type::lowShelf, freq, q, gain); }
+    void setHighShelf(float freq, float q, float gain)  { setDesign(Type::highShelf, freq, q, gain); }
+    void setPeak(float freq, float q, float gain)       { setDesign(Type::peak, freq, q, gain); }
+
+    /** Redesigns only if type, frequency, Q or gain differ from the last call. */
+    void setDesign(Type newType, float freq, float q, float gain)
+    {
+        if (designed && newType == type && freq == frequency && q == quality && gain == gainFactor)
+            return;
+
+        type = newType;
+        frequency = freq;
+        quality = q;
+        gainFactor = gain;
+        designed = true;
+
+        coeffs = design(type, sampleRate, freq, q, gain);
+    }
+
+    const Coefficients& getCoefficients() const { return coeffs; }
+
+    /** Designs RBJ cookbook coefficients, normalised by a0. */
+    static Coefficients design(Type type, double sampleRate, float freq, float q, float gain)
+    {
+        const double f = juce::jlimit(1.0, sampleRate * 0.49, (double) freq);
+        const double w0 = juce::MathConstants<double>::twoPi * f / sampleRate;
+        const double cosW = std::cos(w0);
+        const double alpha = std::sin(w0) / (2.0 * juce::jmax(0.01, (double) q));
+        const double A = std::sqrt(juce::jmax(0.0, (double) gain));
+
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a0 = 1.0, a1 = 0.0, a2 = 0.0;
+
+        switch (type)
+        {
+            case Type::lowPass:
+                b0 = (1.0 - cosW) * 0.5; b1 = 1.0 - cosW; b2 = b0;
+                a0 = 1.0 + alpha; a1 = -2.0 * cosW; a2 = 1.0 - alpha;
+                break;
+
+            case Type::highPass:
+                b0 = (1.0 + cosW) * 0.5; b1 = -(1.0 + cosW); b2 = b0;
+                a0 = 1.0 + alpha; a1 = -2.0 * cosW; a2 = 1.0 - alpha;
+                break;
+
+            case Type::bandPass: // Constant 0 dB peak gain
+                b0 = alpha; b1 = 0.0; b2 = -alpha;
+                a0 = 1.0 + alpha; a1 = -2.0 * cosW; a2 = 1.0 - alpha;
+                break;
+
+            case Type::lowShelf:
+            {
+                const double beta = 2.0 * std::sqrt(A) * alpha;
+                b0 = A * ((A + 1.0) - (A - 1.0) * cosW + beta);
+                b1 = 2.0 * A * ((A - 1.0) - (A + 1.0) * cosW);
+                b2 = A * ((A + 1.0) - (A - 1.0) * cosW - beta);
+                a0 = (A + 1.0) + (A - 1.0) * cosW + beta;
+                a1 = -2.0 * ((A - 1.0) + (A + 1.0) * cosW);
+                a2 = (A + 1.0) + (A - 1.0) * cosW - beta;
+                break;
+            }
+
+            case Type::highShelf:
+            {
+                const double beta = 2.0 * std::sqrt(A) * alpha;
+                b0 = A * ((A + 1.0) + (A - 1.0) * cosW + beta);
+                b1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cosW);
+                b2 = A * ((A + 1.0) + (A - 1.0) * cosW - beta);
+                a0 = (A + 1.0) - (A - 1.0) * cosW + beta;
+                a1 = 2.0 * ((A - 1.0) - (A + 1.0) * cosW);
+                a2 = (A + 1.0) - (A - 1.0) * cosW - beta;
+                break;
+            }
+
+            case Type::peak:
+                b0 = 1.0 + alpha * A; b1 = -2.0 * cosW; b2 = 1.0 - alpha * A;
+                a0 = 1.0 + alpha / A; a1 = -2.0 * cosW; a2 = 1.0 - alpha / A;
+                break;
+        }
+
+        const double inv = 1.0 / a0;
+        return { (float) (b0 * inv), (float) (b1 * inv), (float) (b2 * inv),
+                 (float) (a1 * inv), (float) (a2 * inv) };
+    }
+
+    float processSample(int channel, float x)
+    {
+        auto& s = state[channel];
+        const float y = coeffs.b0 * x + s.z1;
+        s.z1 = coeffs.b1 * x - coeffs.a1 * y + s.z2;
+        s.z2 = coeffs.b2 * x - coeffs.a2 * y;
+        return y;
+    }
+
+    void process(float* data, int numSamples, int channel)
+    {
+        const auto c = coeffs;
+        auto z1 = state[channel].z1;
+        auto z2 = state[channel].z2;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float x = data[i];
+            const float y = c.b0 * x + z1;
+            z1 = c.b1 * x - c.a1 * y + z2;
+            z2 = c.b2 * x - c.a2 * y;
+            data[i] = y;
+        }
+
+        state[channel].z1 = z1;
+        state[channel].z2 = z2;
+    }
+
+    void process(juce::AudioBuffer<float>& buffer)
+    {
+        const int numChannels = juce::jmin(buffer.getNumChannels(), maxChannels);
+        for (int ch = 0; ch < numChannels; ++ch)
+            process(buffer.getWritePointer(ch), buffer.getNumSamples(), ch);
+    }
+
+private:
+    struct State { float z1 = 0.0f, z2 = 0.0f; };
+
+    double sampleRate = 44100.0;
+    Coefficients coeffs;
+    State state[maxChannels];
+
+    // Last design inputs, for change detection
+    Type type = Type::lowPass;
+    float frequency = 0.0f, quality = 0.0f, gainFactor = 0.0f;
+    bool designed = false;
+};
@@ -1,39 +1,167 @@
 #pragma once
 #include <JuceHeader.h>
+#include "Biquad.h"
+#include "PartitionedConvolver.h"
+#include "FilterCascade.h"
 
-class CabinetSim
+/**
+ * CabinetSim - Built-in cabinets are filter models; "Custom IR" (model 4)
+ * runs a PartitionedConvolver. IR decoding, resampling and partition FFTs
+ * happen on a loader thread, and the new engine is handed to the audio
+ * thread through an atomic pointer and crossfaded in.
+ */
+class CabinetSim : private juce::Thread
 {
 public:
-    CabinetSim() = default;
+    CabinetSim() : juce::Thread("Cabinet IR Loader") {}
+
+    ~CabinetSim() override
+    {
+        release();
+        delete pendingEngine.exchange(nullptr);
+        delete retiredEngine.exchange(nullptr);
+        delete activeEngine;
+        delete fadingEngine;
+    }
 
     void prepare(const juce::dsp::ProcessSpec& spec)
     {
+        release();
+
         sampleRate = spec.sampleRate;
         maxBlockSize = spec.maximumBlockSize;
         numChannels = spec.numChannels;
 
         // Initialize built-in cabinet simulation filters
         for (auto& f : cabFilters)
-            f.reset();
+            f.prepare(sampleRate);
 
         updateCabinetFilters();
+
+        fadeBuffer.setSize(PartitionedConvolver::maxChannels, (int) maxBlockSize);
+        fadeLength = static_cast<int>(sampleRate * 0.05); // 50 ms crossfade
+        fadeRemaining = 0;
+
+        // Audio is stopped here, so engines built for the old rate can go directly
+        delete pendingEngine.exchange(nullptr);
+        delete retiredEngine.exchange(nullptr);
+        delete activeEngine;
+        delete fadingEngine;
+        activeEngine = fadingEngine = nullptr;
+
+        {
+            const juce::ScopedLock sl(requestLock);
+            loaderSampleRate = sampleRate;
+            requestPending = customIRFile.existsAsFile();
+        }
+
+        startThread(juce::Thread::Priority::low);
+    }
+
+    void release()
+    {
+        stopThread(4000);
+    }
+
+    void setModel(int m)
+    {
+        if (model != m)
+        {
+            // Don't replay a stale tail when switching back to the IR
+            if (m == 4 && activeEngine != nullptr)
+                activeEngine->reset();
+
+            model = m;
+            updateCabinetFilters();
+        }
     }
 
-    void setModel(int m) { if (model != m) { model = m; updateCabinetFilters(); } }
     void setMicPosition(int p) { if (micPos != p) { micPos = p; updateCabinetFilters(); } }
 
+    struct Parameters
+    {
+        int model = 0;
+        int micPosition = 0;
+    };
+
+    void setParameters(const Parameters& p)
+    {
+        setModel(p.model);
+        setMicPosition(p.micPosition);
+    }
+
+    /** Message thread: queues an IR file for the loader thread. */
     void loadIR(const juce::File& irFile)
     {
-        if (irFile.existsAsFile())
+        if (! irFile.existsAsFile())
+            return;
+
         {
+            const juce::ScopedLock sl(requestLock);
             customIRFile = irFile;
-            hasCustomIR = true;
+            requestPending = true;
         }
+
+        notify();
+    }
+
+    juce::File getIRFile() const
+    {
+        const juce::ScopedLock sl(requestLock);
+        return customIRFile;
+    }
+
+    /** Audio thread: adopts any newly loaded IR and reports whether L/R will differ. */
+    bool isStereo()
+    {
+        takePendingEngine();
+        return model == 4
+            && ((activeEngine != nullptr && activeEngine->getNumIRChannels() > 1)
+                || (fadingEngine != nullptr && fadingEngine->getNumIRChannels() > 1));
+    }
+
+    static constexpr int numFilters = 3;
+
+    /**
+     * Audio thread: in filter mode, hands the cab filters and mic gain to a
+     * fused cascade instead of processing them. Returns false in IR mode,
+     * where process() still has to run.
+     */
+    bool appendFilters(FilterCascade& cascade)
+    {
+        takePendingEngine();
+
+        if (model == 4 && activeEngine != nullptr)
+            return false;
+
+        for (auto& f : cabFilters)
+            cascade.add(f);
+
+        cascade.addGain(getMicGain());
+        fadeRemaining = 0; // Nothing audible to fade between
+        return true;
+    }
+
+    /**
+     * Audio thread: starts channel to from channel from's filter and
+     * convolution state. In filter mode the fused cascade holds the state.
+     */
+    void copyChannelState(int from, int to)
+    {
+        for (auto& f : cabFilters)
+            f.copyChannelState(from, to);
+
+        if (activeEngine != nullptr)
+            activeEngine->copyChannelState(from, to);
+        if (fadingEngine != nullptr)
+            fadingEngine->copyChannelState(from, to);
     }
 
     void process(juce::AudioBuffer<float>& buffer)
     {
-        if (model == 4 && hasCustomIR)
+        takePendingEngine();
+
+        if (model == 4 && activeEngine != nullptr)
         {
             // Custom IR mode - use convolution
             processConvolution(buffer);
@@ -42,6 +170,7 @@ public:
         {
             // Built-in cabinet emulation using filters
             processFilters(buffer);
+            fadeRemaining = 0; // Nothing audible to fade between
         }
     }
 
@@ -51,57 +180,186 @@ private:
         int numSamps = buffer.getNumSamples();
         int numCh = buffer.getNumChannels();
 
-        auto block = juce::dsp::AudioBlock<float>(buffer);
-
-        for (int ch = 0; ch < numCh; ++ch)
+        for (int ch = 0; ch < juce::jmin(numCh, Biquad::maxChannels); ++ch)
         {
-            auto singleBlock = block.getSingleChannelBlock(ch);
-            auto ctx = juce::dsp::ProcessContextReplacing<float>(singleBlock);
-
-            cabFilters[ch * 3 + 0].process(ctx); // Low cut
-            cabFilters[ch * 3 + 1].process(ctx); // High cut (speaker rolloff)
-            cabFilters[ch * 3 + 2].process(ctx); // Resonance peak
+            auto* data = buffer.getWritePointer(ch);
+            cabFilters[0].process(data, numSamps, ch); // Low cut
+            cabFilters[1].process(data, numSamps, ch); // High cut (speaker rolloff)
+            cabFilters[2].process(data, numSamps, ch); // Resonance peak
         }
 
         // Mic position coloring
-        applyMicPosition(buffer);
+        buffer.applyGain(getMicGain());
     }
 
     void processConvolution(juce::AudioBuffer<float>& buffer)
     {
-        // For custom IR, we apply a simple filter chain as placeholder
-        // Full convolution requires loading the IR file
-        processFilters(buffer);
+        const int numSamps = buffer.getNumSamples();
+        const int numCh = juce::jmin(buffer.getNumChannels(), fadeBuffer.getNumChannels());
+        const bool fading = fadeRemaining > 0 && numSamps <= fadeBuffer.getNumSamples();
+
+        // Outgoing path (previous IR, or the filter cab for the first load)
+        juce::AudioBuffer<float> oldPath(fadeBuffer.getArrayOfWritePointers(), numCh, numSamps);
+        if (fading)
+        {
+            for (int ch = 0; ch < numCh; ++ch)
+                oldPath.copyFrom(ch, 0, buffer, ch, 0, numSamps);
+
+            if (fadingEngine != nullptr)
+                fadingEngine->process(oldPath);
+            else
+                processFilters(oldPath);
+        }
+
+        activeEngine->process(buffer);
+
+        if (fading)
+        {
+            // Linear crossfade: both paths carry the same, correlated input
+            const float step = 1.0f / (float) fadeLength;
+            for (int ch = 0; ch < numCh; ++ch)
+            {
+                auto* data = buffer.getWritePointer(ch);
+                const auto* old = oldPath.getReadPointer(ch);
+                int remaining = fadeRemaining;
+
+                for (int s = 0; s < numSamps; ++s)
+                {
+                    const float gain = remaining > 0 ? 1.0f - (float) remaining * step : 1.0f;
+                    data[s] = data[s] * gain + old[s] * (1.0f - gain);
+                    if (remaining > 0) --remaining;
+                }
+            }
+
+            fadeRemaining = juce::jmax(0, fadeRemaining - numSamps);
+        }
+        else
+        {
+            fadeRemaining = 0;
+        }
+    }
+
+    /** Audio thread: adopts a freshly built engine and returns a faded-out one for deletion. */
+    void takePendingEngine()
+    {
+        if (fadingEngine != nullptr && fadeRemaining == 0)
+        {
+            PartitionedConvolver* expected = nullptr;
+            if (retiredEngine.compare_exchange_strong(expected, fadingEngine))
+                fadingEngine = nullptr;
+        }
+
+        if (fadingEngine != nullptr)
+            return; // Finish the current fade first
+
+        if (auto* next = pendingEngine.exchange(nullptr))
+        {
+            fadingEngine = activeEngine;
+            activeEngine = next;
+            fadeRemaining = fadeLength;
+        }
     }
 
-    void applyMicPosition(juce::AudioBuffer<float>& buffer)
+    //==============================================================================
+    void run() override
     {
-        int numSamps = buffer.getNumSamples();
-        int numCh = buffer.getNumChannels();
+        while (! threadShouldExit())
+        {
+            delete retiredEngine.exchange(nullptr);
+
+            juce::File file;
+            double rate = 0.0;
+            bool pending = false;
+
+            {
+                const juce::ScopedLock sl(requestLock);
+                std::swap(pending, requestPending);
+                file = customIRFile;
+                rate = loaderSampleRate;
+            }
+
+            if (pending)
+                if (auto engine = buildEngine(file, rate))
+                    delete pendingEngine.exchange(engine.release()); // Drop any unclaimed build
+
+            wait(250);
+        }
+    }
 
-        for (int ch = 0; ch < numCh; ++ch)
+    static std::unique_ptr<PartitionedConvolver> buildEngine(const juce::File& file, double hostRate)
+    {
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+        if (reader == nullptr || reader->lengthInSamples <= 0 || hostRate <= 0.0)
+            return nullptr;
+
+        const int irChannels = juce::jlimit(1, PartitionedConvolver::maxChannels, (int) reader->numChannels);
+        const int length = (int) juce::jmin(reader->lengthInSamples, (juce::int64) (reader->sampleRate * maxIRSeconds));
+
+        // A few zeros of padding keep the interpolator's look-ahead in range
+        juce::AudioBuffer<float> raw(irChannels, length + 8);
+        raw.clear();
+        reader->read(&raw, 0, length, 0, true, irChannels > 1);
+
+        juce::AudioBuffer<float> ir;
+        const double ratio = reader->sampleRate / hostRate;
+
+        if (std::abs(ratio - 1.0) < 1.0e-6)
         {
-            auto* data = buffer.getWritePointer(ch);
-            for (int s = 0; s < numSamps; ++s)
+            ir.setSize(irChannels, length);
+            for (int ch = 0; ch < irChannels; ++ch)
+                ir.copyFrom(ch, 0, raw, ch, 0, length);
+        }
+        else
+        {
+            const int outLength = juce::jmax(1, (int) std::ceil(length / ratio));
+            ir.setSize(irChannels, outLength);
+
+            for (int ch = 0; ch < irChannels; ++ch)
             {
-                float sample = data[s];
-                switch (micPos)
+                // Band-limit before decimating to the host rate
+                if (ratio > 1.0)
                 {
-                    case 0: // On-Axis - bright, direct
-                        break;
-                    case 1: // Off-Axis - smoother, less bright
-                        sample *= 0.9f;
-                        break;
-                    case 2: // Edge - darker, more bass
-                        sample *= 0.85f;
-                        break;
-                    case 3: // Room - ambient, wider
-                        sample *= 0.75f;
-                        break;
+                    Biquad aa[2];
+                    for (auto& f : aa)
+                    {
+                        f.prepare(reader->sampleRate);
+                        f.setLowPass((float) (hostRate * 0.45));
+                        f.process(raw.getWritePointer(ch), length, 0);
+                    }
                 }
-                data[s] = sample;
+
+                juce::LagrangeInterpolator interpolator;
+                interpolator.process(ratio, raw.getReadPointer(ch), ir.getWritePointer(ch), outLength);
             }
         }
+
+        // Normalise to unit energy so IRs from different sources sit at similar levels
+        double energy = 0.0;
+        for (int ch = 0; ch < irChannels; ++ch)
+            for (int i = 0; i < ir.getNumSamples(); ++i)
+                energy += (double) ir.getSample(ch, i) * ir.getSample(ch, i);
+
+        energy /= irChannels;
+        if (energy <= 1.0e-12)
+            return nullptr;
+
+        ir.applyGain((float) (1.0 / std::sqrt(energy)));
+
+        return std::make_unique<PartitionedConvolver>(ir);
+    }
+
+    float getMicGain() const
+    {
+        switch (micPos)
+        {
+            case 1: return 0.9f;  // Off-Axis - smoother, less bright
+            case 2: return 0.85f; // Edge - darker, more bass
+            case 3: return 0.75f; // Room - ambient, wider
+            default: return 1.0f; // On-Axis - bright, direct
+        }
     }
 
     void updateCabinetFilters()
@@ -136,15 +394,9 @@ private:
             default: break;
         }
 
-        for (int ch = 0; ch < 2; ++ch)
-        {
-            cabFilters[ch * 3 + 0].coefficients =
-                juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, lowCut, 0.707f);
-            cabFilters[ch * 3 + 1].coefficients =
-                juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, highCut, 0.707f);
-            cabFilters[ch * 3 + 2].coefficients =
-                juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, resFreq, resQ, 1.5f);
-        }
+        cabFilters[0].setHighPass(lowCut, 0.707f);
+        cabFilters[1].setLowPass(highCut, 0.707f);
+        cabFilters[2].setPeak(resFreq, resQ, 1.5f);
     }
 
     double sampleRate = 44100.0;
@@ -152,9 +404,26 @@ private:
     juce::uint32 numChannels = 2;
     int model = 0;
     int micPos = 0;
-    bool hasCustomIR = false;
+
+    static constexpr double maxIRSeconds = 1.0;
+
+    // Message thread <-> loader thread
+    juce::CriticalSection requestLock;
     juce::File customIRFile;
+    double loaderSampleRate = 44100.0;
+    bool requestPending = false;
+
+    // Loader -> audio (new engine) and audio -> loader (engine to delete)
+    std::atomic<PartitionedConvolver*> pendingEngine { nullptr };
+    std::atomic<PartitionedConvolver*> retiredEngine { nullptr };
+
+    // Audio-thread owned
+    PartitionedConvolver* activeEngine = nullptr;
+    PartitionedConvolver* fadingEngine = nullptr;
+    juce::AudioBuffer<float> fadeBuffer;
+    int fadeLength = 2205;
+    int fadeRemaining = 0;
 
-    // 6 filters: 2 channels x 3 filters (lowcut, highcut, resonance)
-    juce::dsp::IIR::Filter<float> cabFilters[6];
+    // 3 filters (lowcut, highcut, resonance), each with stereo state
+    Biquad cabFilters[3];
 };
@@ -1,5 +1,7 @@
 #pragma once
 #include <JuceHeader.h>
+#include "DelayLine.h"
+#include "ControlRate.h"
 
 class Chorus
 {
@@ -10,77 +12,90 @@ public:
     {
         sampleRate = spec.sampleRate;
         int maxDelay = static_cast<int>(sampleRate * 0.05); // 50ms max
-        delayBufL.resize(maxDelay, 0.0f);
-        delayBufR.resize(maxDelay, 0.0f);
-        writePos = 0;
-        lfoPhase = 0.0f;
+        delayLine.prepare(2, maxDelay, chunkSize);
+        lfo.prepare(sampleRate);
+        for (auto& ramp : delayRamps)
+            ramp.reset();
     }
 
-    void setRate(float r) { rate = r; }
+    void setRate(float r) { rate = r; lfo.setRate(rate); }
     void setDepth(float d) { depth = d; }
     void setMix(float m) { mix = m; }
 
-    void process(juce::AudioBuffer<float>& buffer)
+    struct Parameters
     {
-        int numSamples = buffer.getNumSamples();
-        int numChannels = buffer.getNumChannels();
-        int maxDelay = (int)delayBufL.size();
+        float rate = 1.0f, depth = 0.5f, mix = 0.5f;
+    };
 
-        float baseDelay = 7.0f; // 7ms base delay
-        float maxModDelay = depth * 5.0f; // up to 5ms modulation
+    void setParameters(const Parameters& p)
+    {
+        setRate(p.rate);
+        setDepth(p.depth);
+        setMix(p.mix);
+    }
 
-        for (int s = 0; s < numSamples; ++s)
-        {
-            // LFO
-            float lfoL = std::sin(lfoPhase);
-            float lfoR = std::sin(lfoPhase + juce::MathConstants<float>::pi * 0.5f); // 90° offset for stereo
+    /** No feedback: the tail is just the longest tap, bounded by the line. */
+    static double getTailSeconds(const Parameters&, double) { return 0.05; }
+
+    void process(juce::AudioBuffer<float>& buffer)
+    {
+        const int numSamples = buffer.getNumSamples();
+        const int numChannels = juce::jmin(buffer.getNumChannels(), DelayLine::maxChannels);
+
+        // No feedback, so whole chunks go in before the modulated taps read out
+        for (int start = 0; start < numSamples; start += chunkSize)
+            processChunk(buffer, numChannels, start, juce::jmin(chunkSize, numSamples - start));
+    }
 
-            lfoPhase += 2.0f * juce::MathConstants<float>::pi * rate / (float)sampleRate;
-            if (lfoPhase > 2.0f * juce::MathConstants<float>::pi)
-                lfoPhase -= 2.0f * juce::MathConstants<float>::pi;
+private:
+    static constexpr int chunkSize = 256;
 
-            // Calculate delay in samples
-            float delayMsL = baseDelay + lfoL * maxModDelay;
-            float delayMsR = baseDelay + lfoR * maxModDelay;
-            float delaySamplesL = (delayMsL / 1000.0f) * (float)sampleRate;
-            float delaySamplesR = (delayMsR / 1000.0f) * (float)sampleRate;
+    void processChunk(juce::AudioBuffer<float>& buffer, int numChannels, int start, int numSamples)
+    {
+        int maxDelay = delayLine.getMaxDelay();
 
-            delaySamplesL = juce::jlimit(1.0f, (float)(maxDelay - 2), delaySamplesL);
-            delaySamplesR = juce::jlimit(1.0f, (float)(maxDelay - 2), delaySamplesR);
+        float baseDelay = 7.0f; // 7ms base delay
+        float maxModDelay = depth * 5.0f; // up to 5ms modulation
 
-            // Read with interpolation
-            float wetL = readInterp(delayBufL, writePos, delaySamplesL, maxDelay);
-            float wetR = (numChannels > 1) ? readInterp(delayBufR, writePos, delaySamplesR, maxDelay) : wetL;
+        float delays[DelayLine::maxChannels][chunkSize], wet[chunkSize];
 
-            // Write input to buffer
-            float dryL = buffer.getSample(0, s);
-            float dryR = (numChannels > 1) ? buffer.getSample(1, s) : dryL;
+        auto toSamples = [&](float lfoValue)
+        {
+            float delayMs = baseDelay + lfoValue * maxModDelay;
+            return juce::jlimit(1.0f, (float)(maxDelay - 2), (delayMs / 1000.0f) * (float)sampleRate);
+        };
 
-            delayBufL[writePos] = dryL;
-            delayBufR[writePos] = dryR;
+        for (int s = 0; s < numSamples; ++s)
+        {
+            // LFO at control rate, delays interpolated in between
+            if (delayRamps[0].isDue())
+            {
+                lfo.advance();
+                delayRamps[0].rampTo(toSamples(lfo.sine()));
+                delayRamps[1].rampTo(toSamples(lfo.sine(juce::MathConstants<float>::pi * 0.5f))); // 90° offset for stereo
+            }
+
+            delays[0][s] = delayRamps[0].next();
+            delays[1][s] = delayRamps[1].next();
+        }
 
-            // Mix
-            buffer.setSample(0, s, dryL * (1.0f - mix) + wetL * mix);
-            if (numChannels > 1)
-                buffer.setSample(1, s, dryR * (1.0f - mix) + wetR * mix);
+        // Every tap is at least one sample back, so it never sees its own input
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* data = buffer.getWritePointer(ch, start);
+            delayLine.writeBlock(ch, data, numSamples);
+            delayLine.readBlockLinear(ch, wet, delays[ch], numSamples);
 
-            writePos = (writePos + 1) % maxDelay;
+            for (int s = 0; s < numSamples; ++s)
+                data[s] = data[s] * (1.0f - mix) + wet[s] * mix;
         }
-    }
 
-private:
-    float readInterp(const std::vector<float>& buf, int wp, float delay, int maxSize)
-    {
-        int readIdx = (int)delay;
-        float frac = delay - (float)readIdx;
-        int p1 = (wp - readIdx + maxSize) % maxSize;
-        int p2 = (p1 - 1 + maxSize) % maxSize;
-        return buf[p1] * (1.0f - frac) + buf[p2] * frac;
+        delayLine.advance(numSamples);
     }
 
     double sampleRate = 44100.0;
     float rate = 1.0f, depth = 0.5f, mix = 0.5f;
-    float lfoPhase = 0.0f;
-    std::vector<float> delayBufL, delayBufR;
-    int writePos = 0;
+    ControlLfo lfo;
+    ControlRamp delayRamps[2];
+    DelayLine delayLine;
 };
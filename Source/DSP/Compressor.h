@@ -1,5 +1,6 @@
 #pragma once
 #include <JuceHeader.h>
+#include "LevelDetector.h"
 
 class Compressor
 {
@@ -9,66 +10,53 @@ public:
     void prepare(const juce::dsp::ProcessSpec& spec)
     {
         sampleRate = spec.sampleRate;
-        envelope = 0.0f;
+        follower.reset();
+        updateCoefficients();
     }
 
-    void setModel(int m) { model = m; }
+    void setModel(int m) { model = m; updateCoefficients(); }
     void setThreshold(float t) { threshold = t; }
     void setRatio(float r) { ratio = r; }
-    void setAttack(float a) { attack = a; }
-    void setRelease(float r) { release = r; }
+    void setAttack(float a) { attack = a; updateCoefficients(); }
+    void setRelease(float r) { release = r; updateCoefficients(); }
     void setMakeup(float m) { makeup = m; }
 
-    void process(juce::AudioBuffer<float>& buffer)
+    struct Parameters
+    {
+        int model = 0;
+        float threshold = -20.0f;
+        float ratio = 4.0f;
+        float attack = 10.0f;   // ms
+        float release = 100.0f; // ms
+        float makeup = 0.0f;    // dB
+    };
+
+    void setParameters(const Parameters& p)
+    {
+        model = p.model;
+        threshold = p.threshold;
+        ratio = p.ratio;
+        attack = p.attack;
+        release = p.release;
+        makeup = p.makeup;
+        updateCoefficients();
+    }
+
+    /** sidechain must have analysed buffer as it is now. */
+    void process(juce::AudioBuffer<float>& buffer, const LevelDetector& sidechain)
     {
-        float attackCoeff = std::exp(-1.0f / (sampleRate * attack * 0.001f));
-        float releaseCoeff = std::exp(-1.0f / (sampleRate * release * 0.001f));
         float makeupGainDb = makeup;
 
         int numSamples = buffer.getNumSamples();
         int numChannels = buffer.getNumChannels();
+        const float* level = sidechain.getRectified();
+        jassert(sidechain.getNumSamples() == numSamples);
+        maxGainReductionDb = 0.0f;
 
         for (int s = 0; s < numSamples; ++s)
         {
-            // Detect peak across channels in linear scale
-            float inputLevel = 0.0f;
-            for (int ch = 0; ch < numChannels; ++ch)
-                inputLevel = std::max(inputLevel, std::abs(buffer.getSample(ch, s)));
-
-            // Envelope follower with model-specific behavior (Linear domain)
-            float targetLin = inputLevel;
-
-            switch (model)
-            {
-                case 0: // VCA - fast, precise
-                    if (targetLin > envelope)
-                        envelope = attackCoeff * envelope + (1.0f - attackCoeff) * targetLin;
-                    else
-                        envelope = releaseCoeff * envelope + (1.0f - releaseCoeff) * targetLin;
-                    break;
-
-                case 1: // Optical - slow, smooth
-                {
-                    float optAttack = std::exp(-1.0f / (sampleRate * attack * 0.003f));
-                    float optRelease = std::exp(-1.0f / (sampleRate * release * 0.005f));
-                    if (targetLin > envelope)
-                        envelope = optAttack * envelope + (1.0f - optAttack) * targetLin;
-                    else
-                        envelope = optRelease * envelope + (1.0f - optRelease) * targetLin;
-                    break;
-                }
-
-                case 2: // FET - aggressive, punchy
-                {
-                    float fetAttack = std::exp(-1.0f / (sampleRate * attack * 0.0005f));
-                    float fetRelease = std::exp(-1.0f / (sampleRate * release * 0.002f));
-                    if (targetLin > envelope)
-                        envelope = fetAttack * envelope + (1.0f - fetAttack) * targetLin;
-                    else
-                        envelope = fetRelease * envelope + (1.0f - fetRelease) * targetLin;
-                    break;
-                }
-            }
+            // Envelope follower (Linear domain) on the shared peak detector
+            float envelope = follower.process(level[s]);
 
             // Convert enveloped linear value to dB
             float envelopeDb = juce::Decibels::gainToDecibels(envelope + 1e-6f);
@@ -92,6 +80,8 @@ public:
                 gainReductionDb = (1.0f - 1.0f / ratio) * (excess * excess) / (2.0f * kneeWidth);
             }
 
+            maxGainReductionDb = std::max(maxGainReductionDb, gainReductionDb);
+
             // Convert to linear gain multiplier
             float gainDb = makeupGainDb - gainReductionDb;
             float gain = juce::Decibels::decibelsToGain(gainDb);
@@ -102,7 +92,23 @@ public:
         }
     }
 
+    /** Deepest gain reduction during the last process() call, for metering. */
+    float getGainReductionDb() const { return maxGainReductionDb; }
+
 private:
+    // Detector coefficients, worked out when the settings change
+    void updateCoefficients()
+    {
+        // Models differ only in detector timing: VCA fast and precise,
+        // Optical slow and smooth, FET aggressive and punchy
+        static constexpr float attackScale[] = { 0.001f, 0.003f, 0.0005f };
+        static constexpr float releaseScale[] = { 0.001f, 0.005f, 0.002f };
+        const int m = model >= 0 && model < 3 ? model : 0;
+
+        follower.setCoefficients(EnvelopeFollower::getCoefficient(attack * attackScale[m], sampleRate),
+                                 EnvelopeFollower::getCoefficient(release * releaseScale[m], sampleRate));
+    }
+
     double sampleRate = 44100.0;
     int model = 0;
     float threshold = -20.0f;
@@ -110,5 +116,6 @@ private:
     float attack = 10.0f;   // ms
     float release = 100.0f; // ms
     float makeup = 0.0f;    // dB
-    float envelope = 0.0f;
+    EnvelopeFollower follower;
+    float maxGainReductionDb = 0.0f;
 };
@@ -0,0 +1,97 @@
+#pragma once
+#include <JuceHeader.h>
+#include <cmath>
+
+/**
+ * ControlRate - Modulation evaluated every ControlRamp::interval samples
+ * instead of every sample, for the LFO- and envelope-driven effects.
+ *
+ * A ControlLfo is a phase accumulator that is only read at control points.
+ * The module maps each reading to whatever it modulates (a delay time, an
+ * allpass or filter coefficient) and hands that to a ControlRamp, which
+ * glides to it linearly over the next interval. The transcendentals then
+ * run once per control point, and the per-sample loop only adds a step.
+ *
+ * Neither class cares about block boundaries: a ramp is due whenever its
+ * last segment ran out, so the control rate is the same at any block size.
+ */
+class ControlRamp
+{
+public:
+    static constexpr int interval = 16;
+
+    /** The next rampTo() jumps straight to its target. */
+    void reset()
+    {
+        remaining = 0;
+        step = 0.0f;
+        snap = true;
+    }
+
+    /** True once the last segment has been used up. */
+    bool isDue() const { return remaining == 0; }
+
+    /** Glides from the current value to target over the next interval samples. */
+    void rampTo(float target)
+    {
+        if (snap)
+        {
+            current = target;
+            snap = false;
+        }
+
+        step = (target - current) * (1.0f / (float) interval);
+        remaining = interval;
+    }
+
+    float next()
+    {
+        const float value = current;
+        current += step;
+        --remaining;
+        return value;
+    }
+
+private:
+    float current = 0.0f, step = 0.0f;
+    int remaining = 0;
+    bool snap = true;
+};
+
+class ControlLfo
+{
+public:
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        setRate(rate);
+        reset();
+    }
+
+    void reset(float startPhase = 0.0f) { phase = startPhase; }
+
+    void setRate(float hz)
+    {
+        rate = hz;
+        increment = juce::MathConstants<float>::twoPi * rate * (float) ControlRamp::interval / (float) sampleRate;
+    }
+
+    /** Moves on by one control interval. */
+    void advance()
+    {
+        phase += increment;
+        if (phase >= juce::MathConstants<float>::twoPi)
+            phase -= juce::MathConstants<float>::twoPi * std::floor(phase / juce::MathConstants<float>::twoPi);
+    }
+
+    /** -1 to 1, offset radians ahead of the accumulator. */
+    float sine(float offset = 0.0f) const { return std::sin(phase + offset); }
+
+    /** 0 to 1. */
+    float unipolar() const { return (std::sin(phase) + 1.0f) * 0.5f; }
+
+private:
+    double sampleRate = 44100.0;
+    float rate = 1.0f, increment = 0.0f;
+    float phase = 0.0f;
+};
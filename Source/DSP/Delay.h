@@ -1,5 +1,9 @@
 #pragma once
 #include <JuceHeader.h>
+#include "Biquad.h"
+#include "DelayLine.h"
+#include "TailSleeper.h"
+#include "ControlRate.h"
 
 class DelayEffect
 {
@@ -11,27 +15,97 @@ public:
         sampleRate = spec.sampleRate;
         maxDelaySamples = static_cast<int>(sampleRate * 2.5); // Max 2.5 sec
 
-        delayBufferL.resize(maxDelaySamples, 0.0f);
-        delayBufferR.resize(maxDelaySamples, 0.0f);
-        writePos = 0;
+        delayLine.prepare(2, maxDelaySamples, 1);
 
-        modPhase = 0.0f;
+        modLfo.setRate(0.5f);
+        modLfo.prepare(sampleRate);
+        modRamp.reset();
 
         // Analog warmth filter
-        lpFilter.reset();
-        lpFilter.coefficients = juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, 3500.0f);
+        lpFilter.prepare(sampleRate);
+        lpFilter.setLowPass(3500.0f);
     }
 
-    void setModel(int m) { model = m; }
+    /** Drops the repeats without reallocating (audio thread safe). */
+    void reset()
+    {
+        delayLine.reset();
+        modLfo.reset();
+        modRamp.reset();
+    }
+
+    void setModel(int m)
+    {
+        if (m != model)
+        {
+            model = m;
+            processFn = getProcessFn(m);
+        }
+    }
     void setTime(float ms) { delayTimeMs = ms; }
     void setFeedback(float fb) { feedback = fb; }
     void setMix(float m) { mix = m; }
     void setModulation(float mod) { modAmount = mod; }
 
+    // Only ping-pong makes the two channels differ
+    bool isStereo() const { return model == 3; }
+
+    struct Parameters
+    {
+        int model = 0;
+        float timeMs = 400.0f;
+        float feedback = 0.4f;
+        float mix = 0.3f;
+        float modulation = 0.0f;
+    };
+
+    void setParameters(const Parameters& p)
+    {
+        setModel(p.model);
+        setTime(p.timeMs);
+        setFeedback(p.feedback);
+        setMix(p.mix);
+        setModulation(p.modulation);
+    }
+
+    /** Time for the repeats to die away: small-signal loop gain per pass, times the delay. */
+    static double getTailSeconds(const Parameters& p, double sampleRate)
+    {
+        float slope = 1.0f;
+        if (p.model == 1) slope = 0.9f * 0.95f; // analogProcess
+        if (p.model == 2) slope = 1.1f * 0.9f;  // tapeProcess
+
+        const double pass = p.timeMs * 0.001 + p.modulation * 10.0 / sampleRate; // Longest modulated read
+        return (TailSleeper::getDecayRepeats(p.feedback * slope) + 1.0) * pass;
+    }
+
     void process(juce::AudioBuffer<float>& buffer)
+    {
+        (this->*processFn)(buffer);
+    }
+
+private:
+    // One sample loop per model, picked when the model changes
+    using ProcessFn = void (DelayEffect::*)(juce::AudioBuffer<float>&);
+
+    static ProcessFn getProcessFn(int m)
+    {
+        switch (m)
+        {
+            case 1: return &DelayEffect::processModel<1>;
+            case 2: return &DelayEffect::processModel<2>;
+            case 3: return &DelayEffect::processModel<3>;
+            default: return &DelayEffect::processModel<0>;
+        }
+    }
+
+    template <int Model>
+    void processModel(juce::AudioBuffer<float>& buffer)
     {
         int numSamples = buffer.getNumSamples();
         int numChannels = buffer.getNumChannels();
+        float* dataL = buffer.getWritePointer(0);
+        float* dataR = numChannels > 1 ? buffer.getWritePointer(1) : nullptr;
 
         float delaySamples = (delayTimeMs / 1000.0f) * (float)sampleRate;
 
@@ -41,10 +115,13 @@ public:
             float modOffset = 0.0f;
             if (modAmount > 0.0f)
             {
-                modOffset = std::sin(modPhase) * modAmount * 10.0f;
-                modPhase += 2.0f * juce::MathConstants<float>::pi * 0.5f / (float)sampleRate;
-                if (modPhase > 2.0f * juce::MathConstants<float>::pi)
-                    modPhase -= 2.0f * juce::MathConstants<float>::pi;
+                // 0.5 Hz, at control rate
+                if (modRamp.isDue())
+                {
+                    modLfo.advance();
+                    modRamp.rampTo(modLfo.sine() * modAmount * 10.0f);
+                }
+                modOffset = modRamp.next();
             }
 
             float readDelay = delaySamples + modOffset;
@@ -52,59 +129,41 @@ public:
             if (readDelay >= maxDelaySamples - 1) readDelay = (float)(maxDelaySamples - 2);
 
             // Read from delay buffer with linear interpolation
-            int readIdx = (int)readDelay;
-            float frac = readDelay - (float)readIdx;
-            int pos1 = (writePos - readIdx + maxDelaySamples) % maxDelaySamples;
-            int pos2 = (pos1 - 1 + maxDelaySamples) % maxDelaySamples;
-
-            float delayedL = delayBufferL[pos1] * (1.0f - frac) + delayBufferL[pos2] * frac;
-            float delayedR = (numChannels > 1) ?
-                delayBufferR[pos1] * (1.0f - frac) + delayBufferR[pos2] * frac : delayedL;
+            float delayedL = delayLine.readLinear(0, readDelay);
+            float delayedR = (dataR != nullptr) ? delayLine.readLinear(1, readDelay) : delayedL;
 
-            // Apply model-specific processing
-            switch (model)
+            // Apply model-specific processing (Digital: clean)
+            if constexpr (Model == 1) // Analog: warm, dark repeats
             {
-                case 1: // Analog: warm, dark repeats
-                    delayedL = analogProcess(delayedL);
-                    delayedR = analogProcess(delayedR);
-                    break;
-                case 2: // Tape: warble, saturation
-                    delayedL = tapeProcess(delayedL);
-                    delayedR = tapeProcess(delayedR);
-                    break;
-                case 3: // Ping-Pong
-                {
-                    float tempL = delayedL;
-                    delayedL = delayedR;
-                    delayedR = tempL;
-                    break;
-                }
-                default: // Digital: clean
-                    break;
+                delayedL = analogProcess(delayedL);
+                delayedR = analogProcess(delayedR);
+            }
+            else if constexpr (Model == 2) // Tape: warble, saturation
+            {
+                delayedL = tapeProcess(delayedL);
+                delayedR = tapeProcess(delayedR);
+            }
+            else if constexpr (Model == 3) // Ping-Pong
+            {
+                std::swap(delayedL, delayedR);
             }
 
             // Get input
-            float inputL = buffer.getSample(0, s);
-            float inputR = (numChannels > 1) ? buffer.getSample(1, s) : inputL;
-
-            // Write to delay buffer (input + feedback)
-            delayBufferL[writePos] = inputL + delayedL * feedback;
-            delayBufferR[writePos] = inputR + delayedR * feedback;
+            float inputL = dataL[s];
+            float inputR = (dataR != nullptr) ? dataR[s] : inputL;
 
-            // Clamp feedback to prevent runaway
-            delayBufferL[writePos] = juce::jlimit(-2.0f, 2.0f, delayBufferL[writePos]);
-            delayBufferR[writePos] = juce::jlimit(-2.0f, 2.0f, delayBufferR[writePos]);
+            // Write to delay buffer (input + feedback), clamped to prevent runaway
+            delayLine.write(0, juce::jlimit(-2.0f, 2.0f, inputL + delayedL * feedback));
+            delayLine.write(1, juce::jlimit(-2.0f, 2.0f, inputR + delayedR * feedback));
+            delayLine.advance();
 
             // Mix dry/wet
-            buffer.setSample(0, s, inputL * (1.0f - mix) + delayedL * mix);
-            if (numChannels > 1)
-                buffer.setSample(1, s, inputR * (1.0f - mix) + delayedR * mix);
-
-            writePos = (writePos + 1) % maxDelaySamples;
+            dataL[s] = inputL * (1.0f - mix) + delayedL * mix;
+            if (dataR != nullptr)
+                dataR[s] = inputR * (1.0f - mix) + delayedR * mix;
         }
     }
 
-private:
     float analogProcess(float x)
     {
         // Warm, slightly saturated
@@ -121,14 +180,15 @@ private:
     double sampleRate = 44100.0;
     int maxDelaySamples = 0;
     int model = 0;
+    ProcessFn processFn = &DelayEffect::processModel<0>;
     float delayTimeMs = 400.0f;
     float feedback = 0.4f;
     float mix = 0.3f;
     float modAmount = 0.0f;
-    float modPhase = 0.0f;
+    ControlLfo modLfo;
+    ControlRamp modRamp;
 
-    std::vector<float> delayBufferL, delayBufferR;
-    int writePos = 0;
+    DelayLine delayLine;
 
-    juce::dsp::IIR::Filter<float> lpFilter;
+    Biquad lpFilter;
 };
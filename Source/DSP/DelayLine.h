@@ -0,0 +1,179 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+
+/**
+ * DelayLine - Shared multi-channel delay line for the time-based effects.
+ *
+ * The ring is a power of two, so every wrap is a mask instead of a modulo,
+ * and the first maxBlockSize + guard samples are mirrored past the end. Any
+ * read that starts inside the ring can then run on for a whole block (or
+ * the few neighbours an interpolator needs) without wrapping.
+ *
+ * Delays are counted back from the write position: 0 is the sample written
+ * at the current position, 1 the one before it. Per-sample users read,
+ * write() and advance(); block users writeBlock() first, then read each
+ * output sample relative to its own position in the block, then advance().
+ * All storage is sized in prepare(); nothing else allocates.
+ */
+class DelayLine
+{
+public:
+    static constexpr int maxChannels = 2;
+    static constexpr int guard = 4; // Neighbours an interpolated read may touch
+
+    void prepare(int numChannels, int maxDelaySamples, int maxBlockSize)
+    {
+        channels = juce::jlimit(1, maxChannels, numChannels);
+        maxDelay = juce::jmax(1, maxDelaySamples);
+        maxBlock = juce::jmax(1, maxBlockSize);
+
+        size = juce::nextPowerOfTwo(maxDelay + maxBlock + guard);
+        mask = size - 1;
+        mirror = maxBlock + guard;
+        stride = size + mirror;
+
+        storage.assign((size_t) (stride * channels), 0.0f);
+        writePos = 0;
+    }
+
+    void reset()
+    {
+        std::fill(storage.begin(), storage.end(), 0.0f);
+        writePos = 0;
+    }
+
+    int getMaxDelay() const { return maxDelay; }
+    int getNumChannels() const { return channels; }
+
+    //==========================================================================
+    // Per sample
+
+    void write(int ch, float x)
+    {
+        float* d = channelData(ch);
+        d[writePos] = x;
+        if (writePos < mirror)
+            d[writePos + size] = x;
+    }
+
+    void advance(int numSamples = 1) { writePos = (writePos + numSamples) & mask; }
+
+    float read(int ch, int delay) const
+    {
+        return channelData(ch)[(writePos - delay) & mask];
+    }
+
+    /** Linear interpolation between the samples at floor(delay) and floor(delay) + 1. */
+    float readLinear(int ch, float delay) const
+    {
+        return linearAt(channelData(ch), writePos, delay);
+    }
+
+    /** Third-order Lagrange over delays floor(delay) - 1 .. floor(delay) + 2. */
+    float readLagrange(int ch, float delay) const
+    {
+        const int i = (int) delay;
+        const float f = delay - (float) i;
+        jassert(i >= 1);
+
+        const float* x = channelData(ch) + ((writePos - i - 2) & mask); // x[3] is the newest
+        const float fm1 = f - 1.0f, fm2 = f - 2.0f, fp1 = f + 1.0f;
+
+        return x[3] * (-f * fm1 * fm2 * (1.0f / 6.0f))
+             + x[2] * (fp1 * fm1 * fm2 * 0.5f)
+             + x[1] * (-fp1 * f * fm2 * 0.5f)
+             + x[0] * (fp1 * f * fm1 * (1.0f / 6.0f));
+    }
+
+    /**
+     * First-order allpass (Thiran) interpolation. Flat magnitude, so it suits
+     * slowly swept delays inside feedback loops; state belongs to the tap.
+     */
+    float readAllpass(int ch, float delay, float& state) const
+    {
+        const int i = (int) delay;
+        const float f = delay - (float) i;
+        const float* x = channelData(ch) + ((writePos - i - 1) & mask);
+
+        const float a = (1.0f - f) / (1.0f + f);
+        state = a * (x[1] - state) + x[0];
+        return state;
+    }
+
+    /** Several linear taps from one channel at once. */
+    void readTaps(int ch, const float* delays, float* out, int numTaps) const
+    {
+        const float* d = channelData(ch);
+        for (int t = 0; t < numTaps; ++t)
+            out[t] = linearAt(d, writePos, delays[t]);
+    }
+
+    //==========================================================================
+    // Block
+
+    /** Writes numSamples from the current position on; advance() afterwards. */
+    void writeBlock(int ch, const float* src, int numSamples)
+    {
+        float* d = channelData(ch);
+        int pos = writePos;
+
+        while (numSamples > 0)
+        {
+            const int len = juce::jmin(numSamples, size - pos);
+            std::copy(src, src + len, d + pos);
+
+            if (pos < mirror)
+                std::copy(d + pos, d + juce::jmin(pos + len, mirror), d + pos + size);
+
+            src += len;
+            numSamples -= len;
+            pos = (pos + len) & mask;
+        }
+    }
+
+    /** dest[j] = sample at a fixed integer delay from block position j. */
+    void readBlock(int ch, float* dest, int numSamples, int delay) const
+    {
+        jassert(delay + numSamples <= size);
+        const float* d = channelData(ch);
+        int pos = (writePos - delay) & mask;
+
+        // Contiguous through the mirror; longer runs take one more copy
+        while (numSamples > 0)
+        {
+            const int len = juce::jmin(numSamples, size + mirror - pos);
+            std::copy(d + pos, d + pos + len, dest);
+
+            dest += len;
+            numSamples -= len;
+            pos = (pos + len) & mask;
+        }
+    }
+
+    /** dest[j] = linear read at delays[j] from block position j. */
+    void readBlockLinear(int ch, float* dest, const float* delays, int numSamples) const
+    {
+        const float* d = channelData(ch);
+        for (int j = 0; j < numSamples; ++j)
+            dest[j] = linearAt(d, writePos + j, delays[j]);
+    }
+
+private:
+    float* channelData(int ch) { return storage.data() + ch * stride; }
+    const float* channelData(int ch) const { return storage.data() + ch * stride; }
+
+    float linearAt(const float* d, int pos, float delay) const
+    {
+        const int i = (int) delay;
+        const float frac = delay - (float) i;
+        const float* x = d + ((pos - i - 1) & mask); // x[1] is the newer sample
+        return x[1] * (1.0f - frac) + x[0] * frac;
+    }
+
+    std::vector<float> storage;
+    int channels = 1;
+    int maxDelay = 1, maxBlock = 1;
+    int size = 0, mask = 0, mirror = 0, stride = 0;
+    int writePos = 0;
+};
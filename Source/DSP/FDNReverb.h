@@ -0,0 +1,340 @@
+#pragma once
+#include <JuceHeader.h>
+#include <cmath>
+#include "DelayLine.h"
+
+/**
+ * FDNReverb - 8-line feedback delay network reverb core.
+ *
+ *   mono in -> 4 series allpass diffusers -> 8 delay lines
+ *   each line: read (half of them modulated) -> one-pole decay filter -> Householder mix -> back in
+ *   stereo out: two orthogonal sign patterns across the filtered lines
+ *
+ * The Householder matrix (I - 2/N * 11^T) is lossless and costs one sum per
+ * sample instead of an N x N product. The network runs in sub-blocks no
+ * longer than its shortest loop, so lines are read and written as blocks
+ * and the mixing and taps are vector loops over time. Decay is set per line from the RT60 at
+ * low and high frequencies, so damping shortens the highs rather than
+ * dulling the input. Models differ in delay set, diffusion, modulation and
+ * decay range, not just in knob scaling.
+ *
+ * Delay lengths glide to a new size instead of jumping, and all
+ * coefficients are only recomputed when a parameter actually changes.
+ */
+class FDNReverb
+{
+public:
+    static constexpr int numLines = 8;
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+
+        const int maxLineDelay = (int) std::ceil((maxDelayMs + maxModMs) * 0.001 * sampleRate) + 2;
+        for (auto& line : lines)
+            line.prepare(1, maxLineDelay, maxSubBlock);
+
+        for (int i = 0; i < numDiffusers; ++i)
+            diffusers[i].prepare(1, (int) std::ceil(diffuserMs[i] * 0.001 * sampleRate) + 1, maxSubBlock);
+
+        updateModel();
+        for (int i = 0; i < numLines; ++i)
+            currentDelay[i] = targetDelay[i];
+        updateSubBlockSize();
+
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& line : lines)
+            line.reset();
+        for (auto& d : diffusers)
+            d.reset();
+
+        for (int i = 0; i < numLines; ++i)
+            dampState[i] = 0.0f;
+
+        lfoCos = 1.0f;
+        lfoSin = 0.0f;
+    }
+
+    /** Recomputes only what the changed values touch. */
+    void setParameters(int newModel, float newSize, float newDamping)
+    {
+        newModel = juce::jlimit(0, numModels - 1, newModel);
+
+        if (newModel != model || newSize != size || newDamping != damping)
+        {
+            model = newModel;
+            size = newSize;
+            damping = newDamping;
+            updateModel();
+        }
+    }
+
+    /** Wet-only output; input may alias outL. */
+    void process(const float* input, float* outL, float* outR, int numSamples)
+    {
+        for (int start = 0; start < numSamples; start += subBlockSize)
+        {
+            const int n = juce::jmin(subBlockSize, numSamples - start);
+            processSubBlock(input + start, outL + start, outR != nullptr ? outR + start : nullptr, n);
+        }
+    }
+
+    /**
+     * -120 dB is two RT60s of the slowest (low-frequency) decay; the longest
+     * line and the diffusers add their own delay before it starts.
+     */
+    static double getTailSeconds(int model, float size)
+    {
+        const auto& m = models[juce::jlimit(0, numModels - 1, model)];
+        const double scale = m.minScale + (1.0f - m.minScale) * size;
+
+        double diffuserSeconds = 0.0;
+        for (auto ms : diffuserMs)
+            diffuserSeconds += ms * 0.001;
+
+        return 2.0 * (m.rt60Min + (m.rt60Max - m.rt60Min) * size)
+             + (maxDelayMs * scale + maxModMs) * 0.001 + diffuserSeconds;
+    }
+
+private:
+    static constexpr int maxSubBlock = 128;
+
+    /**
+     * Every loop is at least one sub-block long, so a whole sub-block can be
+     * read from the lines before any of it is written back: the per-line
+     * work becomes block reads/writes and 8-wide or n-wide vector loops.
+     */
+    void processSubBlock(const float* input, float* outL, float* outR, int n)
+    {
+        const auto& m = models[model];
+        const float injection = 1.0f / std::sqrt((float) numLines);
+        const float outScale = m.wetGain * 1.5f; // Level-matched to the old Freeverb core on the default hall
+        const float wide = 0.5f + 0.5f * m.width, narrow = 0.5f - 0.5f * m.width;
+
+        alignas(32) float x[maxSubBlock];
+        alignas(32) float tmp[maxSubBlock];
+        std::copy(input, input + n, x);
+
+        // Input diffusion: w = x + g w[n-D], y = w[n-D] - g w
+        for (int k = 0; k < numDiffusers; ++k)
+        {
+            const float g = diffusion[k];
+            diffusers[k].readBlock(0, tmp, n, diffuserDelay[k]);
+
+            for (int s = 0; s < n; ++s)
+            {
+                const float w = x[s] + g * tmp[s];
+                x[s] = tmp[s] - g * w;
+                tmp[s] = w;
+            }
+
+            diffusers[k].writeBlock(0, tmp, n);
+            diffusers[k].advance(n);
+        }
+
+        // Quadrature LFO: one rotation per sample instead of a sin per line
+        alignas(32) float lfo[2][maxSubBlock];
+        for (int s = 0; s < n; ++s)
+        {
+            const float c = lfoCos * lfoStepCos - lfoSin * lfoStepSin;
+            lfoSin = lfoSin * lfoStepCos + lfoCos * lfoStepSin;
+            lfoCos = c;
+            lfo[0][s] = lfoSin * modDepth;
+            lfo[1][s] = lfoCos * modDepth;
+        }
+
+        // Line reads, glide applied at sub-block rate. Half the lines are
+        // modulated; the rest settle on whole samples and read as one copy
+        alignas(32) float y[numLines][maxSubBlock];
+        for (int i = 0; i < numLines; ++i)
+        {
+            if (currentDelay[i] != targetDelay[i])
+            {
+                currentDelay[i] += (targetDelay[i] - currentDelay[i]) * glide * (float) n;
+                if (std::abs(targetDelay[i] - currentDelay[i]) < 0.01f)
+                    currentDelay[i] = targetDelay[i];
+            }
+
+            if (isModulated(i))
+            {
+                const float* mod = lfo[(i >> 1) & 1];
+                const float sign = (i & 4) ? -1.0f : 1.0f;
+                for (int s = 0; s < n; ++s)
+                    tmp[s] = currentDelay[i] + sign * mod[s];
+
+                lines[i].readBlockLinear(0, y[i], tmp, n);
+            }
+            else if (currentDelay[i] == targetDelay[i])
+            {
+                lines[i].readBlock(0, y[i], n, (int) currentDelay[i]);
+            }
+            else
+            {
+                std::fill(tmp, tmp + n, currentDelay[i]);
+                lines[i].readBlockLinear(0, y[i], tmp, n);
+            }
+        }
+
+        // Decay filters, Householder reflection and stereo taps in one pass:
+        // the eight lines sit side by side in registers for each sample
+        alignas(32) float state[numLines], wetL[maxSubBlock], wetR[maxSubBlock];
+        std::copy(dampState, dampState + numLines, state);
+
+        for (int s = 0; s < n; ++s)
+        {
+            alignas(32) float d[numLines];
+            float sum = 0.0f, l = 0.0f, r = 0.0f;
+
+            for (int i = 0; i < numLines; ++i)
+            {
+                d[i] = state[i] = dampFeed[i] * y[i][s] + dampPole[i] * state[i];
+                sum += d[i];
+                l += d[i] * leftSigns[i];
+                r += d[i] * rightSigns[i];
+            }
+
+            const float reflect = sum * (2.0f / numLines);
+            const float in = x[s] * injection;
+
+            for (int i = 0; i < numLines; ++i)
+                y[i][s] = d[i] - reflect + in * inputSigns[i];
+
+            wetL[s] = l;
+            wetR[s] = r;
+        }
+
+        std::copy(state, state + numLines, dampState);
+
+        for (int i = 0; i < numLines; ++i)
+        {
+            lines[i].writeBlock(0, y[i], n);
+            lines[i].advance(n);
+        }
+
+        for (int s = 0; s < n; ++s)
+        {
+            const float l = wetL[s] * outScale, r = wetR[s] * outScale;
+            outL[s] = l * wide + r * narrow;
+            if (outR != nullptr)
+                outR[s] = r * wide + l * narrow;
+        }
+
+        // Keep the oscillator on the unit circle
+        const float norm = 1.0f / std::sqrt(lfoCos * lfoCos + lfoSin * lfoSin);
+        lfoCos *= norm;
+        lfoSin *= norm;
+    }
+
+    static bool isModulated(int line) { return (line & 1) == 0; }
+
+    struct Model
+    {
+        float delaysMs[numLines];  // At full size
+        float minScale;            // Delay scale at size 0
+        float rt60Min, rt60Max;    // Low-frequency decay range over size, seconds
+        float dampMin, dampRange;  // High-frequency RT60 reduction over the damping knob
+        float diffusion;           // Input allpass gain
+        float modDepthMs, modRateHz;
+        float width, wetGain;
+    };
+
+    static constexpr int numModels = 5;
+    static constexpr float maxDelayMs = 152.0f;
+    static constexpr float maxModMs = 0.6f;
+
+    // Hall, Room, Plate, Spring, Cathedral
+    static constexpr Model models[numModels] = {
+        { { 43.1f, 51.7f, 59.3f, 67.9f, 73.7f, 83.3f, 91.1f, 101.3f }, 0.45f, 1.2f, 4.5f, 0.0f, 0.6f, 0.70f, 0.35f, 0.6f, 1.0f, 1.0f },
+        { { 11.3f, 13.7f, 16.1f, 18.9f, 21.7f, 24.1f, 27.3f, 30.7f }, 0.5f, 0.3f, 1.2f, 0.3f, 0.5f, 0.60f, 0.10f, 0.9f, 0.7f, 1.0f },
+        { { 17.9f, 23.3f, 27.7f, 31.9f, 37.1f, 41.3f, 46.7f, 52.1f }, 0.6f, 0.8f, 3.5f, 0.0f, 0.3f, 0.75f, 0.25f, 1.1f, 1.0f, 1.0f },
+        { { 19.7f, 24.3f, 28.1f, 33.7f, 20.3f, 25.1f, 29.3f, 34.9f }, 0.7f, 0.6f, 2.0f, 0.4f, 0.4f, 0.50f, 0.60f, 2.7f, 0.5f, 1.2f },
+        { { 67.3f, 79.1f, 89.9f, 101.9f, 113.3f, 127.1f, 139.7f, 151.3f }, 0.6f, 3.0f, 9.0f, 0.0f, 0.2f, 0.75f, 0.50f, 0.4f, 1.0f, 1.0f }
+    };
+
+    static constexpr int numDiffusers = 4;
+    static constexpr float diffuserMs[numDiffusers] = { 4.77f, 3.59f, 12.73f, 9.29f };
+    static constexpr float diffuserGain[numDiffusers] = { 1.0f, 1.0f, 0.83f, 0.83f }; // Times the model diffusion
+
+    static constexpr float inputSigns[numLines] = { 1, -1, 1, -1, 1, -1, 1, -1 };
+    static constexpr float leftSigns[numLines]  = { 1, 1, -1, -1, 1, 1, -1, -1 };
+    static constexpr float rightSigns[numLines] = { 1, -1, -1, 1, 1, -1, -1, 1 };
+
+    void updateModel()
+    {
+        const auto& m = models[model];
+        const float sr = (float) sampleRate;
+        const float scale = m.minScale + (1.0f - m.minScale) * size;
+
+        const float rt60 = m.rt60Min + (m.rt60Max - m.rt60Min) * size;
+        const float hfRatio = juce::jmax(0.1f, 1.0f - (m.dampMin + m.dampRange * damping));
+
+        for (int i = 0; i < numLines; ++i)
+        {
+            targetDelay[i] = m.delaysMs[i] * scale * 0.001f * sr;
+            if (! isModulated(i))
+                targetDelay[i] = std::round(targetDelay[i]);
+
+            // Per-pass gains for the RT60 at DC and at Nyquist; the one-pole
+            // g (1 - b) / (1 - b z^-1) hits both exactly
+            const float seconds = targetDelay[i] / sr;
+            const float gLow = std::pow(10.0f, -3.0f * seconds / rt60);
+            const float gHigh = std::pow(10.0f, -3.0f * seconds / (rt60 * hfRatio));
+
+            dampPole[i] = (gLow - gHigh) / (gLow + gHigh);
+            dampFeed[i] = gLow * (1.0f - dampPole[i]);
+        }
+
+        for (int k = 0; k < numDiffusers; ++k)
+        {
+            diffuserDelay[k] = juce::jmax(1, (int) (diffuserMs[k] * 0.001f * sr));
+            diffusion[k] = m.diffusion * diffuserGain[k];
+        }
+
+        modDepth = m.modDepthMs * 0.001f * sr;
+        const float w = juce::MathConstants<float>::twoPi * m.modRateHz / sr;
+        lfoStepCos = std::cos(w);
+        lfoStepSin = std::sin(w);
+
+        glide = 1.0f - std::exp(-1.0f / (0.05f * sr)); // ~50 ms size glide
+        updateSubBlockSize();
+    }
+
+    void updateSubBlockSize()
+    {
+        // No loop may be shorter than a sub-block; the glide stays between
+        // the current and target lengths, so both bound it
+        float shortest = (float) maxSubBlock;
+        for (int i = 0; i < numLines; ++i)
+            shortest = juce::jmin(shortest, juce::jmin(currentDelay[i], targetDelay[i]) - modDepth - 1.0f);
+        for (int k = 0; k < numDiffusers; ++k)
+            shortest = juce::jmin(shortest, (float) diffuserDelay[k]);
+
+        subBlockSize = juce::jmax(1, (int) shortest);
+    }
+
+    double sampleRate = 44100.0;
+    int model = 0;
+    float size = 0.5f, damping = 0.5f;
+
+    DelayLine lines[numLines];
+    DelayLine diffusers[numDiffusers];
+
+    alignas(32) float targetDelay[numLines] = {};
+    alignas(32) float currentDelay[numLines] = {};
+    alignas(32) float dampFeed[numLines] = {};
+    alignas(32) float dampPole[numLines] = {};
+    alignas(32) float dampState[numLines] = {};
+
+    int diffuserDelay[numDiffusers] = {};
+    float diffusion[numDiffusers] = {};
+
+    float modDepth = 0.0f;
+    float lfoCos = 1.0f, lfoSin = 0.0f;
+    float lfoStepCos = 1.0f, lfoStepSin = 0.0f;
+    float glide = 0.0f;
+    int subBlockSize = 1;
+};
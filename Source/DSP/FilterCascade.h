@@ -0,0 +1,198 @@
+#pragma once
+#include <JuceHeader.h>
+#include "Biquad.h"
+
+/**
+ * FilterCascade - Runs a run of linear, time-invariant biquads from several
+ * modules as one fused cascade: a single pass over the block with every
+ * section's state kept in cache, instead of one pass per filter.
+ *
+ * Modules hand over their sections each block through a fixed slot layout
+ * (begin / add / skip / addGain). Identity sections (flat EQ bands, bypassed
+ * modules) are dropped, so the cascade runs at the lowest order that gives
+ * the same response; the active list is only rebuilt when a contributed
+ * coefficient actually changes. State lives per slot, so a band that comes
+ * back in starts clean instead of replaying an old tail.
+ */
+class FilterCascade
+{
+public:
+    static constexpr int maxSections = 24;
+    static constexpr int maxChannels = Biquad::maxChannels;
+
+    void reset()
+    {
+        for (auto& s : state)
+            s = {};
+    }
+
+    /** Starts channel to from channel from's filter memory, in every section. */
+    void copyChannelState(int from, int to)
+    {
+        for (auto& s : state)
+        {
+            s.z1[to] = s.z1[from];
+            s.z2[to] = s.z2[from];
+        }
+    }
+
+    /** Starts collecting this block's sections. */
+    void begin()
+    {
+        numSlots = 0;
+        pendingGain = 1.0f;
+    }
+
+    /** Adds a filter's current design in the next slot. */
+    void add(const Biquad& filter)
+    {
+        jassert(numSlots < maxSections);
+        if (numSlots < maxSections)
+            pending[numSlots++] = filter.getCoefficients();
+    }
+
+    /** Leaves the next slots as pass-through (bypassed module, flat band). */
+    void skip(int count = 1)
+    {
+        for (int i = 0; i < count && numSlots < maxSections; ++i)
+            pending[numSlots++] = {};
+    }
+
+    /** Broadband gain, folded into the cascade rather than run as its own pass. */
+    void addGain(float gain) { pendingGain *= gain; }
+
+    void process(juce::AudioBuffer<float>& buffer)
+    {
+        update();
+
+        const int numChannels = juce::jmin(buffer.getNumChannels(), maxChannels);
+        const int numSamples = buffer.getNumSamples();
+
+        if (numActive == 0)
+        {
+            if (gain != 1.0f)
+                for (int ch = 0; ch < numChannels; ++ch)
+                    buffer.applyGain(ch, 0, numSamples, gain);
+            return;
+        }
+
+        if (numChannels == 2)
+            processSections<2>(buffer.getArrayOfWritePointers(), numSamples);
+        else if (numChannels == 1)
+            processSections<1>(buffer.getArrayOfWritePointers(), numSamples);
+    }
+
+    /** Number of sections actually run, after dropping identity slots. */
+    int getNumActiveSections() const { return numActive; }
+
+private:
+    struct State { float z1[maxChannels] = {}, z2[maxChannels] = {}; };
+
+    static bool isIdentity(const Biquad::Coefficients& c)
+    {
+        return c.b0 == 1.0f && c.b1 == c.a1 && c.b2 == c.a2;
+    }
+
+    static bool equal(const Biquad::Coefficients& a, const Biquad::Coefficients& b)
+    {
+        return a.b0 == b.b0 && a.b1 == b.b1 && a.b2 == b.b2 && a.a1 == b.a1 && a.a2 == b.a2;
+    }
+
+    /** Rebuilds the active section list only if a slot or the gain changed. */
+    void update()
+    {
+        bool changed = numSlots != builtSlots || pendingGain != gain;
+        for (int i = 0; i < numSlots && ! changed; ++i)
+            changed = ! equal(pending[i], slots[i]);
+
+        if (! changed)
+            return;
+
+        numActive = 0;
+        for (int i = 0; i < numSlots; ++i)
+        {
+            const bool wasActive = i < builtSlots && ! isIdentity(slots[i]);
+            slots[i] = pending[i];
+
+            if (isIdentity(slots[i]))
+                continue;
+
+            if (! wasActive)
+                state[i] = {};
+
+            active[numActive] = slots[i];
+            activeSlot[numActive] = i;
+            ++numActive;
+        }
+
+        builtSlots = numSlots;
+        gain = pendingGain;
+
+        // Fold the broadband gain into the first section's numerator
+        if (numActive > 0)
+        {
+            active[0].b0 *= gain;
+            active[0].b1 *= gain;
+            active[0].b2 *= gain;
+        }
+    }
+
+    /** Sample-outer, section-inner: the channel pair moves through each section together. */
+    template <int NumCh>
+    void processSections(float* const* data, int numSamples)
+    {
+        // Gather state so the inner loop works on a small local array
+        float z1[maxSections][NumCh], z2[maxSections][NumCh];
+        for (int k = 0; k < numActive; ++k)
+            for (int ch = 0; ch < NumCh; ++ch)
+            {
+                z1[k][ch] = state[activeSlot[k]].z1[ch];
+                z2[k][ch] = state[activeSlot[k]].z2[ch];
+            }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float x[NumCh];
+            for (int ch = 0; ch < NumCh; ++ch)
+                x[ch] = data[ch][i];
+
+            for (int k = 0; k < numActive; ++k)
+            {
+                const auto& c = active[k];
+                for (int ch = 0; ch < NumCh; ++ch)
+                {
+                    const float y = c.b0 * x[ch] + z1[k][ch];
+                    z1[k][ch] = c.b1 * x[ch] - c.a1 * y + z2[k][ch];
+                    z2[k][ch] = c.b2 * x[ch] - c.a2 * y;
+                    x[ch] = y;
+                }
+            }
+
+            for (int ch = 0; ch < NumCh; ++ch)
+                data[ch][i] = x[ch];
+        }
+
+        for (int k = 0; k < numActive; ++k)
+            for (int ch = 0; ch < NumCh; ++ch)
+            {
+                state[activeSlot[k]].z1[ch] = z1[k][ch];
+                state[activeSlot[k]].z2[ch] = z2[k][ch];
+            }
+    }
+
+    // Collected this block
+    Biquad::Coefficients pending[maxSections];
+    int numSlots = 0;
+    float pendingGain = 1.0f;
+
+    // Last built layout
+    Biquad::Coefficients slots[maxSections];
+    int builtSlots = 0;
+    float gain = 1.0f;
+
+    Biquad::Coefficients active[maxSections];
+    int activeSlot[maxSections] = {};
+    int numActive = 0;
+
+    State state[maxSections];
+};
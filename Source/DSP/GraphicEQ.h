@@ -1,5 +1,7 @@
 #pragma once
 #include <JuceHeader.h>
+#include "Biquad.h"
+#include "FilterCascade.h"
 
 class GraphicEQ
 {
@@ -10,8 +12,7 @@ public:
     {
         sampleRate = spec.sampleRate;
         for (int i = 0; i < numBands; ++i)
-            for (int ch = 0; ch < 2; ++ch)
-                filters[i][ch].reset();
+            filters[i].prepare(sampleRate);
 
         updateAllBands();
     }
@@ -23,33 +24,47 @@ public:
         updateBand(band);
     }
 
-    void process(juce::AudioBuffer<float>& buffer)
+    struct Parameters
     {
-        int numChannels = buffer.getNumChannels();
-        auto block = juce::dsp::AudioBlock<float>(buffer);
+        float gainsDb[10] = {};
+    };
 
+    void setParameters(const Parameters& p)
+    {
+        for (int band = 0; band < numBands; ++band)
+            if (p.gainsDb[band] != bandGains[band])
+                setBand(band, p.gainsDb[band]);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer)
+    {
         for (int band = 0; band < numBands; ++band)
         {
             if (std::abs(bandGains[band]) < 0.1f) continue; // Skip flat bands
 
-            for (int ch = 0; ch < numChannels; ++ch)
-            {
-                auto sb = block.getSingleChannelBlock(ch);
-                auto ctx = juce::dsp::ProcessContextReplacing<float>(sb);
-                filters[band][ch].process(ctx);
-            }
+            filters[band].process(buffer);
+        }
+    }
+
+    /** Hands the bands to a fused cascade instead of processing them here. */
+    void appendFilters(FilterCascade& cascade) const
+    {
+        for (int band = 0; band < numBands; ++band)
+        {
+            if (std::abs(bandGains[band]) < 0.1f)
+                cascade.skip(); // Flat band
+            else
+                cascade.add(filters[band]);
         }
     }
 
+    static constexpr int numBands = 10;
+
 private:
     void updateBand(int band)
     {
         float gain = juce::Decibels::decibelsToGain(bandGains[band]);
-        auto coeffs = juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-            sampleRate, centerFreqs[band], 1.4f, gain);
-
-        for (int ch = 0; ch < 2; ++ch)
-            *filters[band][ch].coefficients = *coeffs;
+        filters[band].setPeak(centerFreqs[band], 1.4f, gain);
     }
 
     void updateAllBands()
@@ -58,7 +73,6 @@ private:
             updateBand(i);
     }
 
-    static constexpr int numBands = 10;
     double sampleRate = 44100.0;
 
     // ISO standard frequencies
@@ -68,5 +82,5 @@ private:
     };
 
     float bandGains[numBands] = {}; // dB, initialized to 0
-    juce::dsp::IIR::Filter<float> filters[numBands][2]; // 10 bands x 2 channels
+    Biquad filters[numBands]; // 10 bands, stereo state each
 };
@@ -1,5 +1,6 @@
 #pragma once
 #include <JuceHeader.h>
+#include "DelayLine.h"
 
 class Harmonizer
 {
@@ -9,65 +10,67 @@ public:
     void prepare(const juce::dsp::ProcessSpec& spec)
     {
         sampleRate = spec.sampleRate;
-        // Circular buffer for pitch shifting (granular approach)
-        int bufSize = static_cast<int>(sampleRate * 0.1); // 100ms window
-        grainBuffer.resize(bufSize, 0.0f);
-        writePos = 0;
-        readPos = 0.0f;
+        // Rotating read head for pitch shifting (granular approach)
+        grainPeriod = static_cast<int>(sampleRate * 0.1); // 100ms window
+        grainLine.prepare(1, grainPeriod + 1, 1);
+        readDelay = 0.0f;
         crossfadePos = 0.0f;
     }
 
-    void setInterval(int i) { interval = i; }
+    void setInterval(int i) { interval = i; pitchRatio = getPitchRatio(); }
     void setMix(float m) { mix = m; }
 
+    struct Parameters
+    {
+        int interval = 1;
+        float mix = 0.5f;
+    };
+
+    void setParameters(const Parameters& p)
+    {
+        setInterval(p.interval);
+        setMix(p.mix);
+    }
+
+    /** The read head never trails by more than one grain period. */
+    static double getTailSeconds(const Parameters&, double) { return 0.1; }
+
     void process(juce::AudioBuffer<float>& buffer)
     {
-        float pitchRatio = getPitchRatio();
         int numSamples = buffer.getNumSamples();
         int numChannels = buffer.getNumChannels();
-        int bufSize = (int)grainBuffer.size();
+        float* const* data = buffer.getArrayOfWritePointers();
+        float period = (float)grainPeriod;
 
         for (int s = 0; s < numSamples; ++s)
         {
-            float dry = buffer.getSample(0, s);
-
             // Write to grain buffer
-            grainBuffer[writePos] = dry;
+            grainLine.write(0, data[0][s]);
 
-            // Read at pitch-shifted rate
-            int readInt = (int)readPos;
-            float readFrac = readPos - (float)readInt;
-            int r1 = readInt % bufSize;
-            int r2 = (readInt + 1) % bufSize;
-            float shifted = grainBuffer[r1] * (1.0f - readFrac) + grainBuffer[r2] * readFrac;
+            // Read head trails the write head, drifting at the pitch ratio
+            float shifted = grainLine.readLinear(0, readDelay);
 
             // Granular crossfade to avoid clicks
-            float halfBuf = (float)bufSize * 0.5f;
-            float dist = std::fmod(std::abs((float)writePos - readPos + bufSize), (float)bufSize);
             float window = 1.0f;
-            if (dist < 64.0f)
-                window = dist / 64.0f;
+            if (readDelay < 64.0f)
+                window = readDelay / 64.0f;
 
             shifted *= window;
 
             // Advance positions
-            readPos += pitchRatio;
-            if (readPos >= (float)bufSize) readPos -= (float)bufSize;
-            if (readPos < 0.0f) readPos += (float)bufSize;
-
-            writePos = (writePos + 1) % bufSize;
+            grainLine.advance();
+            readDelay += 1.0f - pitchRatio;
+            if (readDelay >= period) readDelay -= period;
+            if (readDelay < 0.0f) readDelay += period;
 
             // Apply to all channels
             for (int ch = 0; ch < numChannels; ++ch)
-            {
-                float dryCh = buffer.getSample(ch, s);
-                buffer.setSample(ch, s, dryCh * (1.0f - mix * 0.5f) + shifted * mix);
-            }
+                data[ch][s] = data[ch][s] * (1.0f - mix * 0.5f) + shifted * mix;
         }
     }
 
 private:
-    float getPitchRatio()
+    float getPitchRatio() const
     {
         // Interval-to-semitone mapping
         float semitones = 0.0f;
@@ -85,10 +88,11 @@ private:
 
     double sampleRate = 44100.0;
     int interval = 1; // Major 3rd default
+    float pitchRatio = 1.25992105f;
     float mix = 0.5f;
 
-    std::vector<float> grainBuffer;
-    int writePos = 0;
-    float readPos = 0.0f;
+    DelayLine grainLine;
+    int grainPeriod = 4410;
+    float readDelay = 0.0f; // Write head to read head, in [0, grainPeriod)
     float crossfadePos = 0.0f;
 };
@@ -1,156 +1,152 @@
 #pragma once
 #include <JuceHeader.h>
+#include "Biquad.h"
+#include "WaveshaperTable.h"
+#include <array>
 
 class HighGainDist
 {
 public:
-    HighGainDist() = default;
+    HighGainDist()
+    {
+        getCurves(); // Build the shared tables here, never on the audio thread
+    }
 
     void prepare(const juce::dsp::ProcessSpec& spec)
     {
         sampleRate = spec.sampleRate;
-        for (int ch = 0; ch < 2; ++ch)
-        {
-            toneFilter[ch].reset();
-            // Lower cutoff for warmer, less fizzy tone
-            toneFilter[ch].coefficients = juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, 4000.0f);
-            tightFilter[ch].reset();
-            tightFilter[ch].coefficients = juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 80.0f);
-            presenceFilter[ch].reset();
-            presenceFilter[ch].coefficients = juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, 2500.0f, 1.5f, 1.8f);
-            // Mid-body boost for thick, chunky tone
-            midBody[ch].reset();
-            midBody[ch].coefficients = juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, 600.0f, 0.8f, 3.0f);
-            // Anti-fizz filter
-            smoothFilter[ch].reset();
-            smoothFilter[ch].coefficients = juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, 5500.0f);
-        }
+        toneFilter.prepare(sampleRate);
+        setTone(tone);
+        tightFilter.prepare(sampleRate);
+        setTight(tight);
+        presenceFilter.prepare(sampleRate);
+        presenceFilter.setPeak(2500.0f, 1.5f, 1.8f);
+        // Mid-body boost for thick, chunky tone
+        midBody.prepare(sampleRate);
+        midBody.setPeak(600.0f, 0.8f, 3.0f);
+        // Anti-fizz filter
+        smoothFilter.prepare(sampleRate);
+        smoothFilter.setLowPass(5500.0f);
     }
 
     void setModel(int m) { model = m; }
     void setGain(float g) { gain = g; }
-    void setTone(float t) { tone = t; }
+    void setTone(float t)
+    {
+        // Lower cutoff range for a warmer, less fizzy tone
+        tone = t;
+        toneFilter.setLowPass(800.0f + (tone / 10.0f) * 3500.0f);
+    }
     void setLevel(float l) { level = l; }
-    void setTight(bool t) { tight = t; }
+    void setTight(bool t)
+    {
+        tight = t;
+        if (tight)
+            tightFilter.setHighPass(100.0f, 1.0f);
+        else
+            tightFilter.setHighPass(50.0f, 0.7f);
+    }
+
+    struct Parameters
+    {
+        int model = 0;
+        float gain = 7.0f, tone = 5.0f, level = 5.0f;
+        bool tight = true;
+    };
+
+    void setParameters(const Parameters& p)
+    {
+        setModel(p.model);
+        setGain(p.gain);
+        setTone(p.tone);
+        setLevel(p.level);
+        setTight(p.tight);
+    }
+
+    /** Starts channel to from channel from's pre and post filter memory. */
+    void copyChannelState(int from, int to)
+    {
+        tightFilter.copyChannelState(from, to);
+        midBody.copyChannelState(from, to);
+        smoothFilter.copyChannelState(from, to);
+        toneFilter.copyChannelState(from, to);
+        presenceFilter.copyChannelState(from, to);
+    }
 
     void process(juce::AudioBuffer<float>& buffer)
     {
         // High gain but not excessive — keep it musical
         float gainAmount = 2.0f + gain * 20.0f;
-
-        float toneFreq = 800.0f + (tone / 10.0f) * 3500.0f;
         float outputLevel = level / 10.0f;
 
-        if (toneFreq != lastToneFreq)
-        {
-            auto toneCoeffs = juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, toneFreq);
-            for (auto& f : toneFilter)
-                *f.coefficients = *toneCoeffs;
-            lastToneFreq = toneFreq;
-        }
-
-        if (tight != lastTight)
-        {
-            auto tightCoeffs = tight
-                ? juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 100.0f, 1.0f)
-                : juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 50.0f, 0.7f);
-            for (auto& f : tightFilter)
-                *f.coefficients = *tightCoeffs;
-            lastTight = tight;
-        }
-
         int numSamples = buffer.getNumSamples();
         int numChannels = buffer.getNumChannels();
 
-        auto block = juce::dsp::AudioBlock<float>(buffer);
-
         // Pre-filter: tight + mid body boost
-        for (int ch = 0; ch < numChannels; ++ch)
-        {
-            auto sb = block.getSingleChannelBlock(ch);
-            auto ctx = juce::dsp::ProcessContextReplacing<float>(sb);
-            tightFilter[ch].process(ctx);
-            midBody[ch].process(ctx);
-        }
+        tightFilter.process(buffer);
+        midBody.process(buffer);
 
         // Waveshaping
+        const auto& curves = getCurves();
         for (int ch = 0; ch < numChannels; ++ch)
         {
             auto* data = buffer.getWritePointer(ch);
-            for (int s = 0; s < numSamples; ++s)
+            switch (model)
             {
-                float sample = data[s];
-                sample = applyModel(sample, gainAmount);
-                data[s] = sample * outputLevel;
+                case 1: curves[fiveOneFifty].process(data, numSamples, gainAmount * 1.3f, outputLevel); break;
+                case 2: curves[dualRec].process(data, numSamples, gainAmount * 1.5f, outputLevel); break;
+                case 3: curves[djent].process(data, numSamples, gainAmount * 2.0f, outputLevel); break;
+                default:
+                    // Rectifier: the middle stage's drive depends on gain, so split the cascade there
+                    curves[rectifierInput].process(data, numSamples, gainAmount, 1.0f);
+                    curves[rectifierOutput].process(data, numSamples, gainAmount * 0.3f, outputLevel);
+                    break;
             }
         }
 
         // Post-filter: smooth + tone + presence
-        for (int ch = 0; ch < numChannels; ++ch)
-        {
-            auto sb = block.getSingleChannelBlock(ch);
-            auto ctx = juce::dsp::ProcessContextReplacing<float>(sb);
-            smoothFilter[ch].process(ctx);
-            toneFilter[ch].process(ctx);
-            presenceFilter[ch].process(ctx);
-        }
+        smoothFilter.process(buffer);
+        toneFilter.process(buffer);
+        presenceFilter.process(buffer);
     }
 
 private:
-    float applyModel(float x, float g)
-    {
-        switch (model)
-        {
-            case 0: return rectifier(x, g);
-            case 1: return fiveOneFifty(x, g);
-            case 2: return dualRec(x, g);
-            case 3: return djent(x, g);
-            default: return rectifier(x, g);
-        }
-    }
+    enum Curve { rectifierInput, rectifierOutput, fiveOneFifty, dualRec, djent, numCurves };
 
-    // Rectifier: Mesa-style thick multi-stage
-    float rectifier(float x, float g)
+    /** Per-model transfer curves (input pre-scaled by the gain), shared by every instance. */
+    static const std::array<WaveshaperTable, numCurves>& getCurves()
     {
-        x *= g;
-        // Three tube stages for thick, saturated tone
-        float s1 = std::tanh(x * 1.5f);
-        float s2 = std::tanh(s1 * g * 0.3f);
-        float s3 = std::tanh(s2 * 1.5f);
-        // Asymmetric for warmth
-        return (s3 > 0.0f) ? s3 * 0.85f : s3 * 0.92f;
-    }
+        static const std::array<WaveshaperTable, numCurves> curves {
+            // Rectifier: Mesa-style thick, three tube stages. First stage...
+            WaveshaperTable([](double x) { return std::tanh(x * 1.5); }),
 
-    // 5150: Tight, punchy high gain
-    float fiveOneFifty(float x, float g)
-    {
-        x *= g * 1.3f;
-        // Cascaded stages with controlled gain
-        float s1 = std::tanh(x * 2.5f);
-        float s2 = std::tanh(s1 * 2.0f);
-        // Asymmetric for punch
-        if (s2 > 0.0f) return s2 * 0.82f;
-        return s2 * 0.9f;
-    }
+            // ...then the gain-driven second stage and the output stage, asymmetric for warmth
+            WaveshaperTable([](double x)
+            {
+                double s3 = std::tanh(std::tanh(x) * 1.5);
+                return s3 > 0.0 ? s3 * 0.85 : s3 * 0.92;
+            }),
 
-    // Dual Rec: Scooped, massive
-    float dualRec(float x, float g)
-    {
-        x *= g * 1.5f;
-        float s1 = std::tanh(x * 2.0f);
-        float s2 = (2.0f / juce::MathConstants<float>::pi) * std::atan(s1 * 3.5f);
-        float s3 = std::tanh(s2 * 2.0f);
-        return s3 * 0.85f;
-    }
+            // 5150: Tight, punchy high gain, asymmetric for punch
+            WaveshaperTable([](double x)
+            {
+                double s2 = std::tanh(std::tanh(x * 2.5) * 2.0);
+                return s2 > 0.0 ? s2 * 0.82 : s2 * 0.9;
+            }),
 
-    // Djent: Very tight, percussive
-    float djent(float x, float g)
-    {
-        x *= g * 2.0f;
-        // Tight clipping with sustain
-        float s1 = std::tanh(x * 3.0f);
-        float s2 = std::tanh(s1 * 2.5f);
-        return s2 * 0.88f;
+            // Dual Rec: Scooped, massive
+            WaveshaperTable([](double x)
+            {
+                double s1 = std::tanh(x * 2.0);
+                double s2 = (2.0 / juce::MathConstants<double>::pi) * std::atan(s1 * 3.5);
+                return std::tanh(s2 * 2.0) * 0.85;
+            }),
+
+            // Djent: Very tight, percussive clipping with sustain
+            WaveshaperTable([](double x) { return std::tanh(std::tanh(x * 3.0) * 2.5) * 0.88; })
+        };
+
+        return curves;
     }
 
     double sampleRate = 44100.0;
@@ -158,13 +154,10 @@ private:
     float gain = 7.0f, tone = 5.0f, level = 5.0f;
     bool tight = true;
 
-    float lastToneFreq = -1.0f;
-    bool lastTight = false;
-
-    juce::dsp::IIR::Filter<float> toneFilter[2];
-    juce::dsp::IIR::Filter<float> tightFilter[2];
-    juce::dsp::IIR::Filter<float> presenceFilter[2];
-    juce::dsp::IIR::Filter<float> midBody[2];       // Mid body for thickness
-    juce::dsp::IIR::Filter<float> smoothFilter[2];   // Anti-fizz
+    Biquad toneFilter;
+    Biquad tightFilter;
+    Biquad presenceFilter;
+    Biquad midBody;      // Mid body for thickness
+    Biquad smoothFilter; // Anti-fizz
 };
 
@@ -0,0 +1,162 @@
+#pragma once
+#include <JuceHeader.h>
+#include <cmath>
+#include <vector>
+
+/**
+ * LevelDetector - Sidechain analysis of one point in the chain, run once per
+ * block and read by every module that keys off that signal.
+ *
+ * analyse() rectifies the block (the largest magnitude across channels, per
+ * sample) with vector operations and measures its peak, RMS and level in
+ * dB, flagging an onset when the level jumps well above its recent average.
+ * A module that only keys off the rectified signal calls rectify() and
+ * skips the measurements. Consumers only read: each runs its own
+ * EnvelopeFollower over getRectified() with its own attack and release, so
+ * modules sharing a tap share the detection pass but not the ballistics.
+ */
+class LevelDetector
+{
+public:
+    static constexpr float onsetRiseDb = 9.0f;   // Above the recent average
+    static constexpr float onsetFloorDb = -50.0f;
+
+    void prepare(int maximumBlockSize, double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        rectified.assign((size_t) juce::jmax(1, maximumBlockSize), 0.0f);
+        scratch.assign(rectified.size(), 0.0f);
+        numSamples = 0;
+        peak = rms = 0.0f;
+        levelDb = averageDb = -100.0f;
+        onset = false;
+    }
+
+    /** Analyses the first maxChannels channels of buffer. */
+    void analyse(const juce::AudioBuffer<float>& buffer, int maxChannels = 2)
+    {
+        rectify(buffer, maxChannels);
+
+        const int numChannels = juce::jmin(buffer.getNumChannels(), maxChannels);
+        float sumSquares = 0.0f;
+        for (int ch = 0; ch < numChannels; ++ch)
+            sumSquares += getSumOfSquares(buffer.getReadPointer(ch), numSamples);
+
+        peak = numSamples > 0 ? juce::FloatVectorOperations::findMaximum(rectified.data(), numSamples) : 0.0f;
+        meanSquare = sumSquares / (float) juce::jmax(1, numChannels * numSamples);
+        rms = std::sqrt(meanSquare);
+        levelDb = juce::Decibels::gainToDecibels(rms, -100.0f);
+
+        // Onset: a jump over the level of the last ~100 ms
+        onset = levelDb > onsetFloorDb && levelDb > averageDb + onsetRiseDb;
+        const float keep = (float) std::exp(-numSamples / (0.1 * sampleRate));
+        averageDb = levelDb + (averageDb - levelDb) * keep;
+    }
+
+    /** Only fills getRectified(); the block measurements keep their last values. */
+    void rectify(const juce::AudioBuffer<float>& buffer, int maxChannels = 2)
+    {
+        const int numChannels = juce::jmin(buffer.getNumChannels(), maxChannels);
+        numSamples = juce::jmin(buffer.getNumSamples(), (int) rectified.size());
+        jassert(numSamples == buffer.getNumSamples());
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float* data = buffer.getReadPointer(ch);
+
+            if (ch == 0)
+            {
+                juce::FloatVectorOperations::abs(rectified.data(), data, numSamples);
+            }
+            else
+            {
+                juce::FloatVectorOperations::abs(scratch.data(), data, numSamples);
+                juce::FloatVectorOperations::max(rectified.data(), rectified.data(), scratch.data(), numSamples);
+            }
+        }
+    }
+
+    /**
+     * The tapped signal went through a per-sample gain (>= 0) since
+     * analyse(); scales the rectified level to match, so the next module
+     * down the chain can key off it without a second pass.
+     */
+    void applyGain(const float* gains)
+    {
+        juce::FloatVectorOperations::multiply(rectified.data(), gains, numSamples);
+    }
+
+    const float* getRectified() const { return rectified.data(); }
+    int getNumSamples() const { return numSamples; }
+
+    // Block measurements, as of the last analyse()
+    float getPeak() const { return peak; }
+    float getRms() const { return rms; }
+    float getMeanSquare() const { return meanSquare; }
+    float getLevelDb() const { return levelDb; }
+    bool isOnset() const { return onset; }
+
+    static float getSumOfSquares(const float* data, int numSamples)
+    {
+        // Independent lanes so the loop vectorizes without fast-math
+        constexpr int lanes = 8;
+        float acc[lanes] = {};
+
+        int s = 0;
+        for (; s + lanes <= numSamples; s += lanes)
+            for (int l = 0; l < lanes; ++l)
+                acc[l] += data[s + l] * data[s + l];
+
+        float sum = 0.0f;
+        for (; s < numSamples; ++s)
+            sum += data[s] * data[s];
+        for (float a : acc)
+            sum += a;
+
+        return sum;
+    }
+
+private:
+    std::vector<float> rectified, scratch;
+    double sampleRate = 44100.0;
+    int numSamples = 0;
+    float peak = 0.0f, rms = 0.0f, meanSquare = 0.0f;
+    float levelDb = -100.0f, averageDb = -100.0f;
+    bool onset = false;
+};
+
+/**
+ * EnvelopeFollower - One consumer's attack/release ballistics over a
+ * rectified sidechain. Coefficients are set when the times change, never
+ * per block.
+ */
+class EnvelopeFollower
+{
+public:
+    /** One-pole retention for a time constant. */
+    static float getCoefficient(double seconds, double sampleRate)
+    {
+        return (float) std::exp(-1.0 / juce::jmax(1.0e-9, seconds * sampleRate));
+    }
+
+    void setCoefficients(float attack, float release)
+    {
+        attackCoeff = attack;
+        releaseCoeff = release;
+    }
+
+    void reset(float value = 0.0f) { envelope = value; }
+
+    float process(float level)
+    {
+        const float coeff = level > envelope ? attackCoeff : releaseCoeff;
+        envelope = coeff * envelope + (1.0f - coeff) * level;
+        return envelope;
+    }
+
+    float getEnvelope() const { return envelope; }
+
+private:
+    float attackCoeff = 0.0f, releaseCoeff = 0.0f;
+    float envelope = 0.0f;
+};
@@ -0,0 +1,116 @@
+#pragma once
+#include <JuceHeader.h>
+#include "Seqlock.h"
+#include "LevelDetector.h"
+#include <array>
+#include <atomic>
+
+/** One module's meter as the GUI sees it; levels are linear. */
+struct MeterReading
+{
+    float peak = 0.0f;
+    float rms = 0.0f;
+    float gainReductionDb = 0.0f; // Compressor and noise gate only
+};
+
+/**
+ * MeterBank - Per-module levels from the audio thread to the GUI.
+ *
+ * The audio thread measures a module's output once per block and publishes
+ * one snapshot per module through a Seqlock, so it never blocks or
+ * allocates and the editor can read on its timer at any rate. Peak and gain
+ * reduction fall back and RMS is averaged per block here, so what the GUI
+ * reads doesn't depend on how many blocks passed between two timer ticks.
+ *
+ * Nothing is measured unless an editor has registered as a viewer.
+ */
+class MeterBank
+{
+public:
+    enum Meter
+    {
+        input, gate, comp, overdrive, distortion, highGain,
+        amp,          // Preamp, tone stack and power amp
+        cabinetEQ,    // Cabinet and both EQs share one fused filter pass
+        talkBox, autoWah, chorus, flanger, phaser, harmonizer, stringSynth, delay, reverb,
+        output,
+        numMeters
+    };
+
+    //==========================================================================
+    // Message thread
+
+    void addViewer() { viewers.fetch_add(1); }
+    void removeViewer() { viewers.fetch_sub(1); }
+
+    MeterReading getReading(Meter m) const { return readings[(size_t) m].load(); }
+
+    //==========================================================================
+    // Audio thread
+
+    bool isEnabled() const { return viewers.load(std::memory_order_relaxed) > 0; }
+
+    /** Once per block, before any measure(): works out this block's ballistics. */
+    void beginBlock(int numSamples, double sampleRate)
+    {
+        const double blockSeconds = numSamples / juce::jmax(1.0, sampleRate);
+        peakFall = (float) std::exp(-blockSeconds / peakFallSeconds);
+        rmsKeep = (float) std::exp(-blockSeconds / rmsSeconds);
+    }
+
+    void measure(Meter m, const juce::AudioBuffer<float>& buffer, float gainReductionDb = 0.0f)
+    {
+        const int numChannels = buffer.getNumChannels();
+        const int numSamples = buffer.getNumSamples();
+
+        float peak = 0.0f, sumSquares = 0.0f;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto* data = buffer.getReadPointer(ch);
+            const auto range = juce::FloatVectorOperations::findMinAndMax(data, numSamples);
+            peak = juce::jmax(peak, -range.getStart(), range.getEnd());
+            sumSquares += LevelDetector::getSumOfSquares(data, numSamples);
+        }
+
+        measure(m, peak, sumSquares / (float) juce::jmax(1, numChannels * numSamples), gainReductionDb);
+    }
+
+    /** For a block already measured elsewhere (a LevelDetector on the same signal). */
+    void measure(Meter m, float peak, float meanSquare, float gainReductionDb = 0.0f)
+    {
+        auto& st = states[(size_t) m];
+        st.peak = juce::jmax(peak, st.peak * peakFall);
+        st.meanSquare = meanSquare + (st.meanSquare - meanSquare) * rmsKeep;
+        st.reductionDb = juce::jmax(gainReductionDb, st.reductionDb * peakFall);
+        st.live = true;
+
+        readings[(size_t) m].store({ st.peak, std::sqrt(st.meanSquare), st.reductionDb });
+    }
+
+    /** For a module that is off: publishes silence once, then nothing. */
+    void clear(Meter m)
+    {
+        auto& st = states[(size_t) m];
+        if (st.live)
+        {
+            st = {};
+            readings[(size_t) m].store({});
+        }
+    }
+
+private:
+    static constexpr double peakFallSeconds = 0.3;  // -8.7 dB per 300 ms
+    static constexpr double rmsSeconds = 0.3;
+
+    struct State
+    {
+        float peak = 0.0f, meanSquare = 0.0f, reductionDb = 0.0f;
+        bool live = false;
+    };
+
+    std::array<Seqlock<MeterReading>, numMeters> readings;
+    std::array<State, numMeters> states {};
+    float peakFall = 0.0f, rmsKeep = 0.0f;
+
+    std::atomic<int> viewers { 0 };
+};
@@ -0,0 +1,715 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+/**
+ * NeuralAmp - Inference engine for captured amp profiles, the "Neural
+ * Capture" preamp model.
+ *
+ * A capture is a small recurrent (LSTM or GRU) or dilated-convolution
+ * (WaveNet-style) network trained on one amp at one sample rate. Layer sizes
+ * are template parameters, so every matrix kernel has compile-time bounds.
+ * Weights are stored column-major: a matrix-vector product is a run of
+ * broadcast multiply-adds over whole output columns, which vectorizes
+ * straight across the outputs with no horizontal sums. The conv stack runs
+ * layer by layer over a whole chunk instead of sample by sample.
+ *
+ * All storage is sized when a capture is built on the message thread;
+ * process() never allocates.
+ *
+ * File formats carry the same flat weight list in PyTorch state-dict order
+ * (see the network classes for the exact layout):
+ *
+ *   JSON (.json, .nam)
+ *     { "architecture": "LSTM" | "GRU" | "ConvNet", "sample_rate": 48000,
+ *       "config": { "hidden_size": 16, "skip": 1 }                     // LSTM, GRU
+ *              or { "channels": 8, "kernel_size": 3, "dilations": [1, 2, 4] },
+ *       "weights": [ ... ] }
+ *
+ *   Binary (anything else), little-endian
+ *     "GFXN", int version (1), int architecture (0 LSTM, 1 GRU, 2 ConvNet),
+ *     float sampleRate, int hiddenSize or channels, int kernelSize, int skip,
+ *     int numDilations, int dilations[numDilations], int numWeights,
+ *     float weights[numWeights]
+ */
+namespace NeuralKernels
+{
+    /**
+     * Clamped [7/6] Pade tanh; branch-free so fixed-size loops vectorize.
+     * Within 1e-4 of std::tanh, the worst of it at the clamp.
+     */
+    inline float tanh(float x)
+    {
+        x = juce::jlimit(-4.97f, 4.97f, x);
+        const float x2 = x * x;
+        const float num = x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2)));
+        const float den = 135135.0f + x2 * (62370.0f + x2 * (3150.0f + x2 * 28.0f));
+        return num / den;
+    }
+
+    inline float sigmoid(float x) { return 0.5f + 0.5f * tanh(0.5f * x); }
+
+    /**
+     * y[Rows] += M x, with M stored column-major as m[Cols][Rows]. Rows are
+     * taken in register-sized blocks that stay in accumulators across all
+     * the columns, so y is loaded and stored once per call.
+     */
+    template <int Rows, int Cols>
+    inline void multiplyAdd(float* __restrict y, const float* __restrict m, const float* __restrict x)
+    {
+        constexpr int block = Rows % 32 == 0 ? 32 : (Rows % 16 == 0 ? 16 : (Rows % 8 == 0 ? 8 : 4));
+        static_assert(Rows % block == 0, "Row count must be a multiple of 4");
+
+        for (int r0 = 0; r0 < Rows; r0 += block)
+        {
+            float acc[block];
+            for (int r = 0; r < block; ++r)
+                acc[r] = y[r0 + r];
+
+            for (int j = 0; j < Cols; ++j)
+            {
+                const float xj = x[j];
+                const float* col = m + j * Rows + r0;
+                for (int r = 0; r < block; ++r)
+                    acc[r] += col[r] * xj;
+            }
+
+            for (int r = 0; r < block; ++r)
+                y[r0 + r] = acc[r];
+        }
+    }
+
+    template <int N>
+    inline float dot(const float* a, const float* b)
+    {
+        float sum = 0.0f;
+        for (int i = 0; i < N; ++i)
+            sum += a[i] * b[i];
+        return sum;
+    }
+
+    /** PyTorch row-major [rows][cols] -> column-major [cols][rows]. */
+    inline void transpose(float* dest, const float* src, int rows, int cols)
+    {
+        for (int r = 0; r < rows; ++r)
+            for (int c = 0; c < cols; ++c)
+                dest[c * rows + r] = src[r * cols + c];
+    }
+}
+
+//==============================================================================
+/** One channel of a network; process() takes at most maxChunk samples. */
+class NeuralNetwork
+{
+public:
+    static constexpr int maxChunk = 64;
+
+    virtual ~NeuralNetwork() = default;
+    virtual void reset() = 0;
+    virtual void process(const float* input, float* output, int numSamples) = 0;
+
+    /** Takes over the recurrent state of source, a clone of this network; no allocation. */
+    virtual void copyStateFrom(const NeuralNetwork& source) = 0;
+    virtual std::unique_ptr<NeuralNetwork> clone() const = 0;
+};
+
+/** Everything but the weights, as read from a capture file. */
+struct NeuralConfig
+{
+    enum Architecture { lstm = 0, gru = 1, convNet = 2 };
+
+    int architecture = lstm;
+    double sampleRate = 48000.0;
+    int hiddenSize = 16;     // LSTM, GRU
+    bool skip = false;       // LSTM, GRU: output adds the input
+    int channels = 8;        // ConvNet
+    int kernelSize = 3;      // ConvNet
+    std::vector<int> dilations;
+
+    int getNumWeights() const
+    {
+        const int h = hiddenSize, c = channels;
+        switch (architecture)
+        {
+            case lstm: return 4 * h + 4 * h * h + 8 * h + h + 1;
+            case gru:  return 3 * h + 3 * h * h + 6 * h + h + 1;
+            default:   return 2 * c + (int) dilations.size() * (c * c * kernelSize + c + c * c + c) + c + 1;
+        }
+    }
+};
+
+//==============================================================================
+/**
+ * Single-layer LSTM with a dense head. Weights: weight_ih [4H], weight_hh
+ * [4H][H], bias_ih [4H], bias_hh [4H], head weight [H], head bias; gates in
+ * PyTorch's i, f, g, o order.
+ */
+template <int H>
+class LSTMNetwork : public NeuralNetwork
+{
+public:
+    LSTMNetwork(const float* w, bool useSkip) : skip(useSkip)
+    {
+        std::copy(w, w + G, wIh.begin());              w += G;
+        NeuralKernels::transpose(wHh.data(), w, G, H); w += G * H;
+
+        // Both biases land on the same gates, so they fold into one
+        for (int r = 0; r < G; ++r)
+            bias[(size_t) r] = w[r] + w[G + r];
+        w += 2 * G;
+
+        std::copy(w, w + H, head.begin());             w += H;
+        headBias = *w;
+        reset();
+    }
+
+    void reset() override
+    {
+        hidden.fill(0.0f);
+        cell.fill(0.0f);
+    }
+
+    void copyStateFrom(const NeuralNetwork& source) override
+    {
+        const auto& other = static_cast<const LSTMNetwork&>(source);
+        hidden = other.hidden;
+        cell = other.cell;
+    }
+
+    void process(const float* input, float* output, int numSamples) override
+    {
+        alignas(32) float gates[G];
+
+        for (int s = 0; s < numSamples; ++s)
+        {
+            const float x = input[s];
+
+            for (int r = 0; r < G; ++r)
+                gates[r] = bias[(size_t) r] + wIh[(size_t) r] * x;
+            NeuralKernels::multiplyAdd<G, H>(gates, wHh.data(), hidden.data());
+
+            for (int r = 0; r < H; ++r)
+            {
+                const float i = NeuralKernels::sigmoid(gates[r]);
+                const float f = NeuralKernels::sigmoid(gates[H + r]);
+                const float g = NeuralKernels::tanh(gates[2 * H + r]);
+                const float o = NeuralKernels::sigmoid(gates[3 * H + r]);
+                cell[(size_t) r] = f * cell[(size_t) r] + i * g;
+                hidden[(size_t) r] = o * NeuralKernels::tanh(cell[(size_t) r]);
+            }
+
+            output[s] = headBias + NeuralKernels::dot<H>(head.data(), hidden.data()) + (skip ? x : 0.0f);
+        }
+    }
+
+    std::unique_ptr<NeuralNetwork> clone() const override { return std::make_unique<LSTMNetwork>(*this); }
+
+private:
+    static constexpr int G = 4 * H;
+
+    alignas(32) std::array<float, G> wIh {}, bias {};
+    alignas(32) std::array<float, G * H> wHh {};
+    alignas(32) std::array<float, H> head {}, hidden {}, cell {};
+    float headBias = 0.0f;
+    bool skip = false;
+};
+
+/**
+ * Single-layer GRU with a dense head. Weights: weight_ih [3H], weight_hh
+ * [3H][H], bias_ih [3H], bias_hh [3H], head weight [H], head bias; gates in
+ * PyTorch's r, z, n order.
+ */
+template <int H>
+class GRUNetwork : public NeuralNetwork
+{
+public:
+    GRUNetwork(const float* w, bool useSkip) : skip(useSkip)
+    {
+        std::copy(w, w + G, wIh.begin());              w += G;
+        NeuralKernels::transpose(wHh.data(), w, G, H); w += G * H;
+        std::copy(w, w + G, bIh.begin());              w += G;
+        std::copy(w, w + G, bHh.begin());              w += G;
+        std::copy(w, w + H, head.begin());             w += H;
+        headBias = *w;
+        reset();
+    }
+
+    void reset() override { hidden.fill(0.0f); }
+
+    void copyStateFrom(const NeuralNetwork& source) override
+    {
+        hidden = static_cast<const GRUNetwork&>(source).hidden;
+    }
+
+    void process(const float* input, float* output, int numSamples) override
+    {
+        alignas(32) float hh[G];
+
+        for (int s = 0; s < numSamples; ++s)
+        {
+            const float x = input[s];
+
+            std::copy(bHh.begin(), bHh.end(), hh);
+            NeuralKernels::multiplyAdd<G, H>(hh, wHh.data(), hidden.data());
+
+            for (int r = 0; r < H; ++r)
+            {
+                const auto rz = (size_t) (H + r), rn = (size_t) (2 * H + r);
+                const float resetGate = NeuralKernels::sigmoid(wIh[(size_t) r] * x + bIh[(size_t) r] + hh[r]);
+                const float updateGate = NeuralKernels::sigmoid(wIh[rz] * x + bIh[rz] + hh[rz]);
+                const float n = NeuralKernels::tanh(wIh[rn] * x + bIh[rn] + resetGate * hh[rn]);
+                hidden[(size_t) r] = n + updateGate * (hidden[(size_t) r] - n);
+            }
+
+            output[s] = headBias + NeuralKernels::dot<H>(head.data(), hidden.data()) + (skip ? x : 0.0f);
+        }
+    }
+
+    std::unique_ptr<NeuralNetwork> clone() const override { return std::make_unique<GRUNetwork>(*this); }
+
+private:
+    static constexpr int G = 3 * H;
+
+    alignas(32) std::array<float, G> wIh {}, bIh {}, bHh {};
+    alignas(32) std::array<float, G * H> wHh {};
+    alignas(32) std::array<float, H> head {}, hidden {};
+    float headBias = 0.0f;
+    bool skip = false;
+};
+
+/**
+ * Dilated causal convolution stack with tanh activations, residual 1x1 mixes
+ * and a head over the summed skips. Weights: input 1x1 [C] and bias [C];
+ * per layer conv weight [C][C][K] (tap K - 1 is the newest sample) and bias
+ * [C], then the residual mix [C][C] and bias [C]; head weight [C] and bias.
+ *
+ * Everything is channel-major, so each layer is evaluated for the whole
+ * chunk at once as a set of weight-times-row accumulations. Each layer keeps
+ * its inputs in a power-of-two ring per channel whose first history +
+ * maxChunk samples are mirrored past the end, as in DelayLine: the history
+ * and the chunk after it are always one contiguous run, and nothing shifts.
+ */
+template <int C, int K>
+class ConvNetwork : public NeuralNetwork
+{
+public:
+    ConvNetwork(const float* w, const std::vector<int>& dilations)
+    {
+        std::copy(w, w + C, inWeight.begin()); w += C;
+        std::copy(w, w + C, inBias.begin());   w += C;
+
+        layers.resize(dilations.size());
+        for (size_t l = 0; l < layers.size(); ++l)
+        {
+            auto& layer = layers[l];
+            layer.dilation = juce::jmax(1, dilations[l]);
+            layer.history = (K - 1) * layer.dilation;
+            layer.size = juce::nextPowerOfTwo(layer.history + maxChunk);
+            layer.mirror = layer.history + maxChunk;
+            layer.stride = layer.size + layer.mirror;
+            layer.rows.assign((size_t) (layer.stride * C), 0.0f);
+
+            std::copy(w, w + C * C * K, layer.conv.begin()); w += C * C * K;
+            std::copy(w, w + C, layer.convBias.begin());     w += C;
+            std::copy(w, w + C * C, layer.mix.begin());      w += C * C;
+            std::copy(w, w + C, layer.mixBias.begin());      w += C;
+        }
+
+        std::copy(w, w + C, head.begin()); w += C;
+        headBias = *w;
+    }
+
+    void reset() override
+    {
+        for (auto& layer : layers)
+        {
+            std::fill(layer.rows.begin(), layer.rows.end(), 0.0f);
+            layer.writePos = 0;
+        }
+    }
+
+    void copyStateFrom(const NeuralNetwork& source) override
+    {
+        const auto& other = static_cast<const ConvNetwork&>(source);
+        for (size_t l = 0; l < layers.size(); ++l)
+        {
+            std::copy(other.layers[l].rows.begin(), other.layers[l].rows.end(), layers[l].rows.begin());
+            layers[l].writePos = other.layers[l].writePos;
+        }
+    }
+
+    void process(const float* input, float* output, int numSamples) override
+    {
+        using FVO = juce::FloatVectorOperations;
+        jassert(numSamples <= maxChunk);
+
+        for (int c = 0; c < C; ++c)
+        {
+            float* x = row(current, c);
+            FVO::fill(x, inBias[(size_t) c], numSamples);
+            FVO::addWithMultiply(x, input, inWeight[(size_t) c], numSamples);
+            FVO::clear(row(skipSum, c), numSamples);
+        }
+
+        for (auto& layer : layers)
+        {
+            for (int c = 0; c < C; ++c)
+                append(layer, layer.rows.data() + c * layer.stride, row(current, c), numSamples);
+
+            const int start = ((layer.writePos - layer.history) & (layer.size - 1)) + layer.history;
+            layer.writePos = (layer.writePos + numSamples) & (layer.size - 1);
+
+            // Dilated conv, one output row at a time
+            for (int o = 0; o < C; ++o)
+            {
+                float* z = row(activation, o);
+                FVO::fill(z, layer.convBias[(size_t) o], numSamples);
+
+                for (int i = 0; i < C; ++i)
+                {
+                    const float* chunk = layer.rows.data() + i * layer.stride + start;
+                    const float* w = layer.conv.data() + (o * C + i) * K;
+
+                    for (int k = 0; k < K; ++k)
+                        FVO::addWithMultiply(z, chunk - (K - 1 - k) * layer.dilation, w[k], numSamples);
+                }
+
+                for (int t = 0; t < numSamples; ++t)
+                    z[t] = NeuralKernels::tanh(z[t]);
+
+                FVO::add(row(skipSum, o), z, numSamples);
+            }
+
+            // Residual 1x1 mix into the next layer's input
+            for (int o = 0; o < C; ++o)
+            {
+                float* x = row(current, o);
+                FVO::add(x, layer.mixBias[(size_t) o], numSamples);
+
+                for (int i = 0; i < C; ++i)
+                    FVO::addWithMultiply(x, row(activation, i), layer.mix[(size_t) (o * C + i)], numSamples);
+            }
+        }
+
+        FVO::fill(output, headBias, numSamples);
+        for (int c = 0; c < C; ++c)
+            FVO::addWithMultiply(output, row(skipSum, c), head[(size_t) c], numSamples);
+    }
+
+    std::unique_ptr<NeuralNetwork> clone() const override { return std::make_unique<ConvNetwork>(*this); }
+
+private:
+    using Rows = std::array<float, C * maxChunk>;
+    static float* row(Rows& rows, int c) { return rows.data() + c * maxChunk; }
+
+    struct Layer
+    {
+        int dilation = 1, history = 0;
+        int size = maxChunk, mirror = maxChunk, stride = 2 * maxChunk, writePos = 0;
+        std::vector<float> rows; // Per channel: the ring, then its mirrored head
+        std::array<float, C * C * K> conv {};
+        std::array<float, C * C> mix {};
+        std::array<float, C> convBias {}, mixBias {};
+    };
+
+    /** Writes a chunk at the layer's write position, keeping the mirror in step. */
+    static void append(const Layer& layer, float* ring, const float* src, int numSamples)
+    {
+        int pos = layer.writePos;
+
+        while (numSamples > 0)
+        {
+            const int len = juce::jmin(numSamples, layer.size - pos);
+            std::copy(src, src + len, ring + pos);
+
+            if (pos < layer.mirror)
+                std::copy(ring + pos, ring + juce::jmin(pos + len, layer.mirror), ring + pos + layer.size);
+
+            src += len;
+            numSamples -= len;
+            pos = (pos + len) & (layer.size - 1);
+        }
+    }
+
+    alignas(32) std::array<float, C> inWeight {}, inBias {}, head {};
+    float headBias = 0.0f;
+    std::vector<Layer> layers;
+
+    alignas(32) Rows current {}, activation {}, skipSum {};
+};
+
+//==============================================================================
+/**
+ * NeuralCapture - A loaded profile: one network per channel plus rate
+ * matching. When the host (or oversampled) rate is an integer multiple of
+ * the capture's rate, the input is averaged down to the capture rate and the
+ * output linearly interpolated back up, so the network always runs at the
+ * rate it was trained at and oversampling costs nothing extra here. Other
+ * ratios run the network at the host rate.
+ */
+class NeuralCapture
+{
+public:
+    static constexpr int maxChannels = 2;
+
+    /** Message thread: builds a capture from a file, or nullptr if it can't be read. */
+    static std::unique_ptr<NeuralCapture> load(const juce::File& file)
+    {
+        if (file.hasFileExtension(".json;.nam"))
+            return fromJSON(juce::JSON::parse(file));
+
+        juce::MemoryBlock data;
+        if (! file.loadFileAsData(data))
+            return nullptr;
+
+        return fromBinary(data.getData(), data.getSize());
+    }
+
+    static std::unique_ptr<NeuralCapture> fromJSON(const juce::var& json)
+    {
+        if (! json.isObject())
+            return nullptr;
+
+        NeuralConfig config;
+        const auto arch = json.getProperty("architecture", {}).toString();
+        if (arch == "LSTM")         config.architecture = NeuralConfig::lstm;
+        else if (arch == "GRU")     config.architecture = NeuralConfig::gru;
+        else if (arch == "ConvNet") config.architecture = NeuralConfig::convNet;
+        else return nullptr;
+
+        config.sampleRate = (double) json.getProperty("sample_rate", 48000.0);
+
+        const auto& settings = json.getProperty("config", {});
+        config.hiddenSize = (int) settings.getProperty("hidden_size", 16);
+        config.skip = (int) settings.getProperty("skip", 0) != 0;
+        config.channels = (int) settings.getProperty("channels", 8);
+        config.kernelSize = (int) settings.getProperty("kernel_size", 3);
+
+        if (auto* dilations = settings.getProperty("dilations", {}).getArray())
+            for (const auto& d : *dilations)
+                config.dilations.push_back((int) d);
+
+        std::vector<float> weights;
+        if (auto* list = json.getProperty("weights", {}).getArray())
+        {
+            weights.reserve((size_t) list->size());
+            for (const auto& w : *list)
+                weights.push_back((float) w);
+        }
+
+        return create(config, weights);
+    }
+
+    static std::unique_ptr<NeuralCapture> fromBinary(const void* data, size_t size)
+    {
+        juce::MemoryInputStream in(data, size, false);
+
+        char magic[4] = {};
+        if (in.read(magic, 4) != 4 || std::memcmp(magic, "GFXN", 4) != 0 || in.readInt() != 1)
+            return nullptr;
+
+        NeuralConfig config;
+        config.architecture = in.readInt();
+        config.sampleRate = (double) in.readFloat();
+        config.hiddenSize = config.channels = in.readInt();
+        config.kernelSize = in.readInt();
+        config.skip = in.readInt() != 0;
+
+        const int numDilations = in.readInt();
+        if (numDilations < 0 || numDilations > maxLayers)
+            return nullptr;
+
+        for (int i = 0; i < numDilations; ++i)
+            config.dilations.push_back(in.readInt());
+
+        const int numWeights = in.readInt();
+        if (numWeights < 0 || in.getNumBytesRemaining() < (juce::int64) numWeights * 4)
+            return nullptr;
+
+        std::vector<float> weights((size_t) numWeights);
+        for (auto& w : weights)
+            w = in.readFloat();
+
+        return create(config, weights);
+    }
+
+    /** Validates the config against the weight count and the supported sizes. */
+    static std::unique_ptr<NeuralCapture> create(const NeuralConfig& config, const std::vector<float>& weights)
+    {
+        if (config.sampleRate <= 0.0 || (int) weights.size() != config.getNumWeights())
+            return nullptr;
+
+        auto network = createNetwork(config, weights.data());
+        if (network == nullptr)
+            return nullptr;
+
+        auto capture = std::unique_ptr<NeuralCapture>(new NeuralCapture());
+        capture->captureRate = config.sampleRate;
+        capture->networks[1] = network->clone();
+        capture->networks[0] = std::move(network);
+        return capture;
+    }
+
+    double getCaptureSampleRate() const { return captureRate; }
+
+    /** Audio or message thread; no allocation. */
+    void prepare(double hostSampleRate)
+    {
+        // Decimate only by an exact whole ratio: averaging 2 host samples
+        // per frame at, say, 88.2 kHz into a 48 kHz capture would run it
+        // 8% slow and detune it
+        const double ratio = hostSampleRate / captureRate;
+        const int whole = juce::roundToInt(ratio);
+        factor = whole > 1 && std::abs(ratio - whole) < 1.0e-6 * ratio ? whole : 1;
+
+        for (int ch = 0; ch < maxChannels; ++ch)
+        {
+            networks[(size_t) ch]->reset();
+            states[(size_t) ch] = {};
+        }
+    }
+
+    /** Starts channel to from channel from's network and resampler state. */
+    void copyChannelState(int from, int to)
+    {
+        networks[(size_t) to]->copyStateFrom(*networks[(size_t) from]);
+        states[(size_t) to] = states[(size_t) from];
+    }
+
+    void process(juce::AudioBuffer<float>& buffer)
+    {
+        const int numChannels = juce::jmin(buffer.getNumChannels(), maxChannels);
+        const int numSamples = buffer.getNumSamples();
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* data = buffer.getWritePointer(ch);
+            auto& network = *networks[(size_t) ch];
+
+            if (factor == 1)
+            {
+                for (int start = 0; start < numSamples; start += NeuralNetwork::maxChunk)
+                {
+                    const int n = juce::jmin(NeuralNetwork::maxChunk, numSamples - start);
+                    network.process(data + start, data + start, n);
+                }
+            }
+            else
+            {
+                // Enough host samples per pass to fill at most one chunk of frames
+                const int span = NeuralNetwork::maxChunk * factor;
+                for (int start = 0; start < numSamples; start += span)
+                    processDecimated(network, states[(size_t) ch], data + start, juce::jmin(span, numSamples - start));
+            }
+        }
+    }
+
+private:
+    NeuralCapture() = default;
+
+    static constexpr int maxLayers = 32;
+
+    struct RateState
+    {
+        int phase = 0;       // Host samples into the current frame
+        float sum = 0.0f;    // Their input sum
+        float previous = 0.0f, latest = 0.0f;
+    };
+
+    void processDecimated(NeuralNetwork& network, RateState& st, float* data, int numSamples)
+    {
+        const float scale = 1.0f / (float) factor;
+
+        // Average complete frames down to the capture rate
+        int numFrames = 0;
+        {
+            int phase = st.phase;
+            float sum = st.sum;
+            for (int s = 0; s < numSamples; ++s)
+            {
+                sum += data[s];
+                if (++phase == factor)
+                {
+                    frameIn[(size_t) numFrames++] = sum * scale;
+                    sum = 0.0f;
+                    phase = 0;
+                }
+            }
+            st.sum = sum;
+        }
+
+        network.process(frameIn.data(), frameOut.data(), numFrames);
+
+        // Interpolate between the two newest outputs; one frame of latency
+        int frame = 0;
+        for (int s = 0; s < numSamples; ++s)
+        {
+            data[s] = st.previous + (st.latest - st.previous) * ((float) st.phase * scale);
+
+            if (++st.phase == factor)
+            {
+                st.previous = st.latest;
+                st.latest = frameOut[(size_t) frame++];
+                st.phase = 0;
+            }
+        }
+    }
+
+    template <template <int> class Net>
+    static std::unique_ptr<NeuralNetwork> createRecurrent(int hiddenSize, const float* w, bool skip)
+    {
+        switch (hiddenSize)
+        {
+            case 8:  return std::make_unique<Net<8>>(w, skip);
+            case 12: return std::make_unique<Net<12>>(w, skip);
+            case 16: return std::make_unique<Net<16>>(w, skip);
+            case 20: return std::make_unique<Net<20>>(w, skip);
+            case 24: return std::make_unique<Net<24>>(w, skip);
+            case 32: return std::make_unique<Net<32>>(w, skip);
+            case 40: return std::make_unique<Net<40>>(w, skip);
+            default: return nullptr;
+        }
+    }
+
+    template <int K>
+    static std::unique_ptr<NeuralNetwork> createConv(int channels, const float* w, const std::vector<int>& dilations)
+    {
+        switch (channels)
+        {
+            case 4:  return std::make_unique<ConvNetwork<4, K>>(w, dilations);
+            case 8:  return std::make_unique<ConvNetwork<8, K>>(w, dilations);
+            case 12: return std::make_unique<ConvNetwork<12, K>>(w, dilations);
+            case 16: return std::make_unique<ConvNetwork<16, K>>(w, dilations);
+            default: return nullptr;
+        }
+    }
+
+    static std::unique_ptr<NeuralNetwork> createNetwork(const NeuralConfig& config, const float* w)
+    {
+        switch (config.architecture)
+        {
+            case NeuralConfig::lstm: return createRecurrent<LSTMNetwork>(config.hiddenSize, w, config.skip);
+            case NeuralConfig::gru:  return createRecurrent<GRUNetwork>(config.hiddenSize, w, config.skip);
+            case NeuralConfig::convNet:
+                if (config.dilations.empty() || (int) config.dilations.size() > maxLayers)
+                    return nullptr;
+                for (int d : config.dilations)
+                    if (d < 1 || d > 1024)
+                        return nullptr;
+
+                if (config.kernelSize == 2) return createConv<2>(config.channels, w, config.dilations);
+                if (config.kernelSize == 3) return createConv<3>(config.channels, w, config.dilations);
+                return nullptr;
+            default: return nullptr;
+        }
+    }
+
+    double captureRate = 48000.0;
+    int factor = 1;
+    std::array<std::unique_ptr<NeuralNetwork>, maxChannels> networks;
+    std::array<RateState, maxChannels> states;
+    std::array<float, NeuralNetwork::maxChunk> frameIn {}, frameOut {};
+};
@@ -1,5 +1,7 @@
 #pragma once
 #include <JuceHeader.h>
+#include "LevelDetector.h"
+#include <vector>
 
 class NoiseGate
 {
@@ -9,44 +11,47 @@ public:
     void prepare(const juce::dsp::ProcessSpec& spec)
     {
         sampleRate = spec.sampleRate;
-        envelope = 0.0f;
+        gains.assign((size_t) juce::jmax(1u, spec.maximumBlockSize), 1.0f);
+        follower.reset();
         gainReduction = 1.0f;
         gateOpen = true;
         holdCounter = 0;
+        updateCoefficients();
     }
 
-    void setThreshold(float threshDb) { thresholdDb = threshDb; }
-    void setAttack(float attackMs) { attackTime = attackMs; }
-    void setRelease(float releaseMs) { releaseTime = releaseMs; }
-    void setHoldTime(float holdMs) { holdTime = holdMs; }
+    void setThreshold(float threshDb) { thresholdDb = threshDb; updateCoefficients(); }
+    void setAttack(float attackMs) { attackTime = attackMs; updateCoefficients(); }
+    void setRelease(float releaseMs) { releaseTime = releaseMs; updateCoefficients(); }
+    void setHoldTime(float holdMs) { holdTime = holdMs; updateCoefficients(); }
 
-    void process(juce::AudioBuffer<float>& buffer)
+    struct Parameters
     {
-        float threshold = juce::Decibels::decibelsToGain(thresholdDb);
-        float closeThreshold = juce::Decibels::decibelsToGain(thresholdDb - 6.0f);
-        int holdSamples = static_cast<int>(sampleRate * holdTime * 0.001f);
+        float thresholdDb = -40.0f;
+        float attackMs = 1.0f;
+        float releaseMs = 50.0f;
+    };
 
-        // Smoother envelope tracking to eliminate gate stutter ("echo" noise) on high gain tails
-        float envAttackCoeff = std::exp(-1.0f / (sampleRate * 0.001f));
-        float envReleaseCoeff = std::exp(-1.0f / (sampleRate * 0.100f));
-        float gainOpenCoeff = std::exp(-1.0f / (sampleRate * attackTime * 0.001f));
-        float gainCloseCoeff = std::exp(-1.0f / (sampleRate * releaseTime * 0.001f));
+    void setParameters(const Parameters& p)
+    {
+        thresholdDb = p.thresholdDb;
+        attackTime = p.attackMs;
+        releaseTime = p.releaseMs;
+        updateCoefficients();
+    }
 
+    /** sidechain must have analysed buffer as it is now. */
+    void process(juce::AudioBuffer<float>& buffer, const LevelDetector& sidechain)
+    {
         int numSamples = buffer.getNumSamples();
         int numChannels = buffer.getNumChannels();
+        const float* level = sidechain.getRectified();
+        jassert(sidechain.getNumSamples() == numSamples && numSamples <= (int) gains.size());
+        minGain = 1.0f;
 
         for (int sample = 0; sample < numSamples; ++sample)
         {
-            // Peak detect
-            float inputLevel = 0.0f;
-            for (int ch = 0; ch < numChannels; ++ch)
-                inputLevel = std::max(inputLevel, std::abs(buffer.getSample(ch, sample)));
-
-            // Envelope follower
-            if (inputLevel > envelope)
-                envelope = envAttackCoeff * envelope + (1.0f - envAttackCoeff) * inputLevel;
-            else
-                envelope = envReleaseCoeff * envelope + (1.0f - envReleaseCoeff) * inputLevel;
+            // Envelope follower on the shared peak detector
+            const float envelope = follower.process(level[sample]);
 
             // Gate decision with hysteresis + hold time
             if (envelope > threshold)
@@ -70,20 +75,49 @@ public:
             else
                 gainReduction = gainCloseCoeff * gainReduction + (1.0f - gainCloseCoeff) * targetGain;
 
-            // Apply
-            for (int ch = 0; ch < numChannels; ++ch)
-                buffer.setSample(ch, sample, buffer.getSample(ch, sample) * gainReduction);
+            minGain = std::min(minGain, gainReduction);
+            gains[(size_t) sample] = gainReduction;
         }
+
+        // Apply
+        for (int ch = 0; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::multiply(buffer.getWritePointer(ch), gains.data(), numSamples);
     }
 
+    /** The gain applied to each sample by the last process() call. */
+    const float* getGains() const { return gains.data(); }
+
+    /** How far the gate closed during the last process() call, in dB (positive). */
+    float getGainReductionDb() const { return -juce::Decibels::gainToDecibels(minGain, -60.0f); }
+
 private:
+    // Everything process() derives from the settings, worked out when they change
+    void updateCoefficients()
+    {
+        threshold = juce::Decibels::decibelsToGain(thresholdDb);
+        closeThreshold = juce::Decibels::decibelsToGain(thresholdDb - 6.0f);
+        holdSamples = static_cast<int>(sampleRate * holdTime * 0.001f);
+
+        // Smoother envelope tracking to eliminate gate stutter ("echo" noise) on high gain tails
+        follower.setCoefficients(EnvelopeFollower::getCoefficient(0.001, sampleRate),
+                                 EnvelopeFollower::getCoefficient(0.100, sampleRate));
+        gainOpenCoeff = std::exp(-1.0f / (sampleRate * attackTime * 0.001f));
+        gainCloseCoeff = std::exp(-1.0f / (sampleRate * releaseTime * 0.001f));
+    }
+
     float sampleRate = 44100.0f;
     float thresholdDb = -40.0f;
     float attackTime = 1.0f;     // ms
     float releaseTime = 50.0f;   // ms
     float holdTime = 150.0f;     // ms - keeps gate open after signal drops
-    float envelope = 0.0f;
+    EnvelopeFollower follower;
+    std::vector<float> gains;
     float gainReduction = 1.0f;
+    float minGain = 1.0f;
     bool gateOpen = true;
     int holdCounter = 0;
+
+    float threshold = 0.01f, closeThreshold = 0.005f;
+    int holdSamples = 0;
+    float gainOpenCoeff = 0.0f, gainCloseCoeff = 0.0f;
 };
@@ -1,5 +1,6 @@
 #pragma once
 #include <JuceHeader.h>
+#include "Biquad.h"
 
 class Overdrive
 {
@@ -9,100 +10,121 @@ public:
     void prepare(const juce::dsp::ProcessSpec& spec)
     {
         sampleRate = spec.sampleRate;
-        for (int ch = 0; ch < 2; ++ch)
+        toneFilter.prepare(sampleRate);
+        setTone(tone);
+        hpFilter.prepare(sampleRate);
+        hpFilter.setHighPass(80.0f);
+    }
+
+    void setModel(int m)
+    {
+        if (m != model)
         {
-            toneFilter[ch].reset();
-            toneFilter[ch].coefficients = juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, 5000.0f);
-            hpFilter[ch].reset();
-            hpFilter[ch].coefficients = juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 80.0f);
+            model = m;
+            kernel = getKernel(m);
         }
     }
-
-    void setModel(int m) { model = m; }
     void setDrive(float d) { drive = d; }
-    void setTone(float t) { tone = t; }
+    void setTone(float t)
+    {
+        // Lower tone filter range for a rounder, warmer tone
+        tone = t;
+        toneFilter.setLowPass(500.0f + (tone / 10.0f) * 4500.0f);
+    }
     void setLevel(float l) { level = l; }
 
+    struct Parameters
+    {
+        int model = 0;
+        float drive = 5.0f, tone = 5.0f, level = 5.0f;
+    };
+
+    void setParameters(const Parameters& p)
+    {
+        setModel(p.model);
+        setDrive(p.drive);
+        setTone(p.tone);
+        setLevel(p.level);
+    }
+
+    /** Starts channel to from channel from's tone and high-pass memory. */
+    void copyChannelState(int from, int to)
+    {
+        toneFilter.copyChannelState(from, to);
+        hpFilter.copyChannelState(from, to);
+    }
+
     void process(juce::AudioBuffer<float>& buffer)
     {
         // Increased drive scaler for much more sustain
         float driveAmount = 1.0f + drive * 10.0f; 
-        
-        // Lower tone filter range for a rounder, warmer tone
-        float toneFreq = 500.0f + (tone / 10.0f) * 4500.0f; 
         float outputLevel = level / 10.0f;
 
-        auto toneCoeffs = juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, toneFreq);
-        for (auto& f : toneFilter)
-            *f.coefficients = *toneCoeffs;
-
         int numSamples = buffer.getNumSamples();
         int numChannels = buffer.getNumChannels();
 
         for (int ch = 0; ch < numChannels; ++ch)
-        {
-            auto* data = buffer.getWritePointer(ch);
-            for (int s = 0; s < numSamples; ++s)
-            {
-                float sample = data[s];
-                sample = applyModel(sample, driveAmount);
-                data[s] = sample * outputLevel;
-            }
-        }
+            kernel(buffer.getWritePointer(ch), numSamples, driveAmount, outputLevel);
 
         // Apply tone filter per channel
-        auto block = juce::dsp::AudioBlock<float>(buffer);
-        for (int ch = 0; ch < numChannels; ++ch)
-        {
-            auto sb = block.getSingleChannelBlock(ch);
-            auto ctx = juce::dsp::ProcessContextReplacing<float>(sb);
-            toneFilter[ch].process(ctx);
-            hpFilter[ch].process(ctx);
-        }
+        toneFilter.process(buffer);
+        hpFilter.process(buffer);
     }
 
 private:
-    float applyModel(float x, float driveAmount)
+    // One fully inlined sample loop per model, picked when the model changes
+    using Kernel = void (*)(float* data, int numSamples, float driveAmount, float outputLevel);
+
+    static Kernel getKernel(int m)
     {
-        switch (model)
+        switch (m)
         {
-            case 0: return tubeScreamer(x, driveAmount);
-            case 1: return bluesDriver(x, driveAmount);
-            case 2: return klonCentaur(x, driveAmount);
-            default: return tubeScreamer(x, driveAmount);
+            case 1: return &processModel<1>;
+            case 2: return &processModel<2>;
+            default: return &processModel<0>;
         }
     }
 
-    // Tube Screamer: mid-hump, soft clipping via op-amp + diode
-    float tubeScreamer(float x, float d)
+    template <int Model>
+    static void processModel(float* data, int numSamples, float driveAmount, float outputLevel)
     {
-        x *= d;
-        // Smoother asymmetric clipping curve (tube/op-amp character)
-        if (x > 0.0f)
-            return std::tanh(x * x * 0.1f + x) * 0.8f;
-        else
-            return std::tanh(x * 0.9f) * 0.85f;
+        for (int s = 0; s < numSamples; ++s)
+            data[s] = applyModel<Model>(data[s], driveAmount) * outputLevel;
     }
 
-    // Blues Driver: open, dynamic overdrive
-    float bluesDriver(float x, float d)
+    template <int Model>
+    static float applyModel(float x, float d)
     {
-        x *= d * 1.5f; // More sustain
-        // Smoother asymptotic curve with warmth
-        return (2.0f / juce::MathConstants<float>::pi) * std::atan(x * 2.5f + x * x * 0.1f) * 0.9f;
-    }
-
-    // Klon Centaur: transparent overdrive
-    float klonCentaur(float x, float d)
-    {
-        float clean = x * 0.4f;
-        float driven = std::tanh(x * d * 1.2f) * 0.8f;
-        return clean + driven; // Clean blend
+        if constexpr (Model == 1)
+        {
+            // Blues Driver: open, dynamic overdrive
+            x *= d * 1.5f; // More sustain
+            // Smoother asymptotic curve with warmth
+            return (2.0f / juce::MathConstants<float>::pi) * std::atan(x * 2.5f + x * x * 0.1f) * 0.9f;
+        }
+        else if constexpr (Model == 2)
+        {
+            // Klon Centaur: transparent overdrive
+            float clean = x * 0.4f;
+            float driven = std::tanh(x * d * 1.2f) * 0.8f;
+            return clean + driven; // Clean blend
+        }
+        else
+        {
+            // Tube Screamer: mid-hump, soft clipping via op-amp + diode
+            x *= d;
+            // Smoother asymmetric clipping curve (tube/op-amp character)
+            if (x > 0.0f)
+                return std::tanh(x * x * 0.1f + x) * 0.8f;
+            else
+                return std::tanh(x * 0.9f) * 0.85f;
+        }
     }
 
     double sampleRate = 44100.0;
     int model = 0;
+    Kernel kernel = &processModel<0>;
     float drive = 5.0f, tone = 5.0f, level = 5.0f;
-    juce::dsp::IIR::Filter<float> toneFilter[2]; // Stereo
-    juce::dsp::IIR::Filter<float> hpFilter[2];   // Stereo
+    Biquad toneFilter; // Stereo
+    Biquad hpFilter;   // Stereo
 };
@@ -0,0 +1,260 @@
+#pragma once
+#include <JuceHeader.h>
+
+/**
+ * Oversampler - 2x/4x/8x oversampling wrapped once around the nonlinear
+ * part of the chain.
+ *
+ * Every octave is a polyphase half-band IIR: two parallel chains of
+ * first-order allpasses running at the lower rate, cascaded up and then
+ * back down. Both channels step through each allpass section together so
+ * the inner loop is a two-lane operation. All storage is sized in
+ * prepare(); processUp()/processDown() never allocate.
+ */
+class Oversampler
+{
+public:
+    static constexpr int maxChannels = 2;
+    static constexpr int maxStages = 3; // 8x
+
+    Oversampler()
+    {
+        // First octave needs the steep transition; later ones only guard
+        // the band that is already clean
+        for (int i = 0; i < maxStages; ++i)
+        {
+            const bool first = i == 0;
+            upStages[i].setCoefficients(first ? steepCoefs : wideCoefs, first ? numSteepCoefs : numWideCoefs);
+            downStages[i].setCoefficients(first ? steepCoefs : wideCoefs, first ? numSteepCoefs : numWideCoefs);
+        }
+    }
+
+    void prepare(int maximumBlockSize)
+    {
+        for (auto& b : work)
+            b.setSize(maxChannels, maximumBlockSize << maxStages);
+
+        reset();
+    }
+
+    void reset()
+    {
+        for (int i = 0; i < maxStages; ++i)
+        {
+            upStages[i].reset();
+            downStages[i].reset();
+        }
+    }
+
+    /** Starts channel to from channel from's filter memory, both ways. */
+    void copyChannelState(int from, int to)
+    {
+        for (int i = 0; i < maxStages; ++i)
+        {
+            upStages[i].copyChannelState(from, to);
+            downStages[i].copyChannelState(from, to);
+        }
+    }
+
+    /** 0 = off, 1 = 2x, 2 = 4x, 3 = 8x. */
+    void setNumStages(int stages)
+    {
+        stages = juce::jlimit(0, maxStages, stages);
+        if (stages == numStages)
+            return;
+
+        numStages = stages;
+        reset();
+    }
+
+    int getNumStages() const { return numStages; }
+    int getFactor() const { return 1 << numStages; }
+
+    /** Low-frequency group delay of the up/down round trip, in base-rate samples. */
+    float getLatencyInSamples() const
+    {
+        float latency = 0.0f;
+        for (int i = 0; i < numStages; ++i)
+            latency += 2.0f * upStages[i].getGroupDelay() / (float) (2 << i);
+        return latency;
+    }
+
+    /**
+     * Upsamples into internal storage and returns a buffer at the oversampled
+     * rate. Returns the input itself when oversampling is off.
+     */
+    juce::AudioBuffer<float>& processUp(juce::AudioBuffer<float>& input)
+    {
+        if (numStages == 0)
+            return input;
+
+        const int numChannels = juce::jmin(input.getNumChannels(), maxChannels);
+        int numSamples = input.getNumSamples();
+        jassert((numSamples << maxStages) <= work[0].getNumSamples());
+
+        const float* const* src = input.getArrayOfReadPointers();
+        for (int i = 0; i < numStages; ++i)
+        {
+            auto& dst = work[i & 1];
+            upStages[i].upsample(src, dst.getArrayOfWritePointers(), numChannels, numSamples);
+            src = dst.getArrayOfReadPointers();
+            numSamples *= 2;
+        }
+
+        oversampled.setDataToReferTo(work[(numStages - 1) & 1].getArrayOfWritePointers(), numChannels, numSamples);
+        return oversampled;
+    }
+
+    /** Filters the buffer returned by processUp() back down into output. */
+    void processDown(juce::AudioBuffer<float>& output)
+    {
+        if (numStages == 0)
+            return;
+
+        const int numChannels = oversampled.getNumChannels();
+        int numSamples = oversampled.getNumSamples();
+        float* const* data = oversampled.getArrayOfWritePointers();
+
+        // Decimating in place is safe: sample i is written after 2i and 2i+1 are read
+        for (int i = numStages - 1; i > 0; --i)
+        {
+            numSamples /= 2;
+            downStages[i].downsample(data, data, numChannels, numSamples);
+        }
+
+        downStages[0].downsample(data, output.getArrayOfWritePointers(), numChannels, numSamples / 2);
+    }
+
+private:
+    static constexpr int maxCoefs = 8;
+
+    // Half-band allpass coefficients (elliptic design, de Soras method)
+    // 8 coefs, transition 0.04: ~99 dB rejection, flat to 0.23 fs
+    static constexpr int numSteepCoefs = 8;
+    static constexpr float steepCoefs[numSteepCoefs] = {
+        0.04063346f, 0.15050513f, 0.30075706f, 0.46077450f,
+        0.60952431f, 0.73850384f, 0.84922381f, 0.94974278f
+    };
+    // 4 coefs, transition 0.2: ~100 dB rejection, flat to 0.15 fs
+    static constexpr int numWideCoefs = 4;
+    static constexpr float wideCoefs[numWideCoefs] = {
+        0.04955104f, 0.19357033f, 0.42673669f, 0.76707007f
+    };
+
+    /** One octave: H(z) = (A0(z^2) + z^-1 A1(z^2)) / 2, coefficients alternating between paths. */
+    class HalfBand
+    {
+    public:
+        void setCoefficients(const float* c, int n)
+        {
+            numCoefs = n;
+            for (int i = 0; i < n; ++i)
+                coefs[i] = c[i];
+        }
+
+        void reset()
+        {
+            for (int i = 0; i < maxCoefs; ++i)
+                for (int ch = 0; ch < maxChannels; ++ch)
+                    x[i][ch] = y[i][ch] = 0.0f;
+        }
+
+        void copyChannelState(int from, int to)
+        {
+            for (int i = 0; i < maxCoefs; ++i)
+            {
+                x[i][to] = x[i][from];
+                y[i][to] = y[i][from];
+            }
+        }
+
+        /** Group delay at DC, in samples of the higher rate. */
+        float getGroupDelay() const
+        {
+            float delay = 0.5f; // Average of the paths: A1 carries an extra sample
+            for (int i = 0; i < numCoefs; ++i)
+                delay += (1.0f - coefs[i]) / (1.0f + coefs[i]);
+            return delay;
+        }
+
+        void upsample(const float* const* in, float* const* out, int numChannels, int numSamples)
+        {
+            if (numChannels == 2) upsample<2>(in, out, numSamples);
+            else                  upsample<1>(in, out, numSamples);
+        }
+
+        void downsample(const float* const* in, float* const* out, int numChannels, int numSamples)
+        {
+            if (numChannels == 2) downsample<2>(in, out, numSamples);
+            else                  downsample<1>(in, out, numSamples);
+        }
+
+    private:
+        template <int NumCh>
+        void upsample(const float* const* in, float* const* out, int numSamples)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                float even[NumCh], odd[NumCh];
+                for (int ch = 0; ch < NumCh; ++ch)
+                    even[ch] = odd[ch] = in[ch][i];
+
+                runPaths<NumCh>(even, odd);
+
+                for (int ch = 0; ch < NumCh; ++ch)
+                {
+                    out[ch][2 * i] = even[ch];
+                    out[ch][2 * i + 1] = odd[ch];
+                }
+            }
+        }
+
+        template <int NumCh>
+        void downsample(const float* const* in, float* const* out, int numSamples)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                float path0[NumCh], path1[NumCh];
+                for (int ch = 0; ch < NumCh; ++ch)
+                {
+                    path0[ch] = in[ch][2 * i + 1];
+                    path1[ch] = in[ch][2 * i];
+                }
+
+                runPaths<NumCh>(path0, path1);
+
+                for (int ch = 0; ch < NumCh; ++ch)
+                    out[ch][i] = 0.5f * (path0[ch] + path1[ch]);
+            }
+        }
+
+        /** y[n] = a (x[n] - y[n-1]) + x[n-1] per section, at the lower rate. */
+        template <int NumCh>
+        void runPaths(float* path0, float* path1)
+        {
+            for (int c = 0; c < numCoefs; ++c)
+            {
+                float* s = (c & 1) ? path1 : path0;
+                const float a = coefs[c];
+
+                for (int ch = 0; ch < NumCh; ++ch)
+                {
+                    const float t = (s[ch] - y[c][ch]) * a + x[c][ch];
+                    x[c][ch] = s[ch];
+                    y[c][ch] = t;
+                    s[ch] = t;
+                }
+            }
+        }
+
+        float coefs[maxCoefs] = {};
+        int numCoefs = 0;
+        float x[maxCoefs][maxChannels] = {};
+        float y[maxCoefs][maxChannels] = {};
+    };
+
+    HalfBand upStages[maxStages], downStages[maxStages];
+    juce::AudioBuffer<float> work[2];
+    juce::AudioBuffer<float> oversampled;
+    int numStages = 0;
+};
@@ -1,5 +1,7 @@
 #pragma once
 #include <JuceHeader.h>
+#include "Biquad.h"
+#include "FilterCascade.h"
 
 class ParametricEQ
 {
@@ -10,8 +12,10 @@ public:
     {
         sampleRate = spec.sampleRate;
         for (int i = 0; i < 4; ++i)
-            for (int ch = 0; ch < 2; ++ch)
-                filters[i][ch].reset();
+        {
+            filters[i].prepare(sampleRate);
+            updateBand(i);
+        }
     }
 
     void setBand(int band, float freq, float gainDb, float q)
@@ -21,44 +25,58 @@ public:
         updateBand(band);
     }
 
-    void process(juce::AudioBuffer<float>& buffer)
+    struct BandParams { float freq = 1000.0f, gainDb = 0.0f, q = 1.0f; };
+
+    struct Parameters
     {
-        int numChannels = buffer.getNumChannels();
-        auto block = juce::dsp::AudioBlock<float>(buffer);
+        BandParams bands[4] = {
+            { 100.0f, 0.0f, 1.0f },
+            { 500.0f, 0.0f, 1.0f },
+            { 2000.0f, 0.0f, 1.0f },
+            { 8000.0f, 0.0f, 1.0f }
+        };
+    };
 
+    void setParameters(const Parameters& p)
+    {
+        // Only redesign bands whose values actually moved
         for (int band = 0; band < 4; ++band)
         {
-            for (int ch = 0; ch < numChannels; ++ch)
-            {
-                auto sb = block.getSingleChannelBlock(ch);
-                auto ctx = juce::dsp::ProcessContextReplacing<float>(sb);
-                filters[band][ch].process(ctx);
-            }
+            auto& b = p.bands[band];
+            if (b.freq != bands[band].freq || b.gainDb != bands[band].gainDb || b.q != bands[band].q)
+                setBand(band, b.freq, b.gainDb, b.q);
         }
     }
 
+    void process(juce::AudioBuffer<float>& buffer)
+    {
+        for (int band = 0; band < 4; ++band)
+            filters[band].process(buffer);
+    }
+
+    /** Hands the bands to a fused cascade instead of processing them here. */
+    void appendFilters(FilterCascade& cascade) const
+    {
+        for (auto& f : filters)
+            cascade.add(f);
+    }
+
+    static constexpr int numBands = 4;
+
 private:
     void updateBand(int band)
     {
         auto& b = bands[band];
-        juce::dsp::IIR::Coefficients<float>::Ptr coeffs;
+        float gain = juce::Decibels::decibelsToGain(b.gainDb);
 
         if (band == 0) // Low shelf
-            coeffs = juce::dsp::IIR::Coefficients<float>::makeLowShelf(
-                sampleRate, b.freq, b.q, juce::Decibels::decibelsToGain(b.gainDb));
+            filters[band].setLowShelf(b.freq, b.q, gain);
         else if (band == 3) // High shelf
-            coeffs = juce::dsp::IIR::Coefficients<float>::makeHighShelf(
-                sampleRate, b.freq, b.q, juce::Decibels::decibelsToGain(b.gainDb));
+            filters[band].setHighShelf(b.freq, b.q, gain);
         else // Peak
-            coeffs = juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-                sampleRate, b.freq, b.q, juce::Decibels::decibelsToGain(b.gainDb));
-
-        for (int ch = 0; ch < 2; ++ch)
-            *filters[band][ch].coefficients = *coeffs;
+            filters[band].setPeak(b.freq, b.q, gain);
     }
 
-    struct BandParams { float freq = 1000.0f, gainDb = 0.0f, q = 1.0f; };
-
     double sampleRate = 44100.0;
     BandParams bands[4] = {
         { 100.0f, 0.0f, 1.0f },
@@ -66,5 +84,5 @@ private:
         { 2000.0f, 0.0f, 1.0f },
         { 8000.0f, 0.0f, 1.0f }
     };
-    juce::dsp::IIR::Filter<float> filters[4][2]; // 4 bands x 2 channels
+    Biquad filters[4]; // 4 bands, stereo state each
 };
@@ -0,0 +1,298 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+#include <memory>
+
+/**
+ * PartitionedConvolver - Zero-latency, non-uniformly partitioned convolution.
+ *
+ *   IR [0, 64)       direct-form FIR head (no latency)
+ *   IR [64, 1024)    uniform overlap-save FFT partitions, block 64
+ *   IR [1024, end)   uniform overlap-save FFT partitions, block 1024
+ *
+ * Each FFT stage starts at an IR offset >= its block size, so its inherent
+ * block latency is hidden and results are scheduled into an output ring.
+ * Everything is allocated in the constructor, which is meant to run on a
+ * background thread; process() never allocates.
+ */
+class PartitionedConvolver
+{
+public:
+    static constexpr int maxChannels = 2;
+    static constexpr int headLength = 64;
+
+    /** ir holds one or two channels at the host sample rate; mono IRs feed both channels. */
+    explicit PartitionedConvolver(const juce::AudioBuffer<float>& ir)
+    {
+        irChannels = juce::jlimit(1, maxChannels, ir.getNumChannels());
+        irLength = ir.getNumSamples();
+
+        const int stage1End = juce::jmin(irLength, stage2Start);
+        if (stage1End > headLength)
+            stages.push_back(std::make_unique<Stage>(ir, irChannels, headLength, stage1End - headLength, stage1Block));
+        if (irLength > stage2Start)
+            stages.push_back(std::make_unique<Stage>(ir, irChannels, stage2Start, irLength - stage2Start, stage2Block));
+
+        int maxReach = headLength;
+        for (auto& s : stages)
+            maxReach = juce::jmax(maxReach, s->offset + s->blockSize);
+
+        ringSize = juce::nextPowerOfTwo(maxReach * 2);
+
+        for (int ch = 0; ch < maxChannels; ++ch)
+        {
+            auto& c = channels[ch];
+            const int irCh = juce::jmin(ch, irChannels - 1);
+
+            c.head.assign(headLength, 0.0f);
+            for (int i = 0; i < juce::jmin(headLength, irLength); ++i)
+                c.head[(size_t) i] = ir.getSample(irCh, i);
+
+            // Doubled history so the FIR always reads a contiguous window
+            c.history.assign(headLength * 2, 0.0f);
+            c.ring.assign((size_t) ringSize, 0.0f);
+        }
+    }
+
+    int getIRLength() const { return irLength; }
+    int getNumIRChannels() const { return irChannels; }
+
+    void reset()
+    {
+        for (auto& c : channels)
+        {
+            std::fill(c.history.begin(), c.history.end(), 0.0f);
+            std::fill(c.ring.begin(), c.ring.end(), 0.0f);
+            c.historyPos = 0;
+        }
+
+        for (auto& s : stages)
+            s->reset();
+
+        ringPos = 0;
+    }
+
+    /**
+     * Starts channel to from channel from's input history and scheduled
+     * output. Copies into the existing storage, so it doesn't allocate.
+     */
+    void copyChannelState(int from, int to)
+    {
+        auto& src = channels[from];
+        auto& dst = channels[to];
+        std::copy(src.history.begin(), src.history.end(), dst.history.begin());
+        std::copy(src.ring.begin(), src.ring.end(), dst.ring.begin());
+        dst.historyPos = src.historyPos;
+
+        for (auto& s : stages)
+            s->copyChannelState(from, to);
+    }
+
+    /** Convolves in place. All channels advance together; missing ones are skipped. */
+    void process(juce::AudioBuffer<float>& buffer)
+    {
+        const int numChannels = juce::jmin(buffer.getNumChannels(), maxChannels);
+        const int numSamples = buffer.getNumSamples();
+
+        int done = 0;
+        while (done < numSamples)
+        {
+            // Never cross the smallest block boundary inside a chunk
+            int chunk = numSamples - done;
+            for (auto& s : stages)
+                chunk = juce::jmin(chunk, s->blockSize - s->fill);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto* data = buffer.getWritePointer(ch) + done;
+
+                for (auto& s : stages)
+                    s->write(ch, data, chunk);
+
+                processHead(ch, data, chunk);
+            }
+
+            ringPos = (ringPos + chunk) & (ringSize - 1);
+
+            for (auto& s : stages)
+            {
+                s->fill += chunk;
+                if (s->fill == s->blockSize)
+                {
+                    s->fill = 0;
+
+                    // Block covering [now - B, now) lands at [now - B + offset, now + offset)
+                    const int writeStart = (ringPos + s->offset - s->blockSize) & (ringSize - 1);
+                    for (int ch = 0; ch < numChannels; ++ch)
+                        s->processBlock(ch, channels[ch].ring.data(), ringSize, writeStart);
+                }
+            }
+
+            done += chunk;
+        }
+    }
+
+private:
+    struct ChannelState
+    {
+        std::vector<float> head, history, ring;
+        int historyPos = 0;
+    };
+
+    /** Direct FIR head, then mix in (and clear) the scheduled FFT-stage output. */
+    void processHead(int ch, float* data, int numSamples)
+    {
+        auto& c = channels[ch];
+        const float* h = c.head.data();
+        float* ring = c.ring.data();
+        int pos = ringPos;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            c.historyPos = (c.historyPos == 0 ? headLength : c.historyPos) - 1;
+            c.history[(size_t) c.historyPos] = data[i];
+            c.history[(size_t) (c.historyPos + headLength)] = data[i];
+
+            const float* x = c.history.data() + c.historyPos; // x[0] is the newest sample
+            float y = 0.0f;
+            for (int k = 0; k < headLength; ++k)
+                y += h[k] * x[k];
+
+            data[i] = y + ring[pos];
+            ring[pos] = 0.0f;
+            pos = (pos + 1) & (ringSize - 1);
+        }
+    }
+
+    /** One uniform overlap-save partition set covering IR [offset, offset + length). */
+    struct Stage
+    {
+        Stage(const juce::AudioBuffer<float>& ir, int irChannels, int irOffset, int length, int block)
+            : offset(irOffset),
+              blockSize(block),
+              fftSize(block * 2),
+              numBins(block + 1),
+              numPartitions((length + block - 1) / block),
+              fft(juce::roundToInt(std::log2(block * 2)))
+        {
+            scratch.assign((size_t) fftSize * 2, 0.0f);
+            accum.assign((size_t) numBins * 2, 0.0f);
+
+            for (int ch = 0; ch < maxChannels; ++ch)
+            {
+                auto& c = chans[ch];
+                c.input.assign((size_t) fftSize, 0.0f);
+                c.fdl.assign((size_t) (numPartitions * numBins * 2), 0.0f);
+                c.spectra.assign((size_t) (numPartitions * numBins * 2), 0.0f);
+
+                // Partition spectra: each B-sample slice zero-padded to 2B
+                const int irCh = juce::jmin(ch, irChannels - 1);
+                for (int p = 0; p < numPartitions; ++p)
+                {
+                    std::fill(scratch.begin(), scratch.end(), 0.0f);
+                    for (int i = 0; i < blockSize; ++i)
+                    {
+                        const int src = offset + p * blockSize + i;
+                        if (src < offset + length)
+                            scratch[(size_t) i] = ir.getSample(irCh, src);
+                    }
+
+                    fft.performRealOnlyForwardTransform(scratch.data(), true);
+                    std::copy(scratch.begin(), scratch.begin() + numBins * 2,
+                              c.spectra.begin() + p * numBins * 2);
+                }
+            }
+        }
+
+        void reset()
+        {
+            for (auto& c : chans)
+            {
+                std::fill(c.input.begin(), c.input.end(), 0.0f);
+                std::fill(c.fdl.begin(), c.fdl.end(), 0.0f);
+                c.fdlPos = 0;
+            }
+            fill = 0;
+        }
+
+        void copyChannelState(int from, int to)
+        {
+            std::copy(chans[from].input.begin(), chans[from].input.end(), chans[to].input.begin());
+            std::copy(chans[from].fdl.begin(), chans[from].fdl.end(), chans[to].fdl.begin());
+            chans[to].fdlPos = chans[from].fdlPos;
+        }
+
+        void write(int ch, const float* data, int numSamples)
+        {
+            std::copy(data, data + numSamples, chans[ch].input.begin() + blockSize + fill);
+        }
+
+        void processBlock(int ch, float* ring, int ringSize, int writeStart)
+        {
+            auto& c = chans[ch];
+
+            // Spectrum of [previous block | current block]
+            std::copy(c.input.begin(), c.input.end(), scratch.begin());
+            std::fill(scratch.begin() + fftSize, scratch.end(), 0.0f);
+            fft.performRealOnlyForwardTransform(scratch.data(), true);
+
+            c.fdlPos = (c.fdlPos == 0 ? numPartitions : c.fdlPos) - 1;
+            std::copy(scratch.begin(), scratch.begin() + numBins * 2, c.fdl.begin() + c.fdlPos * numBins * 2);
+
+            // Y = sum_p X[k - p] * H[p]
+            std::fill(accum.begin(), accum.end(), 0.0f);
+            for (int p = 0; p < numPartitions; ++p)
+            {
+                const int slot = (c.fdlPos + p) % numPartitions;
+                const float* x = c.fdl.data() + slot * numBins * 2;
+                const float* h = c.spectra.data() + p * numBins * 2;
+                float* y = accum.data();
+
+                for (int k = 0; k < numBins; ++k)
+                {
+                    const float xr = x[2 * k], xi = x[2 * k + 1];
+                    const float hr = h[2 * k], hi = h[2 * k + 1];
+                    y[2 * k] += xr * hr - xi * hi;
+                    y[2 * k + 1] += xr * hi + xi * hr;
+                }
+            }
+
+            std::copy(accum.begin(), accum.end(), scratch.begin());
+            std::fill(scratch.begin() + numBins * 2, scratch.end(), 0.0f);
+            fft.performRealOnlyInverseTransform(scratch.data());
+
+            // Overlap-save: the last B samples are the valid linear convolution
+            for (int i = 0; i < blockSize; ++i)
+                ring[(writeStart + i) & (ringSize - 1)] += scratch[(size_t) (blockSize + i)];
+
+            // Slide the input window
+            std::copy(c.input.begin() + blockSize, c.input.end(), c.input.begin());
+        }
+
+        struct Chan
+        {
+            std::vector<float> input, fdl, spectra;
+            int fdlPos = 0;
+        };
+
+        const int offset, blockSize, fftSize, numBins, numPartitions;
+        int fill = 0;
+        juce::dsp::FFT fft;
+        std::vector<float> scratch, accum;
+        Chan chans[maxChannels];
+    };
+
+    static constexpr int stage1Block = 64;
+    static constexpr int stage2Start = 1024;
+    static constexpr int stage2Block = 1024;
+
+    int irChannels = 1;
+    int irLength = 0;
+    int ringSize = 0;
+    int ringPos = 0;
+
+    ChannelState channels[maxChannels];
+    std::vector<std::unique_ptr<Stage>> stages;
+
+    JUCE_DECLARE_NON_COPYABLE(PartitionedConvolver)
+};
@@ -1,5 +1,7 @@
 #pragma once
 #include <JuceHeader.h>
+#include "TailSleeper.h"
+#include "ControlRate.h"
 
 class Phaser
 {
@@ -9,19 +11,59 @@ public:
     void prepare(const juce::dsp::ProcessSpec& spec)
     {
         sampleRate = spec.sampleRate;
-        lfoPhase = 0.0f;
+        lfo.prepare(sampleRate);
+        coeffRamp.reset();
 
         for (int i = 0; i < maxStages; ++i)
             for (int ch = 0; ch < 2; ++ch)
                 allpassState[ch][i] = 0.0f;
     }
 
-    void setRate(float r) { rate = r; }
+    void setRate(float r) { rate = r; lfo.setRate(rate); }
     void setDepth(float d) { depth = d; }
     void setFeedback(float fb) { feedback = fb; }
     void setStages(int s) { stages = s; } // 0=4, 1=8, 2=12
     void setMix(float m) { mix = m; }
 
+    struct Parameters
+    {
+        float rate = 0.5f, depth = 0.5f, feedback = 0.5f, mix = 0.5f;
+        int stages = 1; // 0=4, 1=8, 2=12
+    };
+
+    void setParameters(const Parameters& p)
+    {
+        setRate(p.rate);
+        setDepth(p.depth);
+        setFeedback(p.feedback);
+        setStages(p.stages);
+        setMix(p.mix);
+    }
+
+    /**
+     * Ring-down of the allpass chain: each stage's pole is slowest at the
+     * 200 Hz end of the sweep, and the output feedback stretches the whole
+     * chain by 1 / (1 - feedback).
+     */
+    static double getTailSeconds(const Parameters& p, double sampleRate)
+    {
+        const int numStages = p.stages == 0 ? 4 : (p.stages == 2 ? 12 : 8);
+        const double t = std::tan(juce::MathConstants<double>::pi * 200.0 / sampleRate);
+        const float pole = (float) ((1.0 - t) / (1.0 + t));
+
+        const double stageSamples = TailSleeper::getDecayRepeats(pole);
+        const double fb = juce::jlimit(0.0, 0.99, (double) std::abs(p.feedback));
+        return numStages * stageSamples / (1.0 - fb) / sampleRate;
+    }
+
+    /** Starts channel to from channel from's allpass chain and feedback. */
+    void copyChannelState(int from, int to)
+    {
+        for (int i = 0; i < maxStages; ++i)
+            allpassState[to][i] = allpassState[from][i];
+        lastOutput[to] = lastOutput[from];
+    }
+
     void process(juce::AudioBuffer<float>& buffer)
     {
         int numSamples = buffer.getNumSamples();
@@ -37,20 +79,22 @@ public:
 
         for (int s = 0; s < numSamples; ++s)
         {
-            // LFO
-            float lfo = (std::sin(lfoPhase) + 1.0f) * 0.5f; // 0 to 1
-            lfoPhase += 2.0f * juce::MathConstants<float>::pi * rate / (float)sampleRate;
-            if (lfoPhase > 2.0f * juce::MathConstants<float>::pi)
-                lfoPhase -= 2.0f * juce::MathConstants<float>::pi;
+            // LFO and allpass coefficient at control rate, interpolated in between
+            if (coeffRamp.isDue())
+            {
+                lfo.advance();
 
-            // Modulated frequency range for allpass
-            float minFreq = 200.0f;
-            float maxFreq = 4000.0f;
-            float freq = minFreq + lfo * depth * (maxFreq - minFreq);
+                // Modulated frequency range for allpass
+                float minFreq = 200.0f;
+                float maxFreq = 4000.0f;
+                float freq = minFreq + lfo.unipolar() * depth * (maxFreq - minFreq);
+
+                float w = 2.0f * juce::MathConstants<float>::pi * freq / (float)sampleRate;
+                float t = std::tan(w * 0.5f);
+                coeffRamp.rampTo((1.0f - t) / (1.0f + t));
+            }
 
-            // Calculate allpass coefficient
-            float w = 2.0f * juce::MathConstants<float>::pi * freq / (float)sampleRate;
-            float coeff = (1.0f - std::tan(w * 0.5f)) / (1.0f + std::tan(w * 0.5f));
+            float coeff = coeffRamp.next();
 
             for (int ch = 0; ch < numChannels; ++ch)
             {
@@ -79,7 +123,8 @@ private:
     double sampleRate = 44100.0;
     float rate = 0.5f, depth = 0.5f, feedback = 0.5f, mix = 0.5f;
     int stages = 1; // 0=4, 1=8, 2=12
-    float lfoPhase = 0.0f;
+    ControlLfo lfo;
+    ControlRamp coeffRamp;
     float allpassState[2][maxStages] = {};
     float lastOutput[2] = {};
 };
@@ -1,5 +1,6 @@
 #pragma once
 #include <JuceHeader.h>
+#include "Biquad.h"
 
 class PowerAmp
 {
@@ -10,45 +11,53 @@ public:
     {
         sampleRate = spec.sampleRate;
 
-        // Presence filter (high shelf) - one per channel for stereo
-        for (auto& f : presenceFilter)
-        {
-            f.reset();
-            f.coefficients = juce::dsp::IIR::Coefficients<float>::makeHighShelf(
-                sampleRate, 3000.0f, 0.707f, 1.0f);
-        }
+        // Presence filter (high shelf), stereo state
+        presenceFilter.prepare(sampleRate);
+        setPresence(presence);
 
-        // Resonance filter (low shelf) - one per channel for stereo
-        for (auto& f : resonanceFilter)
-        {
-            f.reset();
-            f.coefficients = juce::dsp::IIR::Coefficients<float>::makeLowShelf(
-                sampleRate, 100.0f, 0.707f, 1.0f);
-        }
+        // Resonance filter (low shelf), stereo state
+        resonanceFilter.prepare(sampleRate);
+        setResonance(resonance);
+    }
+
+    void setPresence(float p)
+    {
+        presence = p;
+        presenceFilter.setHighShelf(3000.0f, 0.707f, juce::Decibels::decibelsToGain((presence / 10.0f - 0.5f) * 12.0f));
+    }
+
+    void setResonance(float r)
+    {
+        resonance = r;
+        resonanceFilter.setLowShelf(100.0f, 0.707f, juce::Decibels::decibelsToGain((resonance / 10.0f - 0.5f) * 12.0f));
     }
 
-    void setPresence(float p) { presence = p; }
-    void setResonance(float r) { resonance = r; }
     void setMaster(float m) { master = m; }
 
-    void process(juce::AudioBuffer<float>& buffer)
+    struct Parameters
     {
-        float masterGain = master / 10.0f;
+        float presence = 5.0f;
+        float resonance = 5.0f;
+        float master = 5.0f;
+    };
 
-        // Update presence filter coefficients
-        float presenceGain = juce::Decibels::decibelsToGain((presence / 10.0f - 0.5f) * 12.0f);
-        auto presenceCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighShelf(
-            sampleRate, 3000.0f, 0.707f, presenceGain);
+    void setParameters(const Parameters& p)
+    {
+        setPresence(p.presence);
+        setResonance(p.resonance);
+        setMaster(p.master);
+    }
 
-        // Update resonance filter coefficients
-        float resonanceGain = juce::Decibels::decibelsToGain((resonance / 10.0f - 0.5f) * 12.0f);
-        auto resonanceCoeffs = juce::dsp::IIR::Coefficients<float>::makeLowShelf(
-            sampleRate, 100.0f, 0.707f, resonanceGain);
+    /** Starts channel to from channel from's presence and resonance memory. */
+    void copyChannelState(int from, int to)
+    {
+        presenceFilter.copyChannelState(from, to);
+        resonanceFilter.copyChannelState(from, to);
+    }
 
-        for (auto& f : presenceFilter)
-            *f.coefficients = *presenceCoeffs;
-        for (auto& f : resonanceFilter)
-            *f.coefficients = *resonanceCoeffs;
+    void process(juce::AudioBuffer<float>& buffer)
+    {
+        float masterGain = master / 10.0f;
 
         int numSamples = buffer.getNumSamples();
         int numChannels = buffer.getNumChannels();
@@ -87,14 +96,8 @@ public:
         }
 
         // Apply presence and resonance per channel
-        auto block = juce::dsp::AudioBlock<float>(buffer);
-        for (int ch = 0; ch < numChannels; ++ch)
-        {
-            auto singleBlock = block.getSingleChannelBlock(ch);
-            auto ctx = juce::dsp::ProcessContextReplacing<float>(singleBlock);
-            presenceFilter[ch].process(ctx);
-            resonanceFilter[ch].process(ctx);
-        }
+        presenceFilter.process(buffer);
+        resonanceFilter.process(buffer);
     }
 
 private:
@@ -103,6 +106,6 @@ private:
     float resonance = 5.0f;
     float master = 5.0f;
 
-    juce::dsp::IIR::Filter<float> presenceFilter[2];  // Stereo
-    juce::dsp::IIR::Filter<float> resonanceFilter[2]; // Stereo
+    Biquad presenceFilter;  // Stereo
+    Biquad resonanceFilter; // Stereo
 };
@@ -1,34 +1,87 @@
 #pragma once
 #include <JuceHeader.h>
+#include "Biquad.h"
+#include "WaveshaperTable.h"
+#include "NeuralAmp.h"
+#include <array>
+#include <atomic>
 
 class Preamp
 {
 public:
-    Preamp() = default;
+    Preamp()
+    {
+        getCurves(); // Build the shared tables here, never on the audio thread
+    }
+
+    ~Preamp()
+    {
+        delete pendingCapture.exchange(nullptr);
+        delete retiredCapture.exchange(nullptr);
+        delete activeCapture;
+    }
+
+    static constexpr int neuralModel = 8; // Runs the loaded capture instead of a curve
 
     void prepare(const juce::dsp::ProcessSpec& spec)
     {
         sampleRate = spec.sampleRate;
 
         // Anti-aliasing lowpass before waveshaping (per channel)
-        for (auto& f : antiAlias)
-        {
-            f.reset();
-            f.coefficients = juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, 10000.0f);
-        }
+        antiAlias.prepare(sampleRate);
+        antiAlias.setLowPass(10000.0f);
 
         // High pass to remove DC and hum (per channel)
-        for (auto& db : dcBlocker)
-        {
-            db.reset();
-            db.coefficients = juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 30.0f);
-        }
+        dcBlocker.prepare(sampleRate);
+        dcBlocker.setHighPass(30.0f);
+
+        if (activeCapture != nullptr)
+            activeCapture->prepare(sampleRate);
+    }
+
+    /**
+     * Message thread: reads a neural capture and queues it for the audio
+     * thread, which adopts it at its next block. Returns false if the file
+     * isn't a capture this engine can run.
+     */
+    bool loadCapture(const juce::File& file)
+    {
+        auto capture = NeuralCapture::load(file);
+        if (capture == nullptr)
+            return false;
+
+        delete retiredCapture.exchange(nullptr);
+        delete pendingCapture.exchange(capture.release()); // Drop any unclaimed load
+        return true;
     }
 
     void setModel(int m) { model = m; }
     void setGain(float g) { gain = g; }
     void setChannelVolume(float v) { channelVol = v; }
 
+    struct Parameters
+    {
+        int model = 0;
+        float gain = 5.0f;
+        float channelVolume = 5.0f;
+    };
+
+    void setParameters(const Parameters& p)
+    {
+        setModel(p.model);
+        setGain(p.gain);
+        setChannelVolume(p.channelVolume);
+    }
+
+    /** Starts channel to from channel from's filter and capture state. */
+    void copyChannelState(int from, int to)
+    {
+        antiAlias.copyChannelState(from, to);
+        dcBlocker.copyChannelState(from, to);
+        if (activeCapture != nullptr)
+            activeCapture->copyChannelState(from, to);
+    }
+
     void process(juce::AudioBuffer<float>& buffer)
     {
         int numSamples = buffer.getNumSamples();
@@ -38,144 +91,120 @@ public:
         float preGain = getPreGainForModel();
         float postGain = channelVol / 10.0f;
 
-        auto block = juce::dsp::AudioBlock<float>(buffer);
+        takePendingCapture();
 
-        // Anti-aliasing filter before waveshaping (per channel)
-        for (int ch = 0; ch < numChannels; ++ch)
+        if (model == neuralModel && activeCapture != nullptr)
         {
-            auto singleBlock = block.getSingleChannelBlock(ch);
-            auto ctx = juce::dsp::ProcessContextReplacing<float>(singleBlock);
-            antiAlias[ch].process(ctx);
+            // The capture is the whole preamp, band limiting included
+            buffer.applyGain(preGain);
+            activeCapture->process(buffer);
+            buffer.applyGain(postGain);
+            dcBlocker.process(buffer);
+            return;
         }
 
+        // Anti-aliasing filter before waveshaping (per channel)
+        antiAlias.process(buffer);
+
+        const auto& curve = getCurves()[(size_t) (model >= 0 && model < numModels ? model : 0)];
+
         for (int ch = 0; ch < numChannels; ++ch)
         {
             auto* data = buffer.getWritePointer(ch);
 
-            for (int s = 0; s < numSamples; ++s)
+            if (model == 5)
             {
-                float sample = data[s] * preGain;
-
-                // Apply waveshaper based on model
-                sample = applyWaveshaper(sample);
-
-                // Post gain (channel volume)
-                sample *= postGain;
-
-                data[s] = sample;
+                // Marshall: the gain-dependent part is a cheap rational soft clip
+                float k = 2.0f * gain / 10.0f + 1.0f;
+                for (int s = 0; s < numSamples; ++s)
+                {
+                    float x = data[s] * preGain;
+                    data[s] = (1.0f + k) * x / (1.0f + k * std::abs(x));
+                }
+
+                curve.process(data, numSamples, 1.0f, postGain);
+            }
+            else if (model == 3)
+            {
+                // Metal: hard clip kept out of the table so its corner stays exact
+                curve.process(data, numSamples, preGain, 1.0f);
+                juce::FloatVectorOperations::clip(data, data, -0.95f, 0.95f, numSamples);
+                juce::FloatVectorOperations::multiply(data, postGain, numSamples);
+            }
+            else
+            {
+                curve.process(data, numSamples, preGain, postGain);
             }
         }
 
         // DC blocker after waveshaping (per channel)
-        for (int ch = 0; ch < numChannels; ++ch)
-        {
-            auto singleBlock = block.getSingleChannelBlock(ch);
-            auto ctx = juce::dsp::ProcessContextReplacing<float>(singleBlock);
-            dcBlocker[ch].process(ctx);
-        }
+        dcBlocker.process(buffer);
     }
 
 private:
-    float applyWaveshaper(float x)
-    {
-        switch (model)
-        {
-            case 0: // Clean
-                return cleanWaveshaper(x);
-            case 1: // Crunch
-                return crunchWaveshaper(x);
-            case 2: // High Gain
-                return highGainWaveshaper(x);
-            case 3: // Metal
-                return metalWaveshaper(x);
-            case 4: // Fender Twin
-                return fenderWaveshaper(x);
-            case 5: // Marshall JCM
-                return marshallWaveshaper(x);
-            case 6: // Mesa Rectifier
-                return mesaWaveshaper(x);
-            case 7: // Soldano Lead
-                return soldanoWaveshaper(x);
-            default:
-                return cleanWaveshaper(x);
-        }
-    }
+    static constexpr int numModels = 8; // Curves; the neural model falls back to Clean until a capture loads
 
-    // Clean: soft saturation (12AX7 preamp tube sim)
-    float cleanWaveshaper(float x)
+    /** Audio thread: swaps in a newly loaded capture once the last one has been collected. */
+    void takePendingCapture()
     {
-        // Asymmetric soft clip (tube-like)
-        if (x > 0.0f)
-            return std::tanh(x * 0.8f);
-        else
-            return std::tanh(x * 0.9f) * 0.95f;
-    }
+        if (pendingCapture.load() == nullptr)
+            return;
 
-    // Crunch: moderate clipping
-    float crunchWaveshaper(float x)
-    {
-        float asymmetry = 0.1f;
-        x += asymmetry;
-        float out = (2.0f / juce::MathConstants<float>::pi) * std::atan(x * 2.5f);
-        return out - asymmetry * 0.5f;
-    }
+        NeuralCapture* expected = nullptr;
+        if (activeCapture != nullptr && ! retiredCapture.compare_exchange_strong(expected, activeCapture))
+            return;
 
-    // High Gain: aggressive tube saturation
-    float highGainWaveshaper(float x)
-    {
-        // Multi-stage clipping
-        float stage1 = std::tanh(x * 3.0f);
-        float stage2 = std::tanh(stage1 * 2.0f);
-        return stage2 * 0.9f;
+        activeCapture = pendingCapture.exchange(nullptr);
+        activeCapture->prepare(sampleRate);
     }
 
-    // Metal: extreme saturation with tight response
-    float metalWaveshaper(float x)
+    /** Per-model transfer curves, shared by every instance. */
+    static const std::array<WaveshaperTable, numModels>& getCurves()
     {
-        // Hard clip with tube warmth
-        float stage1 = std::tanh(x * 5.0f);
-        float stage2 = std::tanh(stage1 * 3.0f);
-        float hardClip = juce::jlimit(-0.95f, 0.95f, stage2);
-        return hardClip;
-    }
+        static const std::array<WaveshaperTable, numModels> curves {
+            // Clean: soft saturation (12AX7 preamp tube sim), asymmetric
+            WaveshaperTable([](double x) { return x > 0.0 ? std::tanh(x * 0.8) : std::tanh(x * 0.9) * 0.95; }),
 
-    // Fender Twin: warm, bright clean
-    float fenderWaveshaper(float x)
-    {
-        // Soft asymmetric clipping (12AX7 + 6L6 character)
-        if (x >= 0.0f)
-            return (1.0f - std::exp(-x * 1.5f)) * 0.85f;
-        else
-            return -(1.0f - std::exp(x * 1.2f)) * 0.9f;
-    }
+            // Crunch: moderate clipping
+            WaveshaperTable([](double x)
+            {
+                double asymmetry = 0.1;
+                return (2.0 / juce::MathConstants<double>::pi) * std::atan((x + asymmetry) * 2.5) - asymmetry * 0.5;
+            }),
 
-    // Marshall JCM: EL34 crunch
-    float marshallWaveshaper(float x)
-    {
-        float k = 2.0f * gain / 10.0f + 1.0f;
-        float out = (1.0f + k) * x / (1.0f + k * std::abs(x));
-        return std::tanh(out * 1.5f);
-    }
+            // High Gain: aggressive multi-stage tube saturation
+            WaveshaperTable([](double x) { return std::tanh(std::tanh(x * 3.0) * 2.0) * 0.9; }),
 
-    // Mesa Rectifier: heavy saturation
-    float mesaWaveshaper(float x)
-    {
-        // Cascaded gain stages with asymmetric clipping
-        float s1 = std::tanh(x * 4.0f);
-        float s2 = (2.0f / juce::MathConstants<float>::pi) * std::atan(s1 * 3.0f);
-        float s3 = std::tanh(s2 * 2.5f);
-        return s3 * 0.85f;
-    }
+            // Metal: extreme saturation with tight response (hard clip applied after)
+            WaveshaperTable([](double x) { return std::tanh(std::tanh(x * 5.0) * 3.0); }),
 
-    // Soldano Lead: smooth, articulate high gain with massive sustain
-    float soldanoWaveshaper(float x)
-    {
-        // Smooth multi-stage cascaded clipping
-        float s1 = std::tanh(x * 4.5f);
-        // Slightly asymmetric for tube warmth, very smooth transition
-        float s2 = (s1 > 0) ? std::tanh(s1 * 2.5f) : std::tanh(s1 * 2.2f);
-        float s3 = std::tanh(s2 * 3.0f);
-        return s3 * 0.9f;
+            // Fender Twin: warm, bright clean (12AX7 + 6L6 character)
+            WaveshaperTable([](double x)
+            {
+                return x >= 0.0 ? (1.0 - std::exp(-x * 1.5)) * 0.85 : -(1.0 - std::exp(x * 1.2)) * 0.9;
+            }),
+
+            // Marshall JCM: EL34 crunch, after the gain-dependent rational stage
+            WaveshaperTable([](double x) { return std::tanh(x * 1.5); }),
+
+            // Mesa Rectifier: cascaded gain stages
+            WaveshaperTable([](double x)
+            {
+                double s1 = std::tanh(x * 4.0);
+                double s2 = (2.0 / juce::MathConstants<double>::pi) * std::atan(s1 * 3.0);
+                return std::tanh(s2 * 2.5) * 0.85;
+            }),
+
+            // Soldano Lead: smooth, slightly asymmetric cascade with massive sustain
+            WaveshaperTable([](double x)
+            {
+                double s1 = std::tanh(x * 4.5);
+                double s2 = s1 > 0.0 ? std::tanh(s1 * 2.5) : std::tanh(s1 * 2.2);
+                return std::tanh(s2 * 3.0) * 0.9;
+            })
+        };
+
+        return curves;
     }
 
     float getPreGainForModel()
@@ -191,6 +220,7 @@ private:
             case 5: return 1.5f + normalized * 6.0f;        // Marshall
             case 6: return 2.5f + normalized * 12.0f;       // Mesa
             case 7: return 3.0f + normalized * 14.0f;       // Soldano (massive gain)
+            case 8: return juce::Decibels::decibelsToGain((normalized - 0.5f) * 24.0f); // Capture: +-12 dB around unity
             default: return 1.0f + normalized * 3.0f;
         }
     }
@@ -200,6 +230,11 @@ private:
     float gain = 5.0f;
     float channelVol = 5.0f;
 
-    juce::dsp::IIR::Filter<float> antiAlias[2];  // Stereo anti-aliasing
-    juce::dsp::IIR::Filter<float> dcBlocker[2];  // Stereo DC blockers
+    Biquad antiAlias; // Stereo anti-aliasing
+    Biquad dcBlocker; // Stereo DC blocker
+
+    // Message thread -> audio (new capture) and audio -> message (old capture to delete)
+    std::atomic<NeuralCapture*> pendingCapture { nullptr };
+    std::atomic<NeuralCapture*> retiredCapture { nullptr };
+    NeuralCapture* activeCapture = nullptr; // Audio-thread owned
 };
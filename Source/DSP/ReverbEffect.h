@@ -1,5 +1,7 @@
 #pragma once
 #include <JuceHeader.h>
+#include "DelayLine.h"
+#include "FDNReverb.h"
 
 class ReverbEffect
 {
@@ -9,138 +11,110 @@ public:
     void prepare(const juce::dsp::ProcessSpec& spec)
     {
         sampleRate = spec.sampleRate;
-        juce::dsp::ProcessSpec monoSpec = spec;
-        monoSpec.numChannels = 1;
+        maxBlockSize = juce::jmax(1, (int) spec.maximumBlockSize);
 
-        reverb.reset();
-        reverb.setSampleRate(sampleRate);
+        fdn.prepare(sampleRate);
+        wetBuffer.setSize(2, maxBlockSize);
 
-        // Pre-delay buffers
+        // Pre-delay on the reverb send only
         int maxPreDelay = static_cast<int>(sampleRate * 0.3); // max 300ms
-        preDelayBufL.resize(maxPreDelay, 0.0f);
-        preDelayBufR.resize(maxPreDelay, 0.0f);
-        preDelayWritePos = 0;
+        preDelayLine.prepare(1, maxPreDelay, maxBlockSize);
+        setPreDelay(preDelayMs);
     }
 
-    void setModel(int m) { model = m; }
-    void setSize(float s) { roomSize = s; }
-    void setDamping(float d) { damping = d; }
-    void setPreDelay(float ms) { preDelayMs = ms; }
+    /** Drops the tail without reallocating (audio thread safe). */
+    void reset()
+    {
+        fdn.reset();
+        preDelayLine.reset();
+    }
+
+    void setModel(int m) { model = m; fdn.setParameters(model, roomSize, damping); }
+    void setSize(float s) { roomSize = s; fdn.setParameters(model, roomSize, damping); }
+    void setDamping(float d) { damping = d; fdn.setParameters(model, roomSize, damping); }
+
+    void setPreDelay(float ms)
+    {
+        preDelayMs = ms;
+        preDelaySamples = juce::jlimit(0, preDelayLine.getMaxDelay(), static_cast<int>((preDelayMs / 1000.0f) * sampleRate));
+    }
     void setMix(float m) { mix = m; }
 
+    struct Parameters
+    {
+        int model = 0;
+        float size = 0.5f;
+        float damping = 0.5f;
+        float preDelayMs = 20.0f;
+        float mix = 0.3f;
+    };
+
+    void setParameters(const Parameters& p)
+    {
+        model = p.model;
+        roomSize = p.size;
+        setDamping(p.damping); // One FDN update for all three
+        setPreDelay(p.preDelayMs);
+        setMix(p.mix);
+    }
+
+    static double getTailSeconds(const Parameters& p, double)
+    {
+        return juce::jlimit(0.0f, 300.0f, p.preDelayMs) * 0.001 + FDNReverb::getTailSeconds(p.model, p.size);
+    }
+
     void process(juce::AudioBuffer<float>& buffer)
     {
-        // Configure reverb based on model
-        juce::Reverb::Parameters params;
+        const int numSamples = buffer.getNumSamples();
+        for (int start = 0; start < numSamples; start += maxBlockSize)
+            processChunk(buffer, start, juce::jmin(maxBlockSize, numSamples - start));
+    }
 
-        switch (model)
+private:
+    void processChunk(juce::AudioBuffer<float>& buffer, int start, int numSamples)
+    {
+        const int numChannels = juce::jmin(buffer.getNumChannels(), 2);
+        float* dataL = buffer.getWritePointer(0, start);
+        float* dataR = numChannels > 1 ? buffer.getWritePointer(1, start) : nullptr;
+        float* wetL = wetBuffer.getWritePointer(0);
+        float* wetR = wetBuffer.getWritePointer(1);
+
+        // Mono send, delayed by the pre-delay
+        if (dataR != nullptr)
         {
-            case 0: // Hall
-                params.roomSize = 0.3f + roomSize * 0.7f;
-                params.damping = damping * 0.6f;
-                params.width = 1.0f;
-                params.wetLevel = mix;
-                params.dryLevel = 1.0f - mix;
-                params.freezeMode = 0.0f;
-                break;
-
-            case 1: // Room
-                params.roomSize = 0.1f + roomSize * 0.4f;
-                params.damping = 0.3f + damping * 0.5f;
-                params.width = 0.7f;
-                params.wetLevel = mix;
-                params.dryLevel = 1.0f - mix;
-                params.freezeMode = 0.0f;
-                break;
-
-            case 2: // Plate
-                params.roomSize = 0.4f + roomSize * 0.5f;
-                params.damping = damping * 0.3f;
-                params.width = 1.0f;
-                params.wetLevel = mix;
-                params.dryLevel = 1.0f - mix;
-                params.freezeMode = 0.0f;
-                break;
-
-            case 3: // Spring
-                params.roomSize = 0.2f + roomSize * 0.3f;
-                params.damping = 0.4f + damping * 0.4f;
-                params.width = 0.5f;
-                params.wetLevel = mix * 1.2f;
-                params.dryLevel = 1.0f - mix;
-                params.freezeMode = 0.0f;
-                break;
-
-            case 4: // Cathedral
-                params.roomSize = 0.6f + roomSize * 0.4f;
-                params.damping = damping * 0.2f;
-                params.width = 1.0f;
-                params.wetLevel = mix;
-                params.dryLevel = 1.0f - mix;
-                params.freezeMode = 0.0f;
-                break;
-
-            default:
-                params.roomSize = 0.5f;
-                params.damping = 0.5f;
-                params.width = 1.0f;
-                params.wetLevel = mix;
-                params.dryLevel = 1.0f - mix;
-                params.freezeMode = 0.0f;
-                break;
+            for (int s = 0; s < numSamples; ++s)
+                wetL[s] = (dataL[s] + dataR[s]) * 0.5f;
         }
-
-        reverb.setParameters(params);
-
-        // Apply pre-delay
-        if (preDelayMs > 0.0f)
+        else
         {
-            int preDelaySamples = static_cast<int>((preDelayMs / 1000.0f) * sampleRate);
-            preDelaySamples = juce::jmin(preDelaySamples, (int)preDelayBufL.size() - 1);
-            applyPreDelay(buffer, preDelaySamples);
+            std::copy(dataL, dataL + numSamples, wetL);
         }
 
-        // Process reverb
-        if (buffer.getNumChannels() >= 2)
-            reverb.processStereo(buffer.getWritePointer(0), buffer.getWritePointer(1), buffer.getNumSamples());
-        else
-            reverb.processMono(buffer.getWritePointer(0), buffer.getNumSamples());
-    }
+        preDelayLine.writeBlock(0, wetL, numSamples);
+        preDelayLine.readBlock(0, wetL, numSamples, preDelaySamples);
+        preDelayLine.advance(numSamples);
 
-private:
-    void applyPreDelay(juce::AudioBuffer<float>& buffer, int delaySamples)
-    {
-        int numSamples = buffer.getNumSamples();
-        int numChannels = buffer.getNumChannels();
-        int maxDelay = (int)preDelayBufL.size();
+        fdn.process(wetL, wetL, dataR != nullptr ? wetR : nullptr, numSamples);
 
+        const float dryLevel = 1.0f - mix;
         for (int s = 0; s < numSamples; ++s)
-        {
-            int readPos = (preDelayWritePos - delaySamples + maxDelay) % maxDelay;
+            dataL[s] = dataL[s] * dryLevel + wetL[s] * mix;
 
-            float inputL = buffer.getSample(0, s);
-            buffer.setSample(0, s, preDelayBufL[readPos]);
-            preDelayBufL[preDelayWritePos] = inputL;
-
-            if (numChannels > 1)
-            {
-                float inputR = buffer.getSample(1, s);
-                buffer.setSample(1, s, preDelayBufR[readPos]);
-                preDelayBufR[preDelayWritePos] = inputR;
-            }
-
-            preDelayWritePos = (preDelayWritePos + 1) % maxDelay;
-        }
+        if (dataR != nullptr)
+            for (int s = 0; s < numSamples; ++s)
+                dataR[s] = dataR[s] * dryLevel + wetR[s] * mix;
     }
 
     double sampleRate = 44100.0;
+    int maxBlockSize = 512;
     int model = 0;
     float roomSize = 0.5f;
     float damping = 0.5f;
     float preDelayMs = 20.0f;
     float mix = 0.3f;
+    int preDelaySamples = 0;
 
-    juce::Reverb reverb;
-    std::vector<float> preDelayBufL, preDelayBufR;
-    int preDelayWritePos = 0;
+    FDNReverb fdn;
+    juce::AudioBuffer<float> wetBuffer;
+    DelayLine preDelayLine;
 };
@@ -0,0 +1,84 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * Seqlock - Single-writer / multi-reader snapshot of a small POD struct.
+ *
+ * The writer never blocks and never allocates, so it can live on the audio
+ * thread or a worker thread. Readers retry until they see a consistent copy.
+ * The payload is held as relaxed atomic words so torn reads are detected by
+ * the sequence counter rather than being undefined behaviour. Words are
+ * copied straight from and into the caller's object, with no staging copy
+ * on the stack, so the payload can be a few tens of kilobytes.
+ */
+template <typename T>
+class Seqlock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock payload must be trivially copyable");
+
+public:
+    Seqlock() { store(T{}); }
+
+    /** Single writer only. */
+    void store(const T& value) noexcept
+    {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(&value);
+
+        const auto seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed); // Odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (int i = 0; i < numWords; ++i)
+        {
+            std::uint32_t word = 0;
+            std::memcpy(&word, bytes + i * wordSize, getWordBytes(i));
+            words[i].store(word, std::memory_order_relaxed);
+        }
+
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    T load() const noexcept
+    {
+        T result;
+        load(result);
+        return result;
+    }
+
+    /** Reads into result, which holds garbage until the copy turns out consistent. */
+    void load(T& result) const noexcept
+    {
+        auto* bytes = reinterpret_cast<unsigned char*>(&result);
+
+        for (;;)
+        {
+            const auto before = sequence.load(std::memory_order_acquire);
+            if ((before & 1u) != 0)
+                continue;
+
+            for (int i = 0; i < numWords; ++i)
+            {
+                const auto word = words[i].load(std::memory_order_relaxed);
+                std::memcpy(bytes + i * wordSize, &word, getWordBytes(i));
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before)
+                return;
+        }
+    }
+
+private:
+    static constexpr int wordSize = (int) sizeof(std::uint32_t);
+    static constexpr int numWords = (int) ((sizeof(T) + wordSize - 1) / wordSize);
+
+    // The last word may only be partly inside T
+    static constexpr size_t getWordBytes(int i) { return (size_t) std::min(wordSize, (int) sizeof(T) - i * wordSize); }
+
+    std::atomic<std::uint32_t> sequence { 0 };
+    std::atomic<std::uint32_t> words[numWords];
+};
@@ -0,0 +1,279 @@
+#pragma once
+#include <JuceHeader.h>
+#include "Seqlock.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <memory>
+
+// Per-stage CPU profiling of processBlock. Off by default; build with
+// JAGATFX_PROFILER=1 to compile the timers, the overlay and the dump action in.
+#ifndef JAGATFX_PROFILER
+ #define JAGATFX_PROFILER 0
+#endif
+
+/**
+ * StageProfiler - Rolling timings for each stage of the processing chain.
+ *
+ * The audio thread times every stage that runs with steady_clock and keeps
+ * the last windowSize blocks per stage. A few times a second it publishes
+ * those raw windows through a Seqlock; readers take a consistent copy
+ * without locking and reduce it to min / mean / p99 / max on their own
+ * thread, so the audio thread never sorts. A block's timings are committed
+ * at the start of the next block, so the total stage's scope can close
+ * after everything else.
+ */
+class StageProfiler
+{
+    using clock = std::chrono::steady_clock;
+
+public:
+    enum Stage
+    {
+        tuner, gate, comp, oversampleUp, overdrive, distortion, highGain,
+        preamp, toneStack, powerAmp, oversampleDown, cabinetEQ,
+        talkBox, autoWah, chorus, flanger, phaser, harmonizer, stringSynth, delay, reverb,
+        total,
+        numStages
+    };
+
+    static const char* getStageName(Stage s)
+    {
+        static const char* const names[numStages] = {
+            "Tuner", "Noise Gate", "Compressor", "Oversample Up", "Overdrive", "Distortion", "High Gain",
+            "Preamp", "Tone Stack", "Power Amp", "Oversample Down", "Cabinet + EQ",
+            "Talk Box", "Auto Wah", "Chorus", "Flanger", "Phaser", "Harmonizer", "String Synth", "Delay", "Reverb",
+            "Total"
+        };
+        return names[s];
+    }
+
+    static constexpr int windowSize = 1024; // blocks per stage
+
+    struct StageStats
+    {
+        float minNs = 0.0f, meanNs = 0.0f, p99Ns = 0.0f, maxNs = 0.0f;
+        int blocks = 0;       // Samples in the window
+        bool active = false;  // Ran since the previous publish
+    };
+
+    struct Snapshot
+    {
+        std::array<StageStats, numStages> stages {};
+        double sampleRate = 0.0;
+        int blockSize = 0;
+        double budgetNs = 0.0; // One block's worth of real time
+        juce::uint32 publishCount = 0;
+
+        float percentOfBudget(float ns) const { return budgetNs > 0.0 ? (float) (100.0 * ns / budgetNs) : 0.0f; }
+    };
+
+    /** Times one stage for the lifetime of the scope; a null profiler times nothing. */
+    class ScopedStage
+    {
+    public:
+        ScopedStage(StageProfiler& p, Stage s) : ScopedStage(&p, s) {}
+        ScopedStage(StageProfiler* p, Stage s) : profiler(p), stage(s), start(clock::now()) {}
+
+        ~ScopedStage()
+        {
+            if (profiler != nullptr)
+                profiler->record(stage, std::chrono::duration<float, std::nano>(clock::now() - start).count());
+        }
+
+    private:
+        StageProfiler* profiler;
+        Stage stage;
+        clock::time_point start;
+    };
+
+    //==========================================================================
+    // Audio thread
+
+    /** First thing in processBlock, before any ScopedStage. */
+    void beginBlock(int numSamples, double sampleRate)
+    {
+        commitPendingBlock();
+
+        if (sampleRate != currentRate)
+        {
+            currentRate = sampleRate;
+            reset(); // Old timings were for a different rate
+        }
+
+        // Hosts may vary the block size; the budget follows the latest one
+        blockSize = numSamples;
+
+        // Publish about four times a second
+        if (++blocksSincePublish >= juce::jmax(1, (int) (0.25 * sampleRate / juce::jmax(1, numSamples))))
+            publish();
+    }
+
+    /** Publishes everything recorded so far and returns its statistics; call
+        once the audio thread has stopped (e.g. at the end of an offline render). */
+    Snapshot summarize()
+    {
+        commitPendingBlock();
+        publish();
+        return getSnapshot();
+    }
+
+    void reset()
+    {
+        for (auto& r : window.rings)
+            r.count = r.writePos = 0;
+        window.active.fill(false);
+        pending.fill(-1.0f);
+        blocksSincePublish = 0;
+    }
+
+    //==========================================================================
+    // Any thread but the audio thread: copies and sorts the published windows
+
+    Snapshot getSnapshot() const
+    {
+        auto raw = std::make_unique<Window>();
+        published.load(*raw);
+        return reduce(*raw);
+    }
+
+    /** Plain-text table of a snapshot, for the dump-to-file action. */
+    static juce::String formatReport(const Snapshot& s)
+    {
+        juce::String report;
+        report << "Sample rate " << s.sampleRate << " Hz, block " << s.blockSize << " samples, budget "
+               << juce::String(s.budgetNs / 1000.0, 1) << " us per block\n\n";
+        report << juce::String("Stage").paddedRight(' ', 18)
+               << juce::String("Min ns").paddedLeft(' ', 10) << juce::String("Mean ns").paddedLeft(' ', 10)
+               << juce::String("P99 ns").paddedLeft(' ', 10) << juce::String("Max ns").paddedLeft(' ', 10)
+               << juce::String("Mean %").paddedLeft(' ', 9) << juce::String("P99 %").paddedLeft(' ', 9)
+               << juce::String("Blocks").paddedLeft(' ', 8) << "\n";
+
+        for (int i = 0; i < numStages; ++i)
+        {
+            const auto& st = s.stages[(size_t) i];
+            report << juce::String(getStageName((Stage) i)).paddedRight(' ', 18)
+                   << juce::String(st.minNs, 0).paddedLeft(' ', 10) << juce::String(st.meanNs, 0).paddedLeft(' ', 10)
+                   << juce::String(st.p99Ns, 0).paddedLeft(' ', 10) << juce::String(st.maxNs, 0).paddedLeft(' ', 10)
+                   << juce::String(s.percentOfBudget(st.meanNs), 2).paddedLeft(' ', 9)
+                   << juce::String(s.percentOfBudget(st.p99Ns), 2).paddedLeft(' ', 9)
+                   << juce::String(st.blocks).paddedLeft(' ', 8) << (st.active ? "" : "  (idle)") << "\n";
+        }
+
+        return report;
+    }
+
+private:
+    struct Ring
+    {
+        std::array<float, windowSize> ns {};
+        int count = 0, writePos = 0;
+    };
+
+    /** What the audio thread publishes: the raw timings, nothing derived. */
+    struct Window
+    {
+        std::array<Ring, numStages> rings {};
+        std::array<bool, numStages> active {}; // Ran since the previous publish
+        double sampleRate = 0.0;
+        int blockSize = 0;
+        juce::uint32 publishCount = 0;
+    };
+
+    // A stage that runs more than once in a block (in each engine during a
+    // preset crossfade) counts its total time
+    void record(Stage s, float ns)
+    {
+        auto& p = pending[(size_t) s];
+        p = p < 0.0f ? ns : p + ns;
+    }
+
+    void commitPendingBlock()
+    {
+        for (size_t i = 0; i < (size_t) numStages; ++i)
+        {
+            if (pending[i] < 0.0f)
+                continue;
+
+            auto& r = window.rings[i];
+            r.ns[(size_t) r.writePos] = pending[i];
+            r.writePos = (r.writePos + 1) % windowSize;
+            r.count = juce::jmin(r.count + 1, windowSize);
+
+            window.active[i] = true;
+            pending[i] = -1.0f;
+        }
+    }
+
+    void publish()
+    {
+        window.sampleRate = currentRate;
+        window.blockSize = blockSize;
+        window.publishCount = ++publishCount;
+        published.store(window);
+
+        window.active.fill(false);
+        blocksSincePublish = 0;
+    }
+
+    static Snapshot reduce(const Window& w)
+    {
+        Snapshot s;
+        s.sampleRate = w.sampleRate;
+        s.blockSize = w.blockSize;
+        s.budgetNs = w.sampleRate > 0.0 ? 1.0e9 * w.blockSize / w.sampleRate : 0.0;
+        s.publishCount = w.publishCount;
+
+        std::array<float, windowSize> scratch;
+
+        for (size_t i = 0; i < (size_t) numStages; ++i)
+        {
+            const auto& r = w.rings[i];
+            auto& st = s.stages[i];
+            st.blocks = r.count;
+            st.active = w.active[i];
+
+            if (r.count == 0)
+                continue;
+
+            std::copy(r.ns.begin(), r.ns.begin() + r.count, scratch.begin());
+            const auto [lo, hi] = std::minmax_element(scratch.begin(), scratch.begin() + r.count);
+            st.minNs = *lo;
+            st.maxNs = *hi;
+
+            double sum = 0.0;
+            for (int n = 0; n < r.count; ++n)
+                sum += scratch[(size_t) n];
+            st.meanNs = (float) (sum / r.count);
+
+            const auto p99 = scratch.begin() + (r.count - 1) * 99 / 100;
+            std::nth_element(scratch.begin(), p99, scratch.begin() + r.count);
+            st.p99Ns = *p99;
+        }
+
+        return s;
+    }
+
+    Window window; // Audio thread
+    std::array<float, numStages> pending = makeFilled(-1.0f); // -1: didn't run this block
+
+    int blockSize = 0;
+    double currentRate = 0.0;
+    int blocksSincePublish = 0;
+    juce::uint32 publishCount = 0;
+
+    Seqlock<Window> published;
+
+    static std::array<float, numStages> makeFilled(float v)
+    {
+        std::array<float, numStages> a;
+        a.fill(v);
+        return a;
+    }
+};
+
+#if JAGATFX_PROFILER
+ #define JAGATFX_PROFILE_STAGE(stage) StageProfiler::ScopedStage profileScope_##stage (profiler, StageProfiler::stage)
+#else
+ #define JAGATFX_PROFILE_STAGE(stage)
+#endif
@@ -1,5 +1,9 @@
 #pragma once
 #include <JuceHeader.h>
+#include "DelayLine.h"
+#include "TailSleeper.h"
+#include "ControlRate.h"
+#include "LevelDetector.h"
 
 /**
  * StringSynth - Mengubah sinyal gitar menjadi suara mirip organ/harmonika.
@@ -15,98 +19,137 @@ public:
         sampleRate = spec.sampleRate;
         
         // Pitch shifter buffer
-        int bufSize = static_cast<int>(sampleRate * 0.3); 
-        grainBuffer.resize(bufSize, 0.0f);
-        writePos = 0;
-        
-        for (int i = 0; i < 4; ++i) 
+        grainPeriod = static_cast<int>(sampleRate * 0.3);
+        grainLine.prepare(1, grainPeriod + 1, 1);
+
+        for (int i = 0; i < numLayers; ++i)
         {
-            readPos[i] = 0.0f;
-            readPosDetune[i] = 0.5f; 
+            tapDelays[i] = 0.0f;
+            tapDelays[numLayers + i] = (float)grainPeriod - 0.5f; // Detuned heads start half a sample ahead
         }
 
         // Modulation states
-        lfoPhase1 = 0.0f;
-        lfoPhase2 = 0.0f;
+        ensembleLfo.setRate(0.5f);
+        ensembleLfo.prepare(sampleRate);
+        vibratoLfo.setRate(6.0f);
+        vibratoLfo.prepare(sampleRate);
+        modRamp.reset();
         
         for (int i = 0; i < 4; ++i) filterState[i] = 0.0f;
         
-        envelope = 0.0f;
+        sidechain.prepare((int) spec.maximumBlockSize, sampleRate);
+        follower.reset();
         random.setSeed(42);
         pitchScoop = 0.0f;
+
+        setAttack(attackTime);
     }
 
-    void setAttack(float attackMs) { attackTime = juce::jmax(10.0f, attackMs); }
+    void setAttack(float attackMs)
+    {
+        attackTime = juce::jmax(10.0f, attackMs);
+        attackAlpha = (float) (1.0f / (attackTime * sampleRate * 0.001f + 1.0f));
+        follower.setCoefficients(1.0f - attackAlpha, 1.0f - releaseAlpha);
+    }
     void setOctaveMix(float mix) { octaveMix = mix; } 
     void setBrightness(float freq) { brightness = freq; }
     void setResonance(float res) { resonance = juce::jlimit(0.0f, 0.95f, res); }
     void setMix(float m) { mix = m; }
 
+    struct Parameters
+    {
+        float attackMs = 150.0f;
+        float octaveMix = 0.5f;
+        float brightness = 2000.0f;
+        float resonance = 0.5f;
+        float mix = 0.5f;
+    };
+
+    void setParameters(const Parameters& p)
+    {
+        setAttack(p.attackMs);
+        setOctaveMix(p.octaveMix);
+        setBrightness(p.brightness);
+        setResonance(p.resonance);
+        setMix(p.mix);
+    }
+
+    /**
+     * The filtered synth is scaled by the envelope, so it is silent once the
+     * release falls from full scale below threshold; the grain line adds one
+     * period on top.
+     */
+    static double getTailSeconds(const Parameters&, double sampleRate)
+    {
+        return 0.3 + TailSleeper::getDecayRepeats(1.0f - releaseAlpha) / sampleRate;
+    }
+
     void process(juce::AudioBuffer<float>& buffer)
     {
         int numSamples = buffer.getNumSamples();
         int numChannels = buffer.getNumChannels();
-        int bufSize = (int)grainBuffer.size();
+        float* const* data = buffer.getArrayOfWritePointers();
+        float period = (float)grainPeriod;
+
+        // The synth follows the first channel only
+        sidechain.rectify(buffer, 1);
+        const float* level = sidechain.getRectified();
 
         for (int s = 0; s < numSamples; ++s)
         {
-            float input = buffer.getSample(0, s);
+            float input = data[0][s];
             
             // 1. Envelope Follower & Pitch Scoop
-            float absIn = std::abs(input);
-            float attackAlpha = 1.0f / (attackTime * sampleRate * 0.001f + 1.0f);
-            
-            if (absIn > envelope)
-            {
-                // Trigger pitch scoop (momentary flat pitch on attack like harmonica)
-                if (absIn > 0.05f && envelope < 0.01f) 
-                    pitchScoop = -0.05f; 
-                
-                envelope += (absIn - envelope) * attackAlpha;
-            }
-            else
-            {
-                envelope += (absIn - envelope) * 0.0003f;
-            }
+            float absIn = level[s];
+
+            // Trigger pitch scoop (momentary flat pitch on attack like harmonica)
+            if (absIn > 0.05f && follower.getEnvelope() < 0.01f)
+                pitchScoop = -0.05f;
+
+            const float envelope = follower.process(absIn);
             
             // Decay pitch scoop back to unison
             pitchScoop *= 0.999f;
 
-            // 2. Modulations (Ensemble + Hand Vibrato)
-            // LFO 1: Slow Ensemble (0.5 Hz)
-            lfoPhase1 += (0.5f * 2.0f * juce::MathConstants<float>::pi) / (float)sampleRate;
-            if (lfoPhase1 >= juce::MathConstants<float>::twoPi) lfoPhase1 -= juce::MathConstants<float>::twoPi;
-            
-            // LFO 2: Fast Vibrato (6.0 Hz for harmonica/hand)
-            lfoPhase2 += (6.0f * 2.0f * juce::MathConstants<float>::pi) / (float)sampleRate;
-            if (lfoPhase2 >= juce::MathConstants<float>::twoPi) lfoPhase2 -= juce::MathConstants<float>::twoPi;
+            // 2. Modulations (Ensemble + Hand Vibrato), at control rate
+            if (modRamp.isDue())
+            {
+                ensembleLfo.advance(); // LFO 1: Slow Ensemble (0.5 Hz)
+                vibratoLfo.advance();  // LFO 2: Fast Vibrato (6.0 Hz for harmonica/hand)
+
+                float ensembleMod = ensembleLfo.sine() * 0.004f;
+                float vibratoMod = vibratoLfo.sine() * 0.008f * (octaveMix > 0.5f ? 1.0f : 0.2f);
+                modRamp.rampTo(ensembleMod + vibratoMod);
+            }
 
-            float ensembleMod = std::sin(lfoPhase1) * 0.004f;
-            float vibratoMod = std::sin(lfoPhase2) * 0.008f * (octaveMix > 0.5f ? 1.0f : 0.2f);
-            float totalPitchOffset = ensembleMod + vibratoMod + pitchScoop;
+            float totalPitchOffset = modRamp.next() + pitchScoop;
 
             // 3. Multi-Layer Synth (Organ/Harmonica Reed Logic)
-            grainBuffer[writePos] = input;
-            
+            grainLine.write(0, input);
+
+            float taps[numTaps];
+            grainLine.readTaps(0, tapDelays, taps, numTaps);
+
             float synthSum = 0.0f;
-            float ratios[4] = { 0.5f, 1.0f, 2.0f, 3.0f }; // Sub, Fund, Oct, 12th (Harmonica often has 3rd harmonic)
-            float gains[4] =  { 0.3f, 0.4f, 0.3f, 0.2f }; 
+            float ratios[numLayers] = { 0.5f, 1.0f, 2.0f, 3.0f }; // Sub, Fund, Oct, 12th (Harmonica often has 3rd harmonic)
+            float gains[numLayers] =  { 0.3f, 0.4f, 0.3f, 0.2f }; 
 
-            for (int i = 0; i < 4; ++i)
+            for (int i = 0; i < numLayers; ++i)
             {
-                float layer = getGrainSample(readPos[i], bufSize);
-                float layerDetune = getGrainSample(readPosDetune[i], bufSize);
-                
-                synthSum += (layer + layerDetune) * gains[i] * 0.5f;
-
-                readPos[i] += ratios[i] + totalPitchOffset;
-                readPosDetune[i] += ratios[i] - (totalPitchOffset * 0.5f);
-                
-                if (readPos[i] >= (float)bufSize) readPos[i] -= (float)bufSize;
-                if (readPosDetune[i] >= (float)bufSize) readPosDetune[i] -= (float)bufSize;
+                synthSum += (taps[i] + taps[numLayers + i]) * gains[i] * 0.5f;
+
+                // Each head trails the write head and drifts at its own ratio
+                tapDelays[i] += 1.0f - (ratios[i] + totalPitchOffset);
+                tapDelays[numLayers + i] += 1.0f - (ratios[i] - (totalPitchOffset * 0.5f));
             }
 
-            writePos = (writePos + 1) % bufSize;
+            for (auto& d : tapDelays)
+            {
+                if (d < 0.0f) d += period;
+                if (d >= period) d -= period;
+            }
+
+            grainLine.advance();
 
             // 4. Breath Noise & Reedy Saturation
             float breath = (random.nextFloat() * 2.0f - 1.0f) * 0.05f * std::pow(envelope, 0.5f);
@@ -131,37 +174,32 @@ public:
             float synthOutput = filterState[3] * envelope;
 
             for (int ch = 0; ch < numChannels; ++ch)
-            {
-                float dry = buffer.getSample(ch, s);
-                buffer.setSample(ch, s, dry * (1.0f - mix) + synthOutput * mix);
-            }
+                data[ch][s] = data[ch][s] * (1.0f - mix) + synthOutput * mix;
         }
     }
 
 private:
-    float getGrainSample(float pos, int bufSize)
-    {
-        int p1 = (int)pos % bufSize;
-        int p2 = (p1 + 1) % bufSize;
-        float frac = pos - (float)((int)pos);
-        return grainBuffer[p1] * (1.0f - frac) + grainBuffer[p2] * frac;
-    }
-
     double sampleRate = 44100.0;
     float attackTime = 150.0f;
+    float attackAlpha = 1.0f / (150.0f * 44.1f + 1.0f);
     float octaveMix = 0.5f;
     float brightness = 2000.0f;
     float resonance = 0.5f;
     float mix = 0.5f;
 
-    std::vector<float> grainBuffer;
-    int writePos = 0;
-    float readPos[4];
-    float readPosDetune[4];
+    static constexpr float releaseAlpha = 0.0003f;
+    static constexpr int numLayers = 4;
+    static constexpr int numTaps = numLayers * 2; // Each layer plus its detuned twin
+
+    DelayLine grainLine;
+    int grainPeriod = 13230;
+    float tapDelays[numTaps] = {}; // Write head to each read head, in [0, grainPeriod)
 
-    float lfoPhase1 = 0.0f, lfoPhase2 = 0.0f;
+    ControlLfo ensembleLfo, vibratoLfo;
+    ControlRamp modRamp;
     float filterState[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
-    float envelope = 0.0f;
+    LevelDetector sidechain;
+    EnvelopeFollower follower;
     float pitchScoop = 0.0f;
     juce::Random random;
 };
@@ -0,0 +1,66 @@
+#pragma once
+#include <JuceHeader.h>
+#include <cmath>
+
+/**
+ * TailSleeper - Decides when a time-based effect may stop running.
+ *
+ * The processor tracks whether each block reaching a module is silent. Once
+ * the input has stayed silent for as long as the module's tail (the time its
+ * feedback, reverb or filter state needs to fall below silenceThreshold),
+ * the module is asleep: the caller skips it and just clears the block. The
+ * first non-silent block wakes it again with its state intact.
+ *
+ * Counting is in samples, so the decision does not depend on block size.
+ */
+class TailSleeper
+{
+public:
+    static constexpr float silenceThreshold = 1.0e-6f; // -120 dBFS
+
+    static bool isSilent(const juce::AudioBuffer<float>& buffer)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            auto range = juce::FloatVectorOperations::findMinAndMax(buffer.getReadPointer(ch), buffer.getNumSamples());
+            if (range.getStart() < -silenceThreshold || range.getEnd() > silenceThreshold)
+                return false;
+        }
+
+        return true;
+    }
+
+    /** Repeats of a feedback loop with the given gain until it drops below silenceThreshold. */
+    static double getDecayRepeats(float loopGain)
+    {
+        loopGain = std::abs(loopGain);
+        if (loopGain >= 1.0f)
+            return std::numeric_limits<double>::infinity();
+        if (loopGain <= silenceThreshold)
+            return 1.0;
+
+        return std::ceil(std::log((double) silenceThreshold) / std::log((double) loopGain));
+    }
+
+    /** Call once per block while the module is enabled; false means skip it. */
+    bool shouldProcess(bool inputSilent, int numSamples, double tailSeconds, double sampleRate)
+    {
+        if (! inputSilent)
+        {
+            silentSamples = 0;
+            return true;
+        }
+
+        // An infinite tail compares false and never sleeps
+        if ((double) silentSamples >= tailSeconds * sampleRate)
+            return false;
+
+        silentSamples += numSamples;
+        return true;
+    }
+
+    void reset() { silentSamples = 0; }
+
+private:
+    juce::int64 silentSamples = 0;
+};
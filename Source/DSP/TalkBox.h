@@ -1,5 +1,6 @@
 #pragma once
 #include <JuceHeader.h>
+#include "Biquad.h"
 
 class TalkBox
 {
@@ -9,11 +10,8 @@ public:
     void prepare(const juce::dsp::ProcessSpec& spec)
     {
         sampleRate = spec.sampleRate;
-        for (int i = 0; i < 3; ++i)
-        {
-            for (int ch = 0; ch < 2; ++ch)
-                filters[i][ch].reset();
-        }
+        for (auto& f : filters)
+            f.prepare(sampleRate);
         updateFilters();
     }
 
@@ -28,32 +26,46 @@ public:
         mix = newMix;
     }
 
+    struct Parameters
+    {
+        float vowel = 0.0f;
+        float mix = 1.0f;
+    };
+
+    void setParameters(const Parameters& p)
+    {
+        if (p.vowel != vowelPosition)
+            setVowel(p.vowel);
+        setMix(p.mix);
+    }
+
+    /** Starts channel to from channel from's formant filters. */
+    void copyChannelState(int from, int to)
+    {
+        for (auto& f : filters)
+            f.copyChannelState(from, to);
+    }
+
     void process(juce::AudioBuffer<float>& buffer)
     {
         if (mix <= 0.01f) return;
 
-        juce::AudioBuffer<float> dryBuffer;
-        dryBuffer.makeCopyOf(buffer);
-
-        auto block = juce::dsp::AudioBlock<float>(buffer);
-        int numChannels = buffer.getNumChannels();
+        int numChannels = juce::jmin(buffer.getNumChannels(), Biquad::maxChannels);
+        int numSamples = buffer.getNumSamples();
 
-        for (int i = 0; i < 3; ++i)
+        // Formants in series, mixed per sample (no dry copy needed)
+        for (int ch = 0; ch < numChannels; ++ch)
         {
-            for (int ch = 0; ch < numChannels; ++ch)
+            auto* data = buffer.getWritePointer(ch);
+            for (int s = 0; s < numSamples; ++s)
             {
-                auto sb = block.getSingleChannelBlock(ch);
-                auto ctx = juce::dsp::ProcessContextReplacing<float>(sb);
-                filters[i][ch].process(ctx);
+                float dry = data[s];
+                float wet = dry;
+                for (auto& f : filters)
+                    wet = f.processSample(ch, wet);
+                data[s] = wet * mix + dry * (1.0f - mix);
             }
         }
-
-        // Apply mix
-        for (int ch = 0; ch < numChannels; ++ch)
-        {
-            buffer.applyGainRamp(ch, 0, buffer.getNumSamples(), mix, mix);
-            buffer.addFromWithRamp(ch, 0, dryBuffer.getReadPointer(ch), buffer.getNumSamples(), 1.0f - mix, 1.0f - mix);
-        }
     }
 
 private:
@@ -84,16 +96,12 @@ private:
             float q = 8.0f; // Narrow filters for speech-like character
             float gain = 10.0f; // Boost the formants
 
-            auto coeffs = juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-                sampleRate, f[i], q, juce::Decibels::decibelsToGain(gain));
-
-            for (int ch = 0; ch < 2; ++ch)
-                *filters[i][ch].coefficients = *coeffs;
+            filters[i].setPeak(f[i], q, juce::Decibels::decibelsToGain(gain));
         }
     }
 
     double sampleRate = 44100.0;
     float vowelPosition = 0.0f;
     float mix = 1.0f;
-    juce::dsp::IIR::Filter<float> filters[3][2]; // 3 resonant peaks x 2 channels
+    Biquad filters[3]; // 3 resonant peaks, stereo state each
 };
@@ -2,103 +2,324 @@
 #include <JuceHeader.h>
 #include <vector>
 #include <cmath>
+#include "Biquad.h"
+#include "DelayLine.h"
+#include "Seqlock.h"
 
-class Tuner
+/** Latest pitch estimate, published by the tuner's analysis thread. */
+struct TunerReading
+{
+    float frequency = 0.0f;  // Hz, 0 when there is no usable signal
+    float cents = 0.0f;      // Offset from the nearest equal-tempered note
+    int note = -1;           // MIDI note number, -1 when silent
+    float confidence = 0.0f; // NSDF peak height, 0..1
+};
+
+/**
+ * Tuner - The audio thread only copies samples into a lock-free FIFO.
+ * A background thread decimates them and runs McLeod pitch detection
+ * (FFT-based NSDF), publishing the result through a Seqlock.
+ *
+ * Nothing runs unless the tuner is switched on or its display is showing.
+ */
+class Tuner : private juce::Thread
 {
 public:
-    Tuner() = default;
+    Tuner() : juce::Thread("Tuner Analysis") {}
 
-    void prepare(double newSampleRate)
+    ~Tuner() override
     {
-        sampleRate = newSampleRate;
-        bufferSize = 4096; // Good for down to ~20Hz at 44.1kHz
-        circularBuffer.resize(bufferSize, 0.0f);
-        bufferIndex = 0;
-        currentFrequency = 0.0f;
+        release();
     }
 
-    void processBlock(const float* input, int numSamples)
+    void prepare(double newSampleRate)
     {
-        for (int i = 0; i < numSamples; ++i)
+        release();
+
+        sampleRate = newSampleRate;
+        decimation = juce::jmax(1, juce::roundToInt(sampleRate / targetRate));
+        analysisRate = sampleRate / decimation;
+
+        // ~250 ms of slack so the worker can poll lazily
+        int fifoSize = juce::nextPowerOfTwo(static_cast<int>(sampleRate * 0.25));
+        fifo.setTotalSize(fifoSize);
+        fifoBuffer.assign((size_t) fifoSize, 0.0f);
+        readScratch.assign((size_t) fifoSize, 0.0f);
+
+        history.prepare(1, windowSize, windowSize);
+        frame.assign(windowSize, 0.0f);
+        fftData.assign(fftSize * 2, 0.0f);
+        nsdf.assign(windowSize, 0.0f);
+
+        for (auto& f : antiAlias)
         {
-            circularBuffer[bufferIndex] = input[i];
-            bufferIndex = (bufferIndex + 1) % bufferSize;
+            f.prepare(sampleRate);
+            f.setLowPass(2000.0f);
         }
-        
-        calculateFrequency();
+
+        fifo.reset();
+        resetAnalysis();
+        startThread(juce::Thread::Priority::low);
     }
 
-    float getFrequency() const
+    void release()
     {
-        return currentFrequency;
+        stopThread(1000);
     }
 
+    /** Audio thread: copies the block into the FIFO, or does nothing when inactive. */
+    void processBlock(const float* input, int numSamples, bool tunerEnabled)
+    {
+        const bool active = tunerEnabled || displayVisible.load(std::memory_order_relaxed);
+        analysisActive.store(active, std::memory_order_relaxed);
+
+        if (!active || fifoBuffer.empty())
+            return;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+        if (size1 > 0) std::copy(input, input + size1, fifoBuffer.data() + start1);
+        if (size2 > 0) std::copy(input + size1, input + size1 + size2, fifoBuffer.data() + start2);
+
+        // If the worker has fallen behind the overflow is simply dropped
+        fifo.finishedWrite(size1 + size2);
+    }
+
+    /** Message thread: lets the tuner run while its display is on screen. */
+    void setDisplayVisible(bool visible) { displayVisible.store(visible, std::memory_order_relaxed); }
+
+    TunerReading getReading() const { return reading.load(); }
+
 private:
-    void calculateFrequency()
+    void run() override
     {
-        int minLag = static_cast<int>(sampleRate / 1000.0f); // Max ~1000 Hz
-        int maxLag = static_cast<int>(sampleRate / 60.0f);   // Min ~60 Hz
-        if (maxLag > bufferSize / 2) maxLag = bufferSize / 2;
-
-        // Unroll circular buffer for analysis
-        std::vector<float> linearBuffer(bufferSize);
-        for(int i = 0; i < bufferSize; ++i) {
-            linearBuffer[i] = circularBuffer[(bufferIndex + i) % bufferSize];
+        bool wasActive = false;
+
+        while (!threadShouldExit())
+        {
+            const bool active = analysisActive.load(std::memory_order_relaxed);
+
+            if (!active)
+            {
+                if (wasActive)
+                {
+                    // Consumer-side discard; only the audio thread may write
+                    fifo.finishedRead(fifo.getNumReady());
+                    resetAnalysis();
+                    reading.store({});
+                }
+
+                wasActive = false;
+                wait(100);
+                continue;
+            }
+
+            wasActive = true;
+            drainFifo();
+
+            if (samplesSinceAnalysis >= hopSize && samplesCollected >= windowSize)
+            {
+                samplesSinceAnalysis = 0;
+                analyse();
+            }
+
+            wait(10);
         }
+    }
+
+    void drainFifo()
+    {
+        int numReady = fifo.getNumReady();
+        if (numReady <= 0) return;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(numReady, start1, size1, start2, size2);
+
+        std::copy(fifoBuffer.data() + start1, fifoBuffer.data() + start1 + size1, readScratch.data());
+        std::copy(fifoBuffer.data() + start2, fifoBuffer.data() + start2 + size2, readScratch.data() + size1);
+        fifo.finishedRead(size1 + size2);
 
-        // Check level
-        float rms = 0.0f;
-        for(int i = 0; i < bufferSize; ++i) rms += linearBuffer[i] * linearBuffer[i];
-        rms = std::sqrt(rms / bufferSize);
-        
-        if (rms < 0.005f) { // Silence threshold
-            currentFrequency = 0.0f; // Silence, reset needle
+        for (int i = 0; i < size1 + size2; ++i)
+        {
+            float x = antiAlias[0].processSample(0, readScratch[(size_t) i]);
+            x = antiAlias[1].processSample(0, x);
+
+            if (++decimationCounter < decimation)
+                continue;
+
+            decimationCounter = 0;
+            history.write(0, x);
+            history.advance();
+            ++samplesSinceAnalysis;
+            if (samplesCollected < windowSize) ++samplesCollected;
+        }
+    }
+
+    void analyse()
+    {
+        // Unroll the ring, oldest sample first
+        history.readBlock(0, frame.data(), windowSize, windowSize);
+
+        float energy = 0.0f;
+        for (int i = 0; i < windowSize; ++i)
+            energy += frame[(size_t) i] * frame[(size_t) i];
+
+        float rms = std::sqrt(energy / windowSize);
+        if (rms < 0.005f) // Silence threshold
+        {
+            currentFrequency = 0.0f;
+            reading.store({});
             return;
         }
 
-        // Autocorrelation
-        float maxCorr = 0;
-        int bestLag = 0;
-        std::vector<float> corr(maxLag, 0.0f);
+        // Autocorrelation via FFT: zero-padded to 2N so it is linear, not circular
+        std::fill(fftData.begin(), fftData.end(), 0.0f);
+        std::copy(frame.begin(), frame.end(), fftData.begin());
+        fft.performRealOnlyForwardTransform(fftData.data(), true);
 
-        for (int lag = minLag; lag < maxLag; ++lag)
+        for (int bin = 0; bin <= fftSize / 2; ++bin)
         {
-            float sum = 0;
-            for (int i = 0; i < maxLag; ++i)
-            {
-                sum += linearBuffer[i] * linearBuffer[i + lag];
-            }
-            corr[lag] = sum;
-            if (sum > maxCorr)
+            float re = fftData[(size_t) bin * 2];
+            float im = fftData[(size_t) bin * 2 + 1];
+            fftData[(size_t) bin * 2] = re * re + im * im;
+            fftData[(size_t) bin * 2 + 1] = 0.0f;
+        }
+
+        fft.performRealOnlyInverseTransform(fftData.data());
+
+        // Normalised square difference: 2 r(t) / m(t), with m updated incrementally
+        int minLag = juce::jmax(2, static_cast<int>(analysisRate / maxFrequency));
+        int maxLag = juce::jmin(windowSize / 2, static_cast<int>(analysisRate / minFrequency));
+
+        float m = 2.0f * energy;
+        for (int lag = 0; lag < maxLag; ++lag)
+        {
+            if (lag > 0)
             {
-                maxCorr = sum;
-                bestLag = lag;
+                float a = frame[(size_t) (lag - 1)];
+                float b = frame[(size_t) (windowSize - lag)];
+                m -= a * a + b * b;
             }
+
+            nsdf[(size_t) lag] = m > 0.0f ? 2.0f * fftData[(size_t) lag] / m : 0.0f;
+        }
+
+        int bestLag = pickPeak(minLag, maxLag);
+        if (bestLag <= 0)
+        {
+            reading.store({});
+            return;
         }
 
         // Quadratic interpolation for better precision
-        if (bestLag > minLag && bestLag < maxLag - 1)
+        float alpha = nsdf[(size_t) (bestLag - 1)];
+        float beta = nsdf[(size_t) bestLag];
+        float gamma = nsdf[(size_t) (bestLag + 1)];
+        float denom = alpha - 2.0f * beta + gamma;
+        float p = denom != 0.0f ? 0.5f * (alpha - gamma) / denom : 0.0f;
+
+        float freq = static_cast<float>(analysisRate) / (bestLag + p);
+
+        // Smooth frequency if not wildly different, otherwise jump
+        if (currentFrequency == 0.0f || std::abs(freq - currentFrequency) > 50.0f)
+            currentFrequency = freq;
+        else
+            currentFrequency = currentFrequency * 0.7f + freq * 0.3f;
+
+        // MIDI note 69 is A4 (440 Hz)
+        float semitones = 12.0f * std::log2(currentFrequency / 440.0f) + 69.0f;
+
+        TunerReading r;
+        r.frequency = currentFrequency;
+        r.note = juce::roundToInt(semitones);
+        r.cents = (semitones - r.note) * 100.0f;
+        r.confidence = juce::jlimit(0.0f, 1.0f, beta);
+        reading.store(r);
+    }
+
+    /** McLeod peak picking: first key maximum within 90% of the highest one. */
+    int pickPeak(int minLag, int maxLag)
+    {
+        int keyLags[maxKeyMaxima];
+        int numKeys = 0;
+        float highest = 0.0f;
+
+        // Skip the zero-lag lobe
+        int lag = 1;
+        while (lag < maxLag && nsdf[(size_t) lag] > 0.0f) ++lag;
+
+        while (lag < maxLag - 1 && numKeys < maxKeyMaxima)
         {
-            float alpha = corr[bestLag - 1];
-            float beta = corr[bestLag];
-            float gamma = corr[bestLag + 1];
-            
-            float p = 0.5f * (alpha - gamma) / (alpha - 2.0f * beta + gamma);
-            float refinedLag = bestLag + p;
-            
-            float freq = static_cast<float>(sampleRate) / refinedLag;
-            
-            // Smooth frequency if not wildly different, otherwise jump
-            if (currentFrequency == 0.0f || std::abs(freq - currentFrequency) > 50.0f)
-                currentFrequency = freq;
-            else
-                currentFrequency = currentFrequency * 0.7f + freq * 0.3f;
+            // Find the next positive-going zero crossing
+            while (lag < maxLag - 1 && nsdf[(size_t) lag] <= 0.0f) ++lag;
+
+            int best = -1;
+            while (lag < maxLag - 1 && nsdf[(size_t) lag] > 0.0f)
+            {
+                if (lag >= minLag && (best < 0 || nsdf[(size_t) lag] > nsdf[(size_t) best]))
+                    best = lag;
+                ++lag;
+            }
+
+            if (best > 0)
+            {
+                keyLags[numKeys++] = best;
+                highest = juce::jmax(highest, nsdf[(size_t) best]);
+            }
         }
+
+        if (highest < minConfidence)
+            return -1;
+
+        for (int i = 0; i < numKeys; ++i)
+            if (nsdf[(size_t) keyLags[i]] >= highest * 0.9f)
+                return keyLags[i];
+
+        return -1;
+    }
+
+    void resetAnalysis()
+    {
+        history.reset();
+        samplesCollected = 0;
+        samplesSinceAnalysis = 0;
+        decimationCounter = 0;
+        currentFrequency = 0.0f;
+        for (auto& f : antiAlias)
+            f.reset();
     }
 
+    static constexpr double targetRate = 11025.0;    // Analysis runs on a decimated signal
+    static constexpr int fftOrder = 12;
+    static constexpr int fftSize = 1 << fftOrder;     // 2x window, for linear correlation
+    static constexpr int windowSize = fftSize / 2;    // ~186 ms at 11 kHz
+    static constexpr int hopSize = 256;               // ~23 ms between estimates
+    static constexpr int maxKeyMaxima = 32;
+    static constexpr float minFrequency = 60.0f;
+    static constexpr float maxFrequency = 1000.0f;
+    static constexpr float minConfidence = 0.5f;
+
     double sampleRate = 44100.0;
-    std::vector<float> circularBuffer;
-    int bufferSize = 4096;
-    int bufferIndex = 0;
+    double analysisRate = 11025.0;
+    int decimation = 4;
+
+    // Audio thread -> worker
+    juce::AbstractFifo fifo { 1 };
+    std::vector<float> fifoBuffer;
+    std::atomic<bool> analysisActive { false };
+    std::atomic<bool> displayVisible { false };
+
+    // Worker-only state
+    std::vector<float> readScratch, frame, fftData, nsdf;
+    DelayLine history; // Decimated input
+    Biquad antiAlias[2]; // 4th-order lowpass ahead of decimation
+    juce::dsp::FFT fft { fftOrder };
+    int samplesCollected = 0;
+    int samplesSinceAnalysis = 0;
+    int decimationCounter = 0;
     float currentFrequency = 0.0f;
+
+    // Worker -> GUI
+    Seqlock<TunerReading> reading;
 };
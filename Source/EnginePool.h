@@ -0,0 +1,493 @@
+#pragma once
+#include <JuceHeader.h>
+#include "FXEngine.h"
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <memory>
+
+/**
+ * EnginePool - The live FXEngine plus, with warm standby on, spare engines
+ * configured ahead of time for the presets the player is likely to step to.
+ *
+ * A background thread configures the standby engines. For a preset switch
+ * the message thread claims the one that matches (or configures a free one
+ * itself) and posts it through the PresetSwitcher. The audio thread then
+ * runs the old and new engines side by side for an equal-power crossfade.
+ * With spillover the old engine's input fades rather than its output, and
+ * the engine keeps running until its tails have had time to decay.
+ *
+ * Every engine is a whole chain, delay lines, reverb and IR included, so
+ * memory is bounded by the standby count: standbyCount + 2 engines (one
+ * more for a ringing tail), or the single live engine and the
+ * PresetSwitcher's fade when it is 0. Each engine has one atomic owner
+ * state, so a thread only ever touches an engine it owns.
+ */
+class EnginePool : private juce::Thread
+{
+public:
+    static constexpr int maxStandby = 2;
+    static constexpr int maxEngines = maxStandby + 2;
+    static constexpr double maxTailSeconds = 10.0; // Longest an old engine rings on
+
+    EnginePool() : juce::Thread("Preset Standby")
+    {
+        engines[0].engine = std::make_unique<FXEngine>();
+        engines[0].state.store(active);
+    }
+
+    ~EnginePool() override { stopThread(2000); }
+
+    //==============================================================================
+    // Message thread, with the audio stopped or suspended
+
+    void prepare(double newSampleRate, int maximumBlockSize, int numChannels, int oversamplingStages)
+    {
+        stopThread(2000);
+
+        sampleRate = newSampleRate;
+        blockSize = maximumBlockSize;
+        channels = numChannels;
+        stages = oversamplingStages;
+        prepared = true;
+
+        for (int i = 0; i < numEngines; ++i)
+            prepareEngine(i);
+
+        inputCopy.setSize(channels, blockSize);
+        engineBuffer.setSize(channels, blockSize);
+        fadeStep = juce::MathConstants<float>::halfPi / (float) juce::jmax(1.0, sampleRate * PresetSwitcher::fadeSeconds);
+
+        if (numEngines > 1)
+            startThread(juce::Thread::Priority::low);
+    }
+
+    void release()
+    {
+        stopThread(2000);
+        prepared = false;
+
+        for (int i = 0; i < numEngines; ++i)
+            engines[(size_t) i].engine->release();
+    }
+
+    /**
+     * Re-prepares every engine's oversampled stages at the new factor. The
+     * live engine keeps its delay and reverb tails; standbys are configured
+     * again by the loader.
+     */
+    void setOversamplingStages(int oversamplingStages)
+    {
+        if (oversamplingStages == stages)
+            return;
+
+        stopThread(2000);
+        stages = oversamplingStages;
+
+        for (int i = 0; i < numEngines; ++i)
+        {
+            auto& e = engines[(size_t) i];
+            e.engine->setOversamplingStages(stages);
+
+            if (i != live)
+            {
+                e.state.store(idle);
+                e.tailing = e.spill = false;
+            }
+        }
+
+        if (prepared && numEngines > 1)
+            startThread(juce::Thread::Priority::low);
+    }
+
+    int getOversamplingStages() const { return stages; }
+
+    /** 0 = off; each standby costs one more full engine. */
+    void setStandbyCount(int count)
+    {
+        count = juce::jlimit(0, maxStandby, count);
+        const int wanted = count > 0 ? count + 2 : 1;
+        standbyCount = count;
+
+        if (wanted == numEngines)
+            return;
+
+        stopThread(2000);
+
+        // The live engine moves to the front and keeps playing; the rest start over
+        std::swap(engines[0].engine, engines[(size_t) live].engine);
+        live = 0;
+        engines[0].state.store(active);
+        engines[0].tailing = false;
+        engines[0].outputAngle = juce::MathConstants<float>::halfPi;
+
+        for (int i = 1; i < maxEngines; ++i)
+        {
+            auto& e = engines[(size_t) i];
+            e.state.store(idle);
+            e.tailing = false;
+
+            if (i >= wanted)
+            {
+                e.engine.reset();
+                continue;
+            }
+
+            if (e.engine == nullptr)
+            {
+                e.engine = std::make_unique<FXEngine>();
+                if (irFile.existsAsFile())
+                    e.engine->loadCabinetIR(irFile);
+                if (captureFile.existsAsFile())
+                    e.engine->loadAmpCapture(captureFile);
+            }
+
+            if (prepared)
+                prepareEngine(i);
+        }
+
+        numEngines = wanted;
+
+        if (prepared && numEngines > 1)
+            startThread(juce::Thread::Priority::low);
+    }
+
+    int getStandbyCount() const { return standbyCount; }
+
+    /** The presets to keep warm, most likely first; extra ones are ignored. */
+    void setTargets(const ParameterValues* values, int count)
+    {
+        {
+            const juce::ScopedLock sl(targetLock);
+            numTargets = juce::jlimit(0, maxStandby, count);
+            for (int i = 0; i < numTargets; ++i)
+                targets[(size_t) i] = values[i];
+        }
+
+        notify();
+    }
+
+    /**
+     * Finds the standby configured for this preset, or configures a free
+     * engine for it here, and reserves it for the post with the given
+     * serial. Returns -1 if every engine is busy, or before prepare().
+     */
+    int claim(const ParameterValues& values, const ParameterSnapshot& s, juce::uint32 serial)
+    {
+        // Session state can arrive before playback is prepared
+        if (numEngines == 1 || ! prepared)
+            return -1;
+
+        // Checked under our ownership, so the loader can't retarget it meanwhile
+        for (int i = 0; i < numEngines; ++i)
+        {
+            if (! take(i, ready))
+                continue;
+
+            if (engines[(size_t) i].values.isSamePreset(values))
+                return reserve(i, serial);
+
+            engines[(size_t) i].state.store(ready, std::memory_order_release);
+        }
+
+        for (const int from : { idle, ready })
+            for (int i = 0; i < numEngines; ++i)
+                if (take(i, from))
+                {
+                    engines[(size_t) i].engine->configure(s);
+                    return reserve(i, serial);
+                }
+
+        return -1;
+    }
+
+    void loadCabinetIR(const juce::File& file)
+    {
+        irFile = file;
+        for (int i = 0; i < numEngines; ++i)
+            engines[(size_t) i].engine->loadCabinetIR(file);
+    }
+
+    bool loadAmpCapture(const juce::File& file)
+    {
+        if (! engines[0].engine->loadAmpCapture(file))
+            return false;
+
+        captureFile = file;
+        for (int i = 1; i < numEngines; ++i)
+            engines[(size_t) i].engine->loadAmpCapture(file);
+        return true;
+    }
+
+    //==============================================================================
+    // Audio thread
+
+    FXEngine& getLiveEngine() { return *engines[(size_t) live].engine; }
+
+    /**
+     * Hands the chain to a claimed engine at the top of this block. The old
+     * one crossfades out, or with spillTails has its input faded and rings
+     * on for its tail. outgoingGain is whatever switch fade it was under.
+     */
+    void switchTo(int index, bool spillTails, float outgoingGain)
+    {
+        // A post from before the pool was resized has nothing to switch to
+        if (! juce::isPositiveAndBelow(index, numEngines)
+            || engines[(size_t) index].state.load(std::memory_order_acquire) != claimed)
+            return;
+
+        auto& old = engines[(size_t) live];
+        old.tailing = true;
+        old.spill = spillTails;
+        old.inputAngle = juce::MathConstants<float>::halfPi;
+        old.outputAngle = std::asin(juce::jlimit(0.0f, 1.0f, std::sin(old.outputAngle) * outgoingGain));
+        old.tailSamples = spillTails
+            ? (juce::int64) (juce::jmin(maxTailSeconds, FXEngine::getTailSeconds(old.engine->getSnapshot(), sampleRate)) * sampleRate)
+            : 0;
+
+        auto& next = engines[(size_t) index];
+        next.state.store(active, std::memory_order_relaxed);
+        next.tailing = false;
+        next.inputAngle = juce::MathConstants<float>::halfPi;
+        next.outputAngle = 0.0f;
+        live = index;
+    }
+
+    /**
+     * Claims a standby already configured for these values, for a switchTo()
+     * in this same block (a MIDI program change). Never configures one, so
+     * -1 unless the loader got there first.
+     */
+    int claimReady(const ParameterValues& values)
+    {
+        for (int i = 0; i < numEngines; ++i)
+        {
+            if (! take(i, ready))
+                continue;
+
+            if (engines[(size_t) i].values.isSamePreset(values))
+                return reserve(i, 0);
+
+            engines[(size_t) i].state.store(ready, std::memory_order_release);
+        }
+
+        return -1;
+    }
+
+    /** Returns engines claimed for posts older than the one just taken. */
+    void dropStaleClaims(juce::uint32 takenSerial)
+    {
+        for (int i = 0; i < numEngines; ++i)
+        {
+            auto& e = engines[(size_t) i];
+            if (e.state.load(std::memory_order_acquire) == claimed && (juce::int32) (takenSerial - e.serial) > 0)
+                e.state.store(idle, std::memory_order_release);
+        }
+    }
+
+    /** Runs the live engine on buffer, and any old ones still fading or ringing on a copy of its input. */
+    void process(juce::AudioBuffer<float>& buffer, bool dualMono, const ParameterSnapshot& s, const FXEngine::BlockHooks& hooks)
+    {
+        const int numSamples = buffer.getNumSamples();
+        const int numChannels = buffer.getNumChannels();
+
+        bool anyTail = false;
+        for (int i = 0; i < numEngines; ++i)
+            anyTail = anyTail || engines[(size_t) i].tailing;
+
+        if (anyTail)
+        {
+            jassert(numSamples <= inputCopy.getNumSamples() && numChannels <= inputCopy.getNumChannels());
+            for (int ch = 0; ch < numChannels; ++ch)
+                inputCopy.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+        }
+
+        auto& current = engines[(size_t) live];
+        current.engine->process(buffer, dualMono, s, hooks);
+        applyRamp(buffer, current.outputAngle, juce::MathConstants<float>::halfPi);
+
+        if (! anyTail)
+            return;
+
+        FXEngine::BlockHooks tailHooks;
+        tailHooks.profiler = hooks.profiler;
+
+        for (int i = 0; i < numEngines; ++i)
+        {
+            auto& e = engines[(size_t) i];
+            if (! e.tailing)
+                continue;
+
+            juce::AudioBuffer<float> tail(engineBuffer.getArrayOfWritePointers(), numChannels, numSamples);
+            for (int ch = 0; ch < numChannels; ++ch)
+                tail.copyFrom(ch, 0, inputCopy, ch, 0, numSamples);
+
+            if (e.spill)
+            {
+                applyRamp(tail, e.inputAngle, 0.0f);
+
+                // Rung out, or out of time: fade whatever is left
+                e.tailSamples -= numSamples;
+                if (e.tailSamples <= 0 && e.inputAngle <= 0.0f)
+                    e.spill = false;
+            }
+
+            e.engine->process(tail, dualMono, e.engine->getSnapshot(), tailHooks);
+            applyRamp(tail, e.outputAngle, e.spill ? juce::MathConstants<float>::halfPi : 0.0f);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                buffer.addFrom(ch, 0, tail, ch, 0, numSamples);
+
+            if (! e.spill && e.outputAngle <= 0.0f)
+            {
+                e.tailing = false;
+                e.state.store(idle, std::memory_order_release); // Back to the loader
+            }
+        }
+    }
+
+    int getLatencySamples() const { return engines[(size_t) live].engine->getLatencySamples(); }
+
+private:
+    // Owner of each engine: idle and ready ones are the loader's to (re)configure,
+    // checking/claimed ones the message thread's, active ones the audio thread's
+    enum State { idle, configuring, ready, checking, claimed, active };
+
+    struct Entry
+    {
+        std::unique_ptr<FXEngine> engine;
+        std::atomic<int> state { idle };
+        ParameterValues values;   // What a ready engine is configured for; loader only
+        juce::uint32 serial = 0;  // Post a claimed engine is reserved for
+
+        // Audio thread
+        bool tailing = false, spill = false;
+        float inputAngle = 0.0f, outputAngle = 0.0f; // Gain is sin(angle)
+        juce::int64 tailSamples = 0;
+    };
+
+    bool take(int i, int from)
+    {
+        int expected = from;
+        return engines[(size_t) i].state.compare_exchange_strong(expected, checking, std::memory_order_acq_rel);
+    }
+
+    int reserve(int i, juce::uint32 serial)
+    {
+        engines[(size_t) i].serial = serial;
+        engines[(size_t) i].state.store(claimed, std::memory_order_release);
+        return i;
+    }
+
+    void prepareEngine(int i)
+    {
+        auto& e = engines[(size_t) i];
+        e.engine->prepare(sampleRate, blockSize, channels, stages);
+        e.state.store(i == live ? active : idle);
+        e.tailing = e.spill = false;
+        e.inputAngle = e.outputAngle = juce::MathConstants<float>::halfPi;
+        e.tailSamples = 0;
+    }
+
+    /** Moves the gain angle toward target at the fade rate, applying sin(angle). */
+    void applyRamp(juce::AudioBuffer<float>& b, float& angle, float target) const
+    {
+        if (angle == target)
+        {
+            if (target <= 0.0f)
+                b.clear();
+            return;
+        }
+
+        float a = angle;
+        for (int ch = 0; ch < b.getNumChannels(); ++ch)
+        {
+            float* data = b.getWritePointer(ch);
+            a = angle;
+            for (int s = 0; s < b.getNumSamples(); ++s)
+            {
+                a = a < target ? juce::jmin(target, a + fadeStep) : juce::jmax(target, a - fadeStep);
+                data[s] *= std::sin(a);
+            }
+        }
+
+        angle = a;
+    }
+
+    //==============================================================================
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            std::array<ParameterValues, maxStandby> wanted;
+            int numWanted = 0;
+            {
+                const juce::ScopedLock sl(targetLock);
+                wanted = targets;
+                numWanted = numTargets;
+            }
+
+            for (int t = 0; t < numWanted && ! threadShouldExit(); ++t)
+                if (! hasStandbyFor(wanted[(size_t) t]))
+                    configureStandby(wanted, numWanted, t);
+
+            wait(250);
+        }
+    }
+
+    bool hasStandbyFor(const ParameterValues& v) const
+    {
+        for (int i = 0; i < numEngines; ++i)
+            if (engines[(size_t) i].state.load(std::memory_order_acquire) == ready && engines[(size_t) i].values.isSamePreset(v))
+                return true;
+        return false;
+    }
+
+    void configureStandby(const std::array<ParameterValues, maxStandby>& wanted, int numWanted, int t)
+    {
+        // A free engine, else a standby for a preset that is no longer wanted
+        auto isWanted = [&](const ParameterValues& v)
+        {
+            for (int w = 0; w < numWanted; ++w)
+                if (wanted[(size_t) w].isSamePreset(v))
+                    return true;
+            return false;
+        };
+
+        for (const int from : { idle, ready })
+            for (int i = 0; i < numEngines; ++i)
+            {
+                auto& e = engines[(size_t) i];
+                if (from == ready && (e.state.load(std::memory_order_acquire) != ready || isWanted(e.values)))
+                    continue;
+
+                int expected = from;
+                if (! e.state.compare_exchange_strong(expected, configuring, std::memory_order_acq_rel))
+                    continue;
+
+                ParameterSnapshot s;
+                captureParameters(wanted[(size_t) t], s);
+                e.engine->configure(s);
+                e.values = wanted[(size_t) t];
+                e.state.store(ready, std::memory_order_release);
+                return;
+            }
+    }
+
+    std::array<Entry, maxEngines> engines;
+    int numEngines = 1, standbyCount = 0;
+    int live = 0; // Audio thread
+
+    double sampleRate = 44100.0;
+    int blockSize = 512, channels = 2, stages = 0;
+    bool prepared = false;
+
+    juce::File irFile, captureFile;
+
+    juce::CriticalSection targetLock;
+    std::array<ParameterValues, maxStandby> targets;
+    int numTargets = 0;
+
+    juce::AudioBuffer<float> inputCopy, engineBuffer;
+    float fadeStep = 0.001f;
+};
@@ -0,0 +1,490 @@
+#include "FXEngine.h"
+
+void FXEngine::prepare(double newSampleRate, int maximumBlockSize, int channels, int oversamplingStages)
+{
+    sampleRate = newSampleRate;
+    blockSize = maximumBlockSize;
+    numChannels = channels;
+
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = sampleRate;
+    spec.maximumBlockSize = static_cast<juce::uint32>(blockSize);
+    spec.numChannels = static_cast<juce::uint32>(numChannels);
+
+    dynamicsSidechain.prepare(blockSize, sampleRate);
+    noiseGate.prepare(spec);
+    compressor.prepare(spec);
+    oversampler.prepare(blockSize);
+    prepareNonlinearStages(oversamplingStages);
+    cabinetSim.prepare(spec);
+    chorus.prepare(spec);
+    flanger.prepare(spec);
+    phaser.prepare(spec);
+    harmonizer.prepare(spec);
+    stringSynth.prepare(spec);
+    delay.prepare(spec);
+    reverb.prepare(spec);
+    parametricEQ.prepare(spec);
+    graphicEQ.prepare(spec);
+    linearCascade.reset();
+    staleModules = ~0u;
+    monoModules = 0;
+
+    for (auto* sleeper : { &chorusSleeper, &flangerSleeper, &phaserSleeper, &harmonizerSleeper,
+                           &stringSynthSleeper, &delaySleeper, &reverbSleeper })
+        sleeper->reset();
+    talkBox.prepare(spec);
+    autoWah.prepare(spec);
+
+    spillBuffer.setSize(2, blockSize);
+    warmUpBuffer.setSize(numChannels, blockSize);
+    delaySpillSeconds = reverbSpillSeconds = 0.0;
+}
+
+void FXEngine::prepareNonlinearStages(int oversamplingStages)
+{
+    oversampler.setNumStages(oversamplingStages);
+
+    // Overdrive through power amp run at the oversampled rate
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = sampleRate * oversampler.getFactor();
+    spec.maximumBlockSize = static_cast<juce::uint32>(blockSize * oversampler.getFactor());
+    spec.numChannels = static_cast<juce::uint32>(numChannels);
+
+    overdrive.prepare(spec);
+    distortion.prepare(spec);
+    highGainDist.prepare(spec);
+    preamp.prepare(spec);
+    toneStack.prepare(spec);
+    powerAmp.prepare(spec);
+    staleModules |= nonlinearModules;
+
+    latencySamples = juce::roundToInt(oversampler.getLatencyInSamples());
+}
+
+void FXEngine::release()
+{
+    cabinetSim.release();
+}
+
+double FXEngine::getTailSeconds(const ParameterSnapshot& s, double sr)
+{
+    double tail = 0.0;
+
+    if (s.chorus.enabled)      tail += Chorus::getTailSeconds(s.chorus.params, sr);
+    if (s.flanger.enabled)     tail += Flanger::getTailSeconds(s.flanger.params, sr);
+    if (s.phaser.enabled)      tail += Phaser::getTailSeconds(s.phaser.params, sr);
+    if (s.harmonizer.enabled)  tail += Harmonizer::getTailSeconds(s.harmonizer.params, sr);
+    if (s.stringSynth.enabled) tail += StringSynth::getTailSeconds(s.stringSynth.params, sr);
+    if (s.delay.enabled)       tail += DelayEffect::getTailSeconds(s.delay.params, sr);
+    if (s.reverb.enabled)      tail += ReverbEffect::getTailSeconds(s.reverb.params, sr);
+
+    return tail;
+}
+
+void FXEngine::beginPresetSwitch(const ParameterSnapshot& outgoing, const ParameterSnapshot& incoming, bool spillTails)
+{
+    if (spillTails)
+    {
+        delaySpillSeconds = outgoing.delay.enabled && ! incoming.delay.enabled
+            ? DelayEffect::getTailSeconds(outgoing.delay.params, sampleRate) : 0.0;
+        reverbSpillSeconds = outgoing.reverb.enabled && ! incoming.reverb.enabled
+            ? ReverbEffect::getTailSeconds(outgoing.reverb.params, sampleRate) : 0.0;
+    }
+    else
+    {
+        delay.reset();
+        reverb.reset();
+        delaySpillSeconds = reverbSpillSeconds = 0.0;
+    }
+}
+
+void FXEngine::configure(const ParameterSnapshot& s)
+{
+    delay.reset();
+    reverb.reset();
+    oversampler.reset();
+    linearCascade.reset();
+    delaySpillSeconds = reverbSpillSeconds = 0.0;
+
+    for (auto* sleeper : { &chorusSleeper, &flangerSleeper, &phaserSleeper, &harmonizerSleeper,
+                           &stringSynthSleeper, &delaySleeper, &reverbSleeper })
+        sleeper->reset();
+
+    const int warmUpBlocks = juce::jmax(1, (int) std::ceil(warmUpSeconds * sampleRate / blockSize));
+    for (int i = 0; i < warmUpBlocks; ++i)
+    {
+        warmUpBuffer.clear();
+        process(warmUpBuffer, numChannels == 2, s, {});
+    }
+}
+
+void FXEngine::process(juce::AudioBuffer<float>& buffer, bool dualMono, const ParameterSnapshot& s, const BlockHooks& hooks)
+{
+#if JAGATFX_PROFILER
+    StageProfiler* const profiler = hooks.profiler;
+#endif
+    lastSnapshot = s;
+
+    const int numSamples = buffer.getNumSamples();
+
+    juce::AudioBuffer<float> monoView(buffer.getArrayOfWritePointers(), 1, numSamples);
+    juce::AudioBuffer<float>* chain = dualMono ? &monoView : &buffer;
+
+    // Jika masih mono, copy channel 0 ke channel 1 sebelum efek stereo
+    auto fanOutToStereo = [&]
+    {
+        if (dualMono)
+        {
+            buffer.copyFrom(1, 0, buffer, 0, 0, numSamples);
+            chain = &buffer;
+            dualMono = false;
+        }
+    };
+
+    // Metering costs two vector passes per module and block, and only when
+    // an editor is open to show it
+    MeterBank* const meters = hooks.meters;
+    const bool metering = meters != nullptr && meters->isEnabled();
+    if (metering)
+        meters->beginBlock(numSamples, sampleRate);
+
+    auto meter = [&](MeterBank::Meter m, bool enabled, const juce::AudioBuffer<float>& b, float gainReductionDb = 0.0f)
+    {
+        if (! metering)
+            return;
+
+        if (enabled)
+            meters->measure(m, b, gainReductionDb);
+        else
+            meters->clear(m);
+    };
+
+    // === Input Gain ===
+    chain->applyGain(juce::Decibels::decibelsToGain(s.inputGainDb));
+
+    // One detection pass for the gate, the compressor and the input meter
+    if (s.gate.enabled || s.comp.enabled || metering)
+        dynamicsSidechain.analyse(*chain);
+
+    if (metering)
+        meters->measure(MeterBank::input, dynamicsSidechain.getPeak(), dynamicsSidechain.getMeanSquare());
+
+    // === 1. NOISE GATE (with hold time for sustain) ===
+    if (s.gate.enabled)
+    {
+        JAGATFX_PROFILE_STAGE(gate);
+        if (changed(s.gate, applied.gate, gateModule))
+            noiseGate.setParameters(s.gate.params);
+        noiseGate.process(*chain, dynamicsSidechain);
+
+        // The compressor keys off the gated signal
+        if (s.comp.enabled)
+            dynamicsSidechain.applyGain(noiseGate.getGains());
+    }
+    meter(MeterBank::gate, s.gate.enabled, *chain, noiseGate.getGainReductionDb());
+
+    // === 2. PRE-EFFECTS: Compressor ===
+    if (s.comp.enabled)
+    {
+        JAGATFX_PROFILE_STAGE(comp);
+        if (changed(s.comp, applied.comp, compModule))
+            compressor.setParameters(s.comp.params);
+        compressor.process(*chain, dynamicsSidechain);
+    }
+    meter(MeterBank::comp, s.comp.enabled, *chain, compressor.getGainReductionDb());
+
+    // === OVERSAMPLED: Overdrive through Power Amp ===
+    auto& nonlinear = [&]() -> juce::AudioBuffer<float>&
+    {
+        JAGATFX_PROFILE_STAGE(oversampleUp);
+        syncChannels(oversampler, oversamplerStage, dualMono);
+        return oversampler.processUp(*chain);
+    }();
+
+    // === 2. PRE-EFFECTS: Overdrive ===
+    if (s.od.enabled)
+    {
+        JAGATFX_PROFILE_STAGE(overdrive);
+        if (changed(s.od, applied.od, odModule))
+            overdrive.setParameters(s.od.params);
+        syncChannels(overdrive, odModule, dualMono);
+        overdrive.process(nonlinear);
+    }
+    meter(MeterBank::overdrive, s.od.enabled, nonlinear);
+
+    // === 2. PRE-EFFECTS: Distortion ===
+    if (s.dist.enabled)
+    {
+        JAGATFX_PROFILE_STAGE(distortion);
+        if (changed(s.dist, applied.dist, distModule))
+            distortion.setParameters(s.dist.params);
+        syncChannels(distortion, distModule, dualMono);
+        distortion.process(nonlinear);
+    }
+    meter(MeterBank::distortion, s.dist.enabled, nonlinear);
+
+    // === 2. PRE-EFFECTS: High Gain Distortion ===
+    if (s.hg.enabled)
+    {
+        JAGATFX_PROFILE_STAGE(highGain);
+        if (changed(s.hg, applied.hg, hgModule))
+            highGainDist.setParameters(s.hg.params);
+        syncChannels(highGainDist, hgModule, dualMono);
+        highGainDist.process(nonlinear);
+    }
+    meter(MeterBank::highGain, s.hg.enabled, nonlinear);
+
+    // === 3. PREAMP (Waveshaper) ===
+    if (s.amp.enabled)
+    {
+        JAGATFX_PROFILE_STAGE(preamp);
+        if (changed(s.amp, applied.amp, ampModule))
+            preamp.setParameters(s.amp.params);
+        syncChannels(preamp, ampModule, dualMono);
+        preamp.process(nonlinear);
+    }
+
+    // === 4. TONE STACK ===
+    {
+        JAGATFX_PROFILE_STAGE(toneStack);
+        if (changed(s.toneStack, applied.toneStack, toneStackModule))
+            toneStack.setParameters(s.toneStack.params);
+        syncChannels(toneStack, toneStackModule, dualMono);
+        toneStack.process(nonlinear);
+    }
+
+    // === 5. POWER AMP ===
+    {
+        JAGATFX_PROFILE_STAGE(powerAmp);
+        if (changed(s.powerAmp, applied.powerAmp, powerAmpModule))
+            powerAmp.setParameters(s.powerAmp.params);
+        syncChannels(powerAmp, powerAmpModule, dualMono);
+        powerAmp.process(nonlinear);
+    }
+
+    {
+        JAGATFX_PROFILE_STAGE(oversampleDown);
+        oversampler.processDown(*chain);
+    }
+    meter(MeterBank::amp, true, *chain);
+
+    // === 6-7. CABINET, PARAMETRIC EQ, GRAPHIC EQ ===
+    // Filter cabs and both EQs are linear, so they run as one fused cascade;
+    // only an IR cab convolves on its own, ahead of the cascade
+    {
+        JAGATFX_PROFILE_STAGE(cabinetEQ);
+        linearCascade.begin();
+
+        if (s.cab.enabled)
+        {
+            if (changed(s.cab, applied.cab, cabModule))
+                cabinetSim.setParameters(s.cab.params);
+            if (cabinetSim.isStereo()) // Stereo custom IR
+                fanOutToStereo();
+            syncChannels(cabinetSim, cabModule, dualMono);
+
+            if (! cabinetSim.appendFilters(linearCascade))
+            {
+                linearCascade.skip(CabinetSim::numFilters);
+                cabinetSim.process(*chain);
+            }
+        }
+        else
+        {
+            linearCascade.skip(CabinetSim::numFilters);
+        }
+
+        if (s.peq.enabled)
+        {
+            if (changed(s.peq, applied.peq, peqModule))
+                parametricEQ.setParameters(s.peq.params);
+            parametricEQ.appendFilters(linearCascade);
+        }
+        else
+        {
+            linearCascade.skip(ParametricEQ::numBands);
+        }
+
+        if (s.geq.enabled)
+        {
+            if (changed(s.geq, applied.geq, geqModule))
+                graphicEQ.setParameters(s.geq.params);
+            graphicEQ.appendFilters(linearCascade);
+        }
+        else
+        {
+            linearCascade.skip(GraphicEQ::numBands);
+        }
+
+        syncChannels(linearCascade, linearCascadeStage, dualMono);
+        linearCascade.process(*chain);
+    }
+    meter(MeterBank::cabinetEQ, s.cab.enabled || s.peq.enabled || s.geq.enabled, *chain);
+
+    // === 7. POST-EFFECTS: Talk Box ===
+    if (s.talkBox.enabled)
+    {
+        JAGATFX_PROFILE_STAGE(talkBox);
+        if (changed(s.talkBox, applied.talkBox, talkBoxModule))
+            talkBox.setParameters(s.talkBox.params);
+        syncChannels(talkBox, talkBoxModule, dualMono);
+        talkBox.process(*chain);
+    }
+    meter(MeterBank::talkBox, s.talkBox.enabled, *chain);
+
+    // === 7. POST-EFFECTS: Auto Wah ===
+    if (s.autoWah.enabled)
+    {
+        JAGATFX_PROFILE_STAGE(autoWah);
+        if (changed(s.autoWah, applied.autoWah, autoWahModule))
+            autoWah.setParameters(s.autoWah.params);
+        syncChannels(autoWah, autoWahModule, dualMono);
+        autoWah.process(*chain);
+    }
+    meter(MeterBank::autoWah, s.autoWah.enabled, *chain);
+
+    // From here on every effect has a tail. Once a module's input has been
+    // silent for longer than that tail it sleeps: skipped, its block cleared,
+    // until the next non-silent block wakes it.
+    bool silent = TailSleeper::isSilent(*chain);
+
+    auto isAwake = [&](TailSleeper& sleeper, double tailSeconds)
+    {
+        if (sleeper.shouldProcess(silent, numSamples, tailSeconds, sampleRate))
+            return true;
+
+        chain->clear();
+        return false;
+    };
+
+    // A spilled tail: the module keeps its last settings, runs on silence,
+    // and is mixed into the chain until the tail has had time to decay
+    auto spillTail = [&](auto& module, TailSleeper& sleeper, double& tailSeconds)
+    {
+        if (tailSeconds > 0.0 && sleeper.shouldProcess(true, numSamples, tailSeconds, sampleRate))
+        {
+            jassert(numSamples <= spillBuffer.getNumSamples());
+            fanOutToStereo();
+            const int channels = chain->getNumChannels();
+            juce::AudioBuffer<float> tail(spillBuffer.getArrayOfWritePointers(), channels, numSamples);
+            tail.clear();
+            module.process(tail);
+
+            for (int ch = 0; ch < channels; ++ch)
+                chain->addFrom(ch, 0, tail, ch, 0, numSamples);
+            silent = TailSleeper::isSilent(*chain);
+            return;
+        }
+
+        tailSeconds = 0.0;
+        sleeper.reset();
+    };
+
+    // === 7. POST-EFFECTS: Chorus ===
+    if (! s.chorus.enabled)
+        chorusSleeper.reset();
+    else if (isAwake(chorusSleeper, Chorus::getTailSeconds(s.chorus.params, sampleRate)))
+    {
+        JAGATFX_PROFILE_STAGE(chorus);
+        fanOutToStereo(); // L/R LFOs are 90 degrees apart
+        if (changed(s.chorus, applied.chorus, chorusModule))
+            chorus.setParameters(s.chorus.params);
+        chorus.process(*chain);
+        silent = TailSleeper::isSilent(*chain);
+    }
+    meter(MeterBank::chorus, s.chorus.enabled, *chain);
+
+    // === 7. POST-EFFECTS: Flanger ===
+    if (! s.flanger.enabled)
+        flangerSleeper.reset();
+    else if (isAwake(flangerSleeper, Flanger::getTailSeconds(s.flanger.params, sampleRate)))
+    {
+        JAGATFX_PROFILE_STAGE(flanger);
+        if (changed(s.flanger, applied.flanger, flangerModule))
+            flanger.setParameters(s.flanger.params);
+        flanger.process(*chain);
+        silent = TailSleeper::isSilent(*chain);
+    }
+    meter(MeterBank::flanger, s.flanger.enabled, *chain);
+
+    // === 7. POST-EFFECTS: Phaser ===
+    if (! s.phaser.enabled)
+        phaserSleeper.reset();
+    else if (isAwake(phaserSleeper, Phaser::getTailSeconds(s.phaser.params, sampleRate)))
+    {
+        JAGATFX_PROFILE_STAGE(phaser);
+        if (changed(s.phaser, applied.phaser, phaserModule))
+            phaser.setParameters(s.phaser.params);
+        syncChannels(phaser, phaserModule, dualMono);
+        phaser.process(*chain);
+        silent = TailSleeper::isSilent(*chain);
+    }
+    meter(MeterBank::phaser, s.phaser.enabled, *chain);
+
+    // === 7. POST-EFFECTS: Harmonizer ===
+    if (! s.harmonizer.enabled)
+        harmonizerSleeper.reset();
+    else if (isAwake(harmonizerSleeper, Harmonizer::getTailSeconds(s.harmonizer.params, sampleRate)))
+    {
+        JAGATFX_PROFILE_STAGE(harmonizer);
+        if (changed(s.harmonizer, applied.harmonizer, harmonizerModule))
+            harmonizer.setParameters(s.harmonizer.params);
+        harmonizer.process(*chain);
+        silent = TailSleeper::isSilent(*chain);
+    }
+    meter(MeterBank::harmonizer, s.harmonizer.enabled, *chain);
+
+    // === 7. POST-EFFECTS: String Synth ===
+    if (! s.stringSynth.enabled)
+        stringSynthSleeper.reset();
+    else if (isAwake(stringSynthSleeper, StringSynth::getTailSeconds(s.stringSynth.params, sampleRate)))
+    {
+        JAGATFX_PROFILE_STAGE(stringSynth);
+        if (changed(s.stringSynth, applied.stringSynth, stringSynthModule))
+            stringSynth.setParameters(s.stringSynth.params);
+        stringSynth.process(*chain);
+        silent = TailSleeper::isSilent(*chain);
+    }
+    meter(MeterBank::stringSynth, s.stringSynth.enabled, *chain);
+
+    // Preset switch fade; ahead of delay and reverb when their tails spill over
+    if (hooks.fade != nullptr && hooks.fadeBeforeTails)
+        hooks.fade->applyFade(*chain);
+
+    // === 7. POST-EFFECTS: Delay ===
+    if (! s.delay.enabled)
+        spillTail(delay, delaySleeper, delaySpillSeconds);
+    else if (isAwake(delaySleeper, DelayEffect::getTailSeconds(s.delay.params, sampleRate)))
+    {
+        JAGATFX_PROFILE_STAGE(delay);
+        if (changed(s.delay, applied.delay, delayModule))
+            delay.setParameters(s.delay.params);
+        if (delay.isStereo()) // Ping-pong
+            fanOutToStereo();
+        delay.process(*chain);
+        silent = TailSleeper::isSilent(*chain);
+    }
+    meter(MeterBank::delay, s.delay.enabled, *chain);
+
+    // === 7. POST-EFFECTS: Reverb ===
+    if (! s.reverb.enabled)
+        spillTail(reverb, reverbSleeper, reverbSpillSeconds);
+    else if (isAwake(reverbSleeper, ReverbEffect::getTailSeconds(s.reverb.params, sampleRate)))
+    {
+        JAGATFX_PROFILE_STAGE(reverb);
+        fanOutToStereo();
+        if (changed(s.reverb, applied.reverb, reverbModule))
+            reverb.setParameters(s.reverb.params);
+        reverb.process(*chain);
+    }
+    meter(MeterBank::reverb, s.reverb.enabled, *chain);
+
+    if (hooks.fade != nullptr && ! hooks.fadeBeforeTails)
+        hooks.fade->applyFade(*chain);
+
+    // === Output Gain ===
+    chain->applyGain(juce::Decibels::decibelsToGain(s.outputGainDb));
+    meter(MeterBank::output, true, *chain);
+    fanOutToStereo();
+}
@@ -0,0 +1,200 @@
+#pragma once
+#include <JuceHeader.h>
+#include "DSP/NoiseGate.h"
+#include "DSP/Preamp.h"
+#include "DSP/ToneStack.h"
+#include "DSP/PowerAmp.h"
+#include "DSP/CabinetSim.h"
+#include "DSP/Overdrive.h"
+#include "DSP/Distortion.h"
+#include "DSP/HighGainDist.h"
+#include "DSP/Delay.h"
+#include "DSP/ReverbEffect.h"
+#include "DSP/Chorus.h"
+#include "DSP/Flanger.h"
+#include "DSP/Phaser.h"
+#include "DSP/Harmonizer.h"
+#include "DSP/StringSynth.h"
+#include "DSP/Compressor.h"
+#include "DSP/ParametricEQ.h"
+#include "DSP/GraphicEQ.h"
+#include "DSP/TalkBox.h"
+#include "DSP/AutoWah.h"
+#include "DSP/Oversampler.h"
+#include "DSP/FilterCascade.h"
+#include "DSP/LevelDetector.h"
+#include "DSP/TailSleeper.h"
+#include "DSP/Metering.h"
+#include "DSP/StageProfiler.h"
+#include "ParameterSnapshot.h"
+#include "PresetSwitcher.h"
+#include <cstring>
+#include <type_traits>
+
+/**
+ * FXEngine - One complete processing chain, input gain to output gain.
+ *
+ * The processor runs one engine live. With warm standby on it keeps more:
+ * the next preset is configured on a spare engine in the background, and a
+ * switch crossfades between two engines that are both already running
+ * (see EnginePool). Whoever owns an engine is the only thread that touches
+ * it; the custom IR and amp capture loaders are thread safe as before.
+ */
+class FXEngine
+{
+public:
+    /** Per-block extras from the processor; only the live engine gets them. */
+    struct BlockHooks
+    {
+        PresetSwitcher* fade = nullptr; // Single-engine switch dip, applied in the chain
+        bool fadeBeforeTails = true;    // Ahead of delay and reverb when tails spill over
+        MeterBank* meters = nullptr;
+        StageProfiler* profiler = nullptr;
+    };
+
+    void prepare(double sampleRate, int maximumBlockSize, int numChannels, int oversamplingStages);
+    void release();
+
+    /**
+     * Runs the chain on buffer in place. With dualMono, channel 1 holds a
+     * copy of channel 0 and only channel 0 is processed until a stage needs
+     * stereo; either way the buffer comes back with every channel filled.
+     */
+    void process(juce::AudioBuffer<float>& buffer, bool dualMono, const ParameterSnapshot& s, const BlockHooks& hooks);
+
+    /**
+     * The live preset changed within this engine (the single-engine dip, at
+     * silence). Delay and reverb tails either ring on, the ones the new
+     * preset turned off being fed silence until they decay, or are dropped.
+     */
+    void beginPresetSwitch(const ParameterSnapshot& outgoing, const ParameterSnapshot& incoming, bool spillTails);
+
+    /**
+     * Gets a spare engine ready to take over with the given settings, off the
+     * audio thread: clears every tail, computes the coefficients and runs
+     * a short stretch of silence so smoothers settle and every buffer the
+     * chain touches has been faulted in.
+     */
+    void configure(const ParameterSnapshot& s);
+
+    /** The settings the engine last ran or was configured with. */
+    const ParameterSnapshot& getSnapshot() const { return lastSnapshot; }
+
+    void loadCabinetIR(const juce::File& irFile) { cabinetSim.loadIR(irFile); }
+    bool loadAmpCapture(const juce::File& captureFile) { return preamp.loadCapture(captureFile); }
+
+    /**
+     * Message thread, with the audio suspended: re-prepares the oversampled
+     * stages. The factor is fixed between calls; process() ignores the
+     * snapshot's oversamplingStages.
+     */
+    void setOversamplingStages(int oversamplingStages) { prepareNonlinearStages(oversamplingStages); }
+
+    int getLatencySamples() const { return latencySamples; }
+
+    /** The time-based effects run in series, so their tails add up. */
+    static double getTailSeconds(const ParameterSnapshot& s, double sampleRate);
+
+private:
+    // Re-prepares the oversampled stages at the new rate
+    void prepareNonlinearStages(int oversamplingStages);
+
+    // Modules whose derived state (coefficients, ratios, scaled gains) is
+    // computed in their setters. A module's setParameters() only runs when
+    // its values differ from the ones it last applied, or it has been
+    // prepared since, so blocks where nothing moved do no coefficient math.
+    enum Module
+    {
+        gateModule, compModule, odModule, distModule, hgModule, ampModule, toneStackModule,
+        powerAmpModule, cabModule, peqModule, geqModule, talkBoxModule, autoWahModule,
+        chorusModule, flangerModule, phaserModule, harmonizerModule, stringSynthModule,
+        delayModule, reverbModule,
+        oversamplerStage, linearCascadeStage // Channel state only, see syncChannels()
+    };
+
+    static constexpr juce::uint32 nonlinearModules = (1u << odModule) | (1u << distModule) | (1u << hgModule)
+                                                   | (1u << ampModule) | (1u << toneStackModule) | (1u << powerAmpModule);
+
+    /** True, recording next as applied, if module has to take next's values. */
+    template <typename ParamsType>
+    bool changed(const ModuleSnapshot<ParamsType>& next, ModuleSnapshot<ParamsType>& applied, Module module)
+    {
+        static_assert(std::is_trivially_copyable<ParamsType>::value, "compared and copied bytewise");
+
+        const auto bit = 1u << module;
+        if ((staleModules & bit) == 0 && std::memcmp(&next.params, &applied.params, sizeof(ParamsType)) == 0)
+            return false;
+
+        // Bytewise, padding included, so the next compare sees exactly these bytes
+        std::memcpy(&applied.params, &next.params, sizeof(ParamsType));
+        staleModules &= ~bit;
+        return true;
+    }
+
+    /**
+     * Call before a stage with per-channel state runs on the chain. While
+     * the input is dual mono only channel 0 runs and channel 1's state
+     * freezes; the first stereo block starts channel 1 from channel 0's
+     * state instead, so it doesn't click when the channels diverge.
+     */
+    template <typename Stage>
+    void syncChannels(Stage& stage, Module module, bool dualMono)
+    {
+        const auto bit = 1u << module;
+        if (dualMono)
+        {
+            monoModules |= bit;
+        }
+        else if ((monoModules & bit) != 0)
+        {
+            stage.copyChannelState(0, 1);
+            monoModules &= ~bit;
+        }
+    }
+
+    NoiseGate noiseGate;
+    Compressor compressor;
+    Overdrive overdrive;
+    Distortion distortion;
+    HighGainDist highGainDist;
+    Preamp preamp;
+    ToneStack toneStack;
+    PowerAmp powerAmp;
+    CabinetSim cabinetSim;
+    Chorus chorus;
+    Flanger flanger;
+    Phaser phaser;
+    Harmonizer harmonizer;
+    StringSynth stringSynth;
+    DelayEffect delay;
+    ReverbEffect reverb;
+    ParametricEQ parametricEQ;
+    GraphicEQ graphicEQ;
+    TalkBox talkBox;
+    AutoWah autoWah;
+
+    // Peak and level of the chain input, shared by the gate and compressor
+    LevelDetector dynamicsSidechain;
+
+    Oversampler oversampler;
+    FilterCascade linearCascade; // Filter cab + parametric EQ + graphic EQ
+
+    // Silence tracking for the time-based effects
+    TailSleeper chorusSleeper, flangerSleeper, phaserSleeper, harmonizerSleeper,
+                stringSynthSleeper, delaySleeper, reverbSleeper;
+
+    // Tails a preset switch turned off, left to ring out (seconds, 0 = none)
+    double delaySpillSeconds = 0.0, reverbSpillSeconds = 0.0;
+    juce::AudioBuffer<float> spillBuffer;
+
+    ParameterSnapshot lastSnapshot;
+    ParameterSnapshot applied;          // Per module, the values its setters last saw
+    juce::uint32 staleModules = ~0u;    // Modules prepared since, whatever applied says
+    juce::uint32 monoModules = 0;       // Stages whose channel 1 state is behind channel 0's
+    double sampleRate = 44100.0;
+    int blockSize = 512, numChannels = 2;
+    int latencySamples = 0;
+
+    static constexpr double warmUpSeconds = 0.05;
+    juce::AudioBuffer<float> warmUpBuffer;
+};
@@ -0,0 +1,56 @@
+#pragma once
+#include <JuceHeader.h>
+#include "BinaryData.h"
+#include "PresetBank.h"
+
+/**
+ * FactoryPresets - The built-in tones, kept apart from the GUI so tools can
+ * apply them headless. Preset IDs are 1-based, as in the preset selector.
+ *
+ * The presets are written in Resources/FactoryPresets.txt and compiled by
+ * Tools/PresetBankCompiler into FactoryPresets.gfxbank, which is embedded as
+ * BinaryData and read in place. Every preset holds every parameter.
+ */
+struct FactoryPresets
+{
+    static const PresetBank& getBank()
+    {
+        static const PresetBank bank = []
+        {
+            PresetBank b;
+            const bool opened = b.openMemory(BinaryData::FactoryPresets_gfxbank, (size_t) BinaryData::FactoryPresets_gfxbankSize);
+            jassert(opened); // Rebuild FactoryPresets.gfxbank with Tools/PresetBankCompiler
+            juce::ignoreUnused(opened);
+            return b;
+        }();
+
+        return bank;
+    }
+
+    static int getNumPresets() { return getBank().getNumPresets(); }
+    static juce::StringArray getNames() { return getBank().getNames(); }
+
+    /** Copies the preset's values; O(parameters), no strings or allocation. */
+    static void build(ParameterValues& values, int presetId)
+    {
+        getBank().getValues(presetId - 1, values);
+    }
+
+    /** Writes a preset straight into the APVTS; for offline tools with no audio running. */
+    static void apply(juce::AudioProcessorValueTreeState& apvts, int presetId)
+    {
+        ParameterValues values;
+        for (int i = 0; i < Params::count; ++i)
+            values.set(static_cast<Params::Index>(i), apvts.getRawParameterValue(Params::ids[i])->load());
+
+        build(values, presetId);
+
+        for (int i = 0; i < Params::count; ++i)
+            if (auto* param = apvts.getParameter(Params::ids[i]))
+            {
+                const float normalised = param->convertTo0to1(values.get(static_cast<Params::Index>(i)));
+                if (normalised != param->getValue())
+                    param->setValueNotifyingHost(normalised);
+            }
+    }
+};
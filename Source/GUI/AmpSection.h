@@ -2,6 +2,7 @@
 #include <JuceHeader.h>
 #include "KnobComponent.h"
 #include "MarshallLookAndFeel.h"
+#include "LevelMeter.h"
 
 class AmpSection : public juce::Component
 {
@@ -12,11 +13,25 @@ public:
         // Amp model selector
         ampModelSelector.addItemList(
             juce::StringArray{"Clean", "Crunch", "High Gain", "Metal",
-                             "Fender Twin", "Marshall JCM", "Mesa Rectifier", "Soldano Lead"}, 1);
+                             "Fender Twin", "Marshall JCM", "Mesa Rectifier", "Soldano Lead", "Neural Capture"}, 1);
         addAndMakeVisible(ampModelSelector);
         ampModelAttach = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
             apvts, "ampModel", ampModelSelector);
 
+        // Neural capture loader (used by the "Neural Capture" amp model)
+        juce::File currentCapture(apvts.state.getProperty("ampCapturePath").toString());
+        loadCaptureButton.setButtonText(currentCapture.existsAsFile() ? currentCapture.getFileNameWithoutExtension() : "LOAD CAPTURE");
+        loadCaptureButton.setTooltip("Load a neural amp capture (LSTM/GRU/ConvNet, JSON or binary weights)");
+        loadCaptureButton.onClick = [this]() { chooseCaptureFile(); };
+        addAndMakeVisible(loadCaptureButton);
+
+        // Oversampling for the drive/amp stages
+        oversamplingSelector.addItemList(juce::StringArray{"Off", "2x", "4x", "8x"}, 1);
+        oversamplingSelector.setTooltip("Oversampling for the drive and amp stages (reduces aliasing, adds CPU)");
+        addAndMakeVisible(oversamplingSelector);
+        oversamplingAttach = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+            apvts, "oversampling", oversamplingSelector);
+
         // Cab model selector
         cabModelSelector.addItemList(
             juce::StringArray{"1x12 Open Back", "2x12 Closed", "4x12 V30", "4x12 Greenback", "Custom IR"}, 1);
@@ -30,6 +45,13 @@ public:
         micAttach = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
             apvts, "cabMic", micSelector);
 
+        // Custom IR loader (used by the "Custom IR" cab model)
+        juce::File currentIR(apvts.state.getProperty("cabIRPath").toString());
+        loadIRButton.setButtonText(currentIR.existsAsFile() ? currentIR.getFileNameWithoutExtension() : "LOAD IR");
+        loadIRButton.setTooltip("Load a cabinet impulse response (WAV/AIFF)");
+        loadIRButton.onClick = [this]() { chooseIRFile(); };
+        addAndMakeVisible(loadIRButton);
+
         // Amp controls (using bottom labels for Marshall style)
         inputGain = std::make_unique<KnobComponent>("BOOST", apvts, "inputGain", KnobComponent::LabelPosition::Bottom);
         ampGain = std::make_unique<KnobComponent>("PREAMP", apvts, "ampGain", KnobComponent::LabelPosition::Bottom);
@@ -82,6 +104,9 @@ public:
         cabLabel.setColour(juce::Label::textColourId, juce::Colour(0xFF0F3460));
         cabLabel.setJustificationType(juce::Justification::centred);
         addAndMakeVisible(cabLabel);
+
+        addAndMakeVisible(ampMeter);
+        addAndMakeVisible(cabMeter);
     }
 
     ~AmpSection() override
@@ -176,11 +201,16 @@ public:
         
         // Invisible toggle over the LED area
         ampBypass.setBounds(ampTop.removeFromLeft(30).removeFromTop(30));
+        ampMeter.setBounds(ampTop.removeFromLeft(4).reduced(0, 10));
         
         // Push dropdowns down into the gold area or keep in top
         ampTop.removeFromTop(10); // Spacer
         ampTop.removeFromRight(10); // Spacer
         ampModelSelector.setBounds(ampTop.removeFromRight(150).reduced(0, 4));
+        ampTop.removeFromRight(6); // Spacer
+        oversamplingSelector.setBounds(ampTop.removeFromRight(60).reduced(0, 4));
+        ampTop.removeFromRight(6); // Spacer
+        loadCaptureButton.setBounds(ampTop.removeFromRight(110).reduced(0, 4));
 
         // Knob row in bottom gold half
         auto knobArea = ampArea.reduced(4, 4);
@@ -201,17 +231,67 @@ public:
         
         cabBypass.setBounds(cabTop.removeFromLeft(24));
         cabLabel.setBounds(cabTop.removeFromLeft(80));
+        cabMeter.setBounds(cabArea.removeFromRight(10).reduced(3, 8));
 
         // Center the dropdowns nicely in the cab Area
         auto cabCenter = cabArea.reduced(10, 8);
         cabModelSelector.setBounds(cabCenter.removeFromTop(26).reduced(0, 2));
         cabCenter.removeFromTop(8); // gap
         micSelector.setBounds(cabCenter.removeFromTop(26).reduced(0, 2));
+        cabCenter.removeFromTop(8); // gap
+        loadIRButton.setBounds(cabCenter.removeFromTop(26).reduced(0, 2));
+    }
+
+    // Called from the editor timer. The cab meter reads the fused cab + EQ
+    // pass, since the EQs run inside the same filter cascade.
+    void updateMeters(const MeterBank& meters)
+    {
+        ampMeter.setReading(meters.getReading(MeterBank::amp));
+        cabMeter.setReading(meters.getReading(MeterBank::cabinetEQ));
     }
 
+    // Called with the chosen impulse response file
+    std::function<void(const juce::File&)> onIRFileChosen;
+
+    // Called with the chosen neural capture; returns false if it couldn't be loaded
+    std::function<bool(const juce::File&)> onCaptureFileChosen;
+
 private:
-    juce::ComboBox ampModelSelector, cabModelSelector, micSelector;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> ampModelAttach, cabModelAttach, micAttach;
+    void chooseIRFile()
+    {
+        fileChooser = std::make_unique<juce::FileChooser>("Load Cabinet IR",
+            juce::File::getSpecialLocation(juce::File::userDocumentsDirectory), "*.wav;*.aif;*.aiff");
+
+        fileChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+            [this](const juce::FileChooser& fc)
+            {
+                auto file = fc.getResult();
+                if (file != juce::File{})
+                {
+                    loadIRButton.setButtonText(file.getFileNameWithoutExtension());
+                    if (onIRFileChosen)
+                        onIRFileChosen(file);
+                }
+            });
+    }
+
+    void chooseCaptureFile()
+    {
+        fileChooser = std::make_unique<juce::FileChooser>("Load Neural Capture",
+            juce::File::getSpecialLocation(juce::File::userDocumentsDirectory), "*.json;*.nam;*.gfxn");
+
+        fileChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+            [this](const juce::FileChooser& fc)
+            {
+                auto file = fc.getResult();
+                if (file != juce::File{} && onCaptureFileChosen)
+                    loadCaptureButton.setButtonText(onCaptureFileChosen(file) ? file.getFileNameWithoutExtension()
+                                                                              : "INVALID CAPTURE");
+            });
+    }
+
+    juce::ComboBox ampModelSelector, oversamplingSelector, cabModelSelector, micSelector;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> ampModelAttach, oversamplingAttach, cabModelAttach, micAttach;
 
     std::unique_ptr<KnobComponent> inputGain, ampGain, bass, mid, treble, presence, resonance, master, outputGain;
 
@@ -219,6 +299,9 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> ampBypassAttach, cabBypassAttach;
 
     juce::Label cabLabel;
+    LevelMeter ampMeter, cabMeter;
+    juce::TextButton loadIRButton, loadCaptureButton;
+    std::unique_ptr<juce::FileChooser> fileChooser;
     
     MarshallLookAndFeel marshallLookAndFeel;
 };
@@ -1,6 +1,7 @@
 #pragma once
 #include <JuceHeader.h>
 #include "KnobComponent.h"
+#include "LevelMeter.h"
 
 class EffectSlot : public juce::Component
 {
@@ -38,6 +39,8 @@ public:
             addAndMakeVisible(*knob);
             knobs.push_back(std::move(knob));
         }
+
+        addAndMakeVisible(meter);
     }
 
     void setCompactMode(bool compact) 
@@ -57,6 +60,8 @@ public:
 
     std::function<void()> onClick;
 
+    void setMeter(const MeterReading& reading) { meter.setReading(reading); }
+
     void mouseDown(const juce::MouseEvent& e) override
     {
         // When the user clicks the pedal body (not the bypass toggle area)
@@ -146,9 +151,15 @@ public:
             
             bypassBtn.setAlpha(0.0f); 
             bypassBtn.setBounds(pillArea.toNearestInt());
+
+            // Meter to the right of the pedal icon
+            meter.setBounds(juce::Rectangle<float>(fBounds.getCentreX() + 21.0f, pillArea.getBottom() + 6.0f, 3.0f, 48.0f).toNearestInt());
             return;
         }
 
+        meter.setBounds(bounds.removeFromRight(4));
+        bounds.removeFromRight(2);
+
         // Toggle at top
         bypassBtn.setBounds(bounds.removeFromTop(28).reduced(2));
 
@@ -180,4 +191,5 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> modelAttach;
 
     std::vector<std::unique_ptr<KnobComponent>> knobs;
+    LevelMeter meter;
 };
@@ -0,0 +1,68 @@
+#pragma once
+#include <JuceHeader.h>
+#include "../DSP/Metering.h"
+
+// Thin vertical meter: RMS bar, peak tick and gain reduction hanging from the top
+class LevelMeter : public juce::Component
+{
+public:
+    LevelMeter() { setInterceptsMouseClicks(false, false); }
+
+    // Fed from the editor timer; only repaints when a bar actually moves
+    void setReading(const MeterReading& reading)
+    {
+        const Levels next { toSteps(reading.rms), toSteps(reading.peak),
+                            juce::jlimit(0, numSteps, juce::roundToInt(reading.gainReductionDb * numSteps / maxReductionDb)) };
+
+        if (next != levels)
+        {
+            levels = next;
+            repaint();
+        }
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto area = getLocalBounds().toFloat();
+        const float step = area.getHeight() / (float) numSteps;
+
+        g.setColour(juce::Colour(0xFF111118));
+        g.fillRect(area);
+
+        g.setColour(juce::Colour(0xFF43A047));
+        g.fillRect(area.withTop(area.getBottom() - levels.rms * step));
+
+        if (levels.peak > 0)
+        {
+            g.setColour(levels.peak >= numSteps ? juce::Colours::red : juce::Colour(0xFFFFD54F));
+            g.fillRect(area.withTop(area.getBottom() - levels.peak * step).withHeight(1.0f));
+        }
+
+        if (levels.reduction > 0)
+        {
+            g.setColour(juce::Colour(0xFFE53935));
+            g.fillRect(area.withHeight(levels.reduction * step));
+        }
+    }
+
+private:
+    static constexpr int numSteps = 64;
+    static constexpr float floorDb = -60.0f;
+    static constexpr float maxReductionDb = 24.0f;
+
+    struct Levels
+    {
+        int rms = 0, peak = 0, reduction = 0;
+        bool operator!=(const Levels& o) const { return rms != o.rms || peak != o.peak || reduction != o.reduction; }
+    };
+
+    static int toSteps(float gain)
+    {
+        const float db = juce::Decibels::gainToDecibels(gain, floorDb);
+        return juce::jlimit(0, numSteps, juce::roundToInt((db - floorDb) * numSteps / -floorDb));
+    }
+
+    Levels levels;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LevelMeter)
+};
@@ -179,6 +179,30 @@ public:
         };
     }
 
+    // Called from the editor timer
+    void updateMeters(const MeterBank& meters)
+    {
+        noiseGate->setMeter(meters.getReading(MeterBank::gate));
+        compressor->setMeter(meters.getReading(MeterBank::comp));
+        overdrive->setMeter(meters.getReading(MeterBank::overdrive));
+        distortion->setMeter(meters.getReading(MeterBank::distortion));
+        highGain->setMeter(meters.getReading(MeterBank::highGain));
+        autoWah->setMeter(meters.getReading(MeterBank::autoWah));
+        talkBox->setMeter(meters.getReading(MeterBank::talkBox));
+        chorus->setMeter(meters.getReading(MeterBank::chorus));
+        flanger->setMeter(meters.getReading(MeterBank::flanger));
+        phaser->setMeter(meters.getReading(MeterBank::phaser));
+        harmonizer->setMeter(meters.getReading(MeterBank::harmonizer));
+        stringSynth->setMeter(meters.getReading(MeterBank::stringSynth));
+        delay->setMeter(meters.getReading(MeterBank::delay));
+        reverb->setMeter(meters.getReading(MeterBank::reverb));
+
+        // Both EQs run inside the fused cabinet cascade, so they share its meter
+        const auto cabinetEQ = meters.getReading(MeterBank::cabinetEQ);
+        parametricEQ->setMeter(cabinetEQ);
+        graphicEQ->setMeter(cabinetEQ);
+    }
+
     void paint(juce::Graphics& g) override
     {
         // Pedalboard background (semi-transparent to show background image)
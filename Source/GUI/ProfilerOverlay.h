@@ -0,0 +1,124 @@
+#pragma once
+#include <JuceHeader.h>
+#include "../DSP/StageProfiler.h"
+
+// Live per-stage CPU table over the editor (JAGATFX_PROFILER builds only)
+class ProfilerOverlay : public juce::Component
+{
+public:
+    ProfilerOverlay(const StageProfiler& p) : profiler(p)
+    {
+        dumpButton.setButtonText("DUMP TO FILE");
+        dumpButton.setTooltip("Save the current timings as a text report for bug reports");
+        dumpButton.onClick = [this]() { chooseDumpFile(); };
+        addAndMakeVisible(dumpButton);
+    }
+
+    // Called from the editor timer; repaints only when the processor has published
+    void refresh()
+    {
+        auto next = profiler.getSnapshot();
+        if (next.publishCount != current.publishCount)
+        {
+            current = next;
+            repaint();
+        }
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat();
+        g.setColour(juce::Colour(0xE00A0A14));
+        g.fillRoundedRectangle(bounds, 6.0f);
+        g.setColour(juce::Colour(0xFF4488FF).withAlpha(0.6f));
+        g.drawRoundedRectangle(bounds.reduced(0.5f), 6.0f, 1.0f);
+
+        auto area = getLocalBounds().reduced(10);
+        auto header = area.removeFromTop(20);
+        g.setColour(juce::Colours::white);
+        g.setFont(juce::Font(13.0f, juce::Font::bold));
+        g.drawText("CPU PER STAGE", header, juce::Justification::centredLeft);
+
+        g.setFont(juce::Font(11.0f));
+        g.setColour(juce::Colour(0xFF8899AA));
+        g.drawText(juce::String(current.sampleRate / 1000.0, 1) + " kHz / " + juce::String(current.blockSize)
+                       + " smp / budget " + juce::String(current.budgetNs / 1000.0, 1) + " us",
+                   header.withTrimmedRight(dumpButton.getWidth() + 8), juce::Justification::centredRight);
+
+        area.removeFromTop(4);
+        const int rowHeight = juce::jmin(16, area.getHeight() / (StageProfiler::numStages + 1));
+        const auto columns = getColumns(area.getWidth());
+
+        auto drawRow = [&](juce::Rectangle<int> row, const juce::StringArray& cells)
+        {
+            for (int c = 0; c < cells.size(); ++c)
+                g.drawText(cells[c], row.removeFromLeft(columns[c]), c == 0 ? juce::Justification::centredLeft
+                                                                             : juce::Justification::centredRight);
+        };
+
+        g.setFont(juce::Font(11.0f, juce::Font::bold));
+        g.setColour(juce::Colour(0xFF8899AA));
+        drawRow(area.removeFromTop(rowHeight), { "Stage", "Min us", "Mean us", "P99 us", "Max us", "Mean %", "P99 %" });
+
+        g.setFont(juce::Font(11.0f));
+        for (int i = 0; i < StageProfiler::numStages; ++i)
+        {
+            const auto& st = current.stages[(size_t) i];
+            auto row = area.removeFromTop(rowHeight);
+            const float p99Percent = current.percentOfBudget(st.p99Ns);
+
+            // Bar behind the row shows the p99 share of the budget
+            g.setColour((p99Percent > 50.0f ? juce::Colour(0xFFE53935) : juce::Colour(0xFF1E88E5)).withAlpha(0.35f));
+            g.fillRect(row.withWidth(juce::roundToInt(row.getWidth() * juce::jlimit(0.0f, 1.0f, p99Percent / 100.0f))));
+
+            g.setColour(st.active ? juce::Colours::white : juce::Colour(0xFF555566));
+            drawRow(row, { StageProfiler::getStageName((StageProfiler::Stage) i),
+                           juce::String(st.minNs / 1000.0f, 1), juce::String(st.meanNs / 1000.0f, 1),
+                           juce::String(st.p99Ns / 1000.0f, 1), juce::String(st.maxNs / 1000.0f, 1),
+                           juce::String(current.percentOfBudget(st.meanNs), 2), juce::String(p99Percent, 2) });
+        }
+    }
+
+    void resized() override
+    {
+        dumpButton.setBounds(getLocalBounds().reduced(10).removeFromTop(20).removeFromRight(110));
+    }
+
+private:
+    static std::array<int, 7> getColumns(int width)
+    {
+        const int number = width / 9;
+        return { width - number * 6, number, number, number, number, number, number };
+    }
+
+    void chooseDumpFile()
+    {
+        fileChooser = std::make_unique<juce::FileChooser>("Save CPU Profile",
+            juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+                .getNonexistentChildFile("JagatFX-profile", ".txt"), "*.txt");
+
+        fileChooser->launchAsync(juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles
+                                     | juce::FileBrowserComponent::warnAboutOverwriting,
+            [this](const juce::FileChooser& fc)
+            {
+                auto file = fc.getResult();
+                if (file == juce::File{})
+                    return;
+
+                juce::String report;
+                report << "JAGAT MULTI FX CPU profile, " << juce::Time::getCurrentTime().toString(true, true) << "\n"
+                       << juce::SystemStats::getOperatingSystemName() << ", " << juce::SystemStats::getCpuModel() << "\n"
+                       << StageProfiler::formatReport(profiler.getSnapshot());
+
+                file.replaceWithText(report);
+            });
+    }
+
+    const StageProfiler& profiler;
+    StageProfiler::Snapshot current;
+
+    juce::TextButton dumpButton;
+    std::unique_ptr<juce::FileChooser> fileChooser;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProfilerOverlay)
+};
@@ -14,29 +14,29 @@ public:
         tunerAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
             processor.getAPVTS(), "tunerEnabled", tunerButton);
 
-        startTimerHz(30); // 30 fps refresh
+        updateDisplayState();
     }
 
     ~TunerComponent() override
     {
         stopTimer();
+        processor.tuner.setDisplayVisible(false);
     }
 
+    void visibilityChanged() override { updateDisplayState(); }
+    void parentHierarchyChanged() override { updateDisplayState(); }
+
     void timerCallback() override
     {
-        float freq = processor.currentTunerFreq.load(std::memory_order_relaxed);
+        auto reading = processor.tuner.getReading();
         
-        if (freq > 20.0f && freq < 2000.0f)
+        if (reading.note >= 0 && reading.frequency > 20.0f && reading.frequency < 2000.0f)
         {
-            // Calculate note and cents
-            // MIDI note 69 is A4 (440 Hz)
-            float pitchInSemitones = 12.0f * std::log2(freq / 440.0f) + 69.0f;
-            int midiNote = juce::roundToInt(pitchInSemitones);
-            currentCents = (pitchInSemitones - midiNote) * 100.0f;
+            currentCents = reading.cents;
             
             // Map to note name
             const char* notes[] = {"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
-            int noteIndex = midiNote % 12;
+            int noteIndex = reading.note % 12;
             if (noteIndex < 0) noteIndex += 12; // Safety
             
             currentNoteName = notes[noteIndex];
@@ -189,6 +189,18 @@ public:
     }
 
 private:
+    // Analysis (and this refresh timer) only run while the tuner is on screen
+    void updateDisplayState()
+    {
+        bool showing = isShowing();
+        processor.tuner.setDisplayVisible(showing);
+
+        if (showing && !isTimerRunning())
+            startTimerHz(30); // 30 fps refresh
+        else if (!showing && isTimerRunning())
+            stopTimer();
+    }
+
     GuitarMultiFXProcessor& processor;
 
     juce::String currentNoteName{ "-" };
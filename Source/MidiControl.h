@@ -0,0 +1,358 @@
+#pragma once
+#include <JuceHeader.h>
+#include "ParameterSnapshot.h"
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+/**
+ * MidiControl - MIDI program changes and controllers, handled inside
+ * processBlock from tables built on the message thread.
+ *
+ * Program change n recalls preset slot n (any channel) from a table of
+ * ready-made snapshots, so a footswitch changes the sound in the block the
+ * message arrives in. Controllers drive mapped parameters, each mapping
+ * with its own range and smoothing (choices and switches jump straight to
+ * the nearest step instead); the smoothed value overrides the parameter
+ * table until the message thread has written it back to the APVTS
+ * (takeControllerValues), so the host and editor follow along.
+ */
+class MidiControl
+{
+public:
+    static constexpr int maxMappings = 32;
+
+    struct Mapping
+    {
+        int controller = 0;                     // CC number, 0-127
+        int parameter = 0;                      // Params::Index
+        float minimum = 0.0f, maximum = 1.0f;   // Plain values at CC 0 and 127
+        float smoothingMs = 20.0f;
+        bool stepped = false;                   // Choice or switch: rounded, never smoothed (not saved)
+    };
+
+    /** A preset slot as the audio thread recalls it. */
+    struct Slot
+    {
+        ParameterValues values; // Snapped as stored, so EnginePool can match a standby
+        ParameterSnapshot snapshot;
+    };
+
+    using SlotTable = std::vector<Slot>;
+
+    ~MidiControl()
+    {
+        delete pendingSlots.exchange(nullptr);
+        delete retiredSlots.exchange(nullptr);
+        delete activeSlots;
+    }
+
+    //==============================================================================
+    // Message thread
+
+    /** Replaces the preset slots program changes recall; the audio thread adopts them next block. */
+    void setSlots(std::unique_ptr<SlotTable> table)
+    {
+        delete retiredSlots.exchange(nullptr);
+        delete pendingSlots.exchange(table.release()); // Drop any unclaimed table
+    }
+
+    /** Extra mappings past maxMappings are ignored. */
+    void setMappings(const std::vector<Mapping>& newMappings)
+    {
+        mappings.assign(newMappings.begin(), newMappings.begin() + juce::jmin((int) newMappings.size(), maxMappings));
+        ++generation;
+
+        auto& config = configs[(size_t) writeConfig];
+        config.numMappings = (int) mappings.size();
+        config.generation = generation;
+        std::copy(mappings.begin(), mappings.end(), config.mappings.begin());
+        writeConfig = middleConfig.exchange(writeConfig | newFlag, std::memory_order_acq_rel) & indexMask;
+    }
+
+    const std::vector<Mapping>& getMappings() const { return mappings; }
+
+    /** The slot and serial of a program change not yet handed over, if any. */
+    bool takeRecall(int& slot, juce::uint32& serial)
+    {
+        const auto latest = recallReport.load(std::memory_order_acquire);
+        if (latest == recallTaken)
+            return false;
+
+        recallTaken = latest;
+        serial = (juce::uint32) (latest >> 32);
+        slot = (int) (latest & 0xffffffff);
+        return true;
+    }
+
+    /** Calls write(Params::Index, value) for each controller target the APVTS doesn't hold yet. */
+    template <typename Write>
+    void takeControllerValues(Write&& write)
+    {
+        // Reports from before the last setMappings() belong to other parameters
+        if (adoptedGeneration.load(std::memory_order_acquire) != generation)
+            return;
+
+        for (int i = 0; i < (int) mappings.size(); ++i)
+        {
+            auto& report = reports[(size_t) i];
+            const auto latest = report.target.load(std::memory_order_acquire);
+            const auto serial = (juce::uint32) (latest >> 32);
+            if (serial == report.mirrored.load(std::memory_order_relaxed))
+                continue;
+
+            const auto bits = (juce::uint32) (latest & 0xffffffff);
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+
+            write(static_cast<Params::Index>(mappings[(size_t) i].parameter), value);
+            report.mirrored.store(serial, std::memory_order_release);
+        }
+    }
+
+    /** Mappings as text for the state tree: "cc parameterId minimum maximum ms", one per line. */
+    static juce::String toString(const std::vector<Mapping>& list)
+    {
+        juce::StringArray lines;
+        for (const auto& m : list)
+            lines.add(juce::String(m.controller) + " " + Params::ids[m.parameter] + " "
+                      + juce::String(m.minimum) + " " + juce::String(m.maximum) + " " + juce::String(m.smoothingMs));
+        return lines.joinIntoString("\n");
+    }
+
+    /** Skips lines that don't parse or name an unknown parameter. */
+    static std::vector<Mapping> fromString(const juce::String& text)
+    {
+        std::vector<Mapping> list;
+        for (const auto& line : juce::StringArray::fromLines(text))
+        {
+            const auto fields = juce::StringArray::fromTokens(line, false);
+            const int parameter = fields.size() == 5 ? Params::indexOf(fields[1].toRawUTF8()) : -1;
+            if (parameter < 0)
+                continue;
+
+            Mapping m;
+            m.controller = juce::jlimit(0, 127, fields[0].getIntValue());
+            m.parameter = parameter;
+            m.minimum = fields[2].getFloatValue();
+            m.maximum = fields[3].getFloatValue();
+            m.smoothingMs = juce::jmax(0.0f, fields[4].getFloatValue());
+            list.push_back(m);
+        }
+        return list;
+    }
+
+    //==============================================================================
+    // Audio thread
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        for (auto& c : controls)
+            c.active = false;
+    }
+
+    /**
+     * Reads the block's MIDI. Controllers retarget their mappings; returns
+     * the slot the last program change asks for, or nullptr.
+     */
+    const Slot* handleMidi(const juce::MidiBuffer& midi, int numSamples)
+    {
+        takePendingSlots();
+        takePendingConfig();
+        blockSamples = numSamples;
+
+        const Slot* recalled = nullptr;
+
+        for (const auto metadata : midi)
+        {
+            const auto message = metadata.getMessage();
+
+            if (message.isProgramChange())
+            {
+                const int slot = message.getProgramChangeNumber();
+                if (activeSlots != nullptr && slot < (int) activeSlots->size())
+                {
+                    recalled = &(*activeSlots)[(size_t) slot];
+                    recalledSlot = slot;
+                }
+            }
+            else if (message.isController())
+            {
+                const int cc = message.getControllerNumber();
+                const float position = (float) message.getControllerValue() / 127.0f;
+
+                for (int i = 0; i < config.numMappings; ++i)
+                {
+                    const auto& m = config.mappings[(size_t) i];
+                    if (m.controller != cc)
+                        continue;
+
+                    auto& c = controls[(size_t) i];
+                    c.target = m.minimum + position * (m.maximum - m.minimum);
+                    if (m.stepped)
+                        c.target = std::round(c.target);
+                    c.starting = c.starting || ! c.active;
+                    c.active = true;
+                    ++c.serial;
+                    report(i, c);
+                }
+            }
+        }
+
+        return recalled;
+    }
+
+    /** Reports the recall handleMidi() returned, with the serial PresetSwitcher gave it. */
+    void reportRecall(juce::uint32 serial)
+    {
+        recallReport.store(((juce::uint64) serial << 32) | (juce::uint32) recalledSlot, std::memory_order_release);
+    }
+
+    /** Fills the block's snapshot from the table, with controller overrides on top. */
+    void capture(const ParameterTable& table, ParameterSnapshot& s)
+    {
+        bool anyActive = false;
+        for (int i = 0; i < config.numMappings; ++i)
+            anyActive = anyActive || controls[(size_t) i].active;
+
+        if (! anyActive)
+        {
+            table.capture(s);
+            return;
+        }
+
+        table.copyValues(blockValues);
+
+        for (int i = 0; i < config.numMappings; ++i)
+        {
+            auto& c = controls[(size_t) i];
+            if (! c.active)
+                continue;
+
+            const auto& m = config.mappings[(size_t) i];
+            const auto index = static_cast<Params::Index>(m.parameter);
+
+            if (c.starting)
+            {
+                c.current = blockValues.get(index);
+                c.starting = false;
+            }
+
+            // One-pole toward the target, stepped once per block; a choice
+            // in between would be a different model (or a re-prepare)
+            if (m.stepped)
+            {
+                c.current = c.target;
+            }
+            else
+            {
+                const float samples = (float) sampleRate * m.smoothingMs * 0.001f;
+                const float coeff = samples > (float) blockSamples ? 1.0f - std::exp(-(float) blockSamples / samples) : 1.0f;
+                c.current += (c.target - c.current) * coeff;
+
+                if (std::abs(c.target - c.current) <= 1.0e-4f * std::abs(m.maximum - m.minimum))
+                    c.current = c.target;
+            }
+
+            blockValues.set(index, c.current);
+
+            // Settled and written back: the table carries it from here
+            if (c.current == c.target && reports[(size_t) i].mirrored.load(std::memory_order_acquire) == c.serial)
+                c.active = false;
+        }
+
+        captureParameters(blockValues, s);
+    }
+
+private:
+    struct Config
+    {
+        std::array<Mapping, maxMappings> mappings {};
+        int numMappings = 0;
+        juce::uint32 generation = 0;
+    };
+
+    struct Control
+    {
+        float target = 0.0f, current = 0.0f;
+        bool active = false, starting = false;
+        juce::uint32 serial = 0;
+    };
+
+    struct Report
+    {
+        std::atomic<juce::uint64> target { 0 };   // Serial << 32 | float bits
+        std::atomic<juce::uint32> mirrored { 0 };
+    };
+
+    void report(int i, const Control& c)
+    {
+        juce::uint32 bits;
+        std::memcpy(&bits, &c.target, sizeof(bits));
+        reports[(size_t) i].target.store(((juce::uint64) c.serial << 32) | bits, std::memory_order_release);
+    }
+
+    /** Swaps in a newly built slot table once the last one has been collected. */
+    void takePendingSlots()
+    {
+        if (pendingSlots.load() == nullptr)
+            return;
+
+        SlotTable* expected = nullptr;
+        if (activeSlots != nullptr && ! retiredSlots.compare_exchange_strong(expected, activeSlots))
+            return;
+
+        activeSlots = pendingSlots.exchange(nullptr);
+    }
+
+    void takePendingConfig()
+    {
+        if ((middleConfig.load(std::memory_order_acquire) & newFlag) == 0)
+            return;
+
+        readConfig = middleConfig.exchange(readConfig, std::memory_order_acq_rel) & indexMask;
+        config = configs[(size_t) readConfig];
+
+        // The old overrides let go; the table holds whatever was last written back
+        for (int i = 0; i < maxMappings; ++i)
+        {
+            controls[(size_t) i] = {};
+            reports[(size_t) i].target.store(0, std::memory_order_relaxed);
+            reports[(size_t) i].mirrored.store(0, std::memory_order_relaxed);
+        }
+
+        adoptedGeneration.store(config.generation, std::memory_order_release);
+    }
+
+    // Message thread
+    std::vector<Mapping> mappings;
+    juce::uint32 generation = 0;
+    juce::uint64 recallTaken = 0;
+    int writeConfig = 0;
+
+    // Mapping configs, through a triple buffer as in PresetSwitcher
+    static constexpr int indexMask = 3, newFlag = 4;
+    std::array<Config, 3> configs;
+    std::atomic<int> middleConfig { 1 };
+
+    std::atomic<SlotTable*> pendingSlots { nullptr };
+    std::atomic<SlotTable*> retiredSlots { nullptr };
+
+    // Audio thread reports, read by the message thread
+    std::array<Report, maxMappings> reports;
+    std::atomic<juce::uint64> recallReport { 0 };
+    std::atomic<juce::uint32> adoptedGeneration { 0 };
+
+    // Audio thread
+    int readConfig = 2;
+    Config config;
+    std::array<Control, maxMappings> controls {};
+    SlotTable* activeSlots = nullptr;
+    ParameterValues blockValues;
+    int recalledSlot = 0, blockSamples = 512;
+    double sampleRate = 44100.0;
+};
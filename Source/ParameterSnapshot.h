@@ -0,0 +1,248 @@
+#pragma once
+#include <JuceHeader.h>
+#include "Parameters.h"
+#include "DSP/NoiseGate.h"
+#include "DSP/Compressor.h"
+#include "DSP/Overdrive.h"
+#include "DSP/Distortion.h"
+#include "DSP/HighGainDist.h"
+#include "DSP/Preamp.h"
+#include "DSP/ToneStack.h"
+#include "DSP/PowerAmp.h"
+#include "DSP/CabinetSim.h"
+#include "DSP/Delay.h"
+#include "DSP/ReverbEffect.h"
+#include "DSP/Chorus.h"
+#include "DSP/Flanger.h"
+#include "DSP/Phaser.h"
+#include "DSP/Harmonizer.h"
+#include "DSP/StringSynth.h"
+#include "DSP/ParametricEQ.h"
+#include "DSP/GraphicEQ.h"
+#include "DSP/TalkBox.h"
+#include "DSP/AutoWah.h"
+#include <array>
+#include <atomic>
+
+/**
+ * ModuleSnapshot - Enabled flag plus the module's own Parameters struct,
+ * kept on its own cache line so one module's values never share a line
+ * with its neighbour.
+ */
+template <typename ParamsType>
+struct alignas(64) ModuleSnapshot
+{
+    bool enabled = true;
+    ParamsType params;
+};
+
+/**
+ * ParameterSnapshot - Plain copy of every parameter for one audio block.
+ * Filled once at the top of processBlock, then handed to each module.
+ */
+struct ParameterSnapshot
+{
+    float inputGainDb = 0.0f;
+    float outputGainDb = 0.0f;
+    int oversamplingStages = 0; // 0 = off, 1 = 2x, 2 = 4x, 3 = 8x
+    bool tunerEnabled = false;
+
+    ModuleSnapshot<NoiseGate::Parameters> gate;
+    ModuleSnapshot<Compressor::Parameters> comp;
+    ModuleSnapshot<Overdrive::Parameters> od;
+    ModuleSnapshot<Distortion::Parameters> dist;
+    ModuleSnapshot<HighGainDist::Parameters> hg;
+    ModuleSnapshot<Preamp::Parameters> amp;
+    ModuleSnapshot<ToneStack::Parameters> toneStack;
+    ModuleSnapshot<PowerAmp::Parameters> powerAmp;
+    ModuleSnapshot<CabinetSim::Parameters> cab;
+    ModuleSnapshot<DelayEffect::Parameters> delay;
+    ModuleSnapshot<ReverbEffect::Parameters> reverb;
+    ModuleSnapshot<Chorus::Parameters> chorus;
+    ModuleSnapshot<Flanger::Parameters> flanger;
+    ModuleSnapshot<Phaser::Parameters> phaser;
+    ModuleSnapshot<Harmonizer::Parameters> harmonizer;
+    ModuleSnapshot<StringSynth::Parameters> stringSynth;
+    ModuleSnapshot<ParametricEQ::Parameters> peq;
+    ModuleSnapshot<GraphicEQ::Parameters> geq;
+    ModuleSnapshot<TalkBox::Parameters> talkBox;
+    ModuleSnapshot<AutoWah::Parameters> autoWah;
+};
+
+/** Fills just the session-wide settings (see Params::numGlobals). */
+template <typename Source>
+void captureGlobals(const Source& source, ParameterSnapshot& s)
+{
+    using namespace Params;
+
+    s.inputGainDb = source.get(inputGain);
+    s.outputGainDb = source.get(outputGain);
+    s.oversamplingStages = static_cast<int>(source.get(oversampling));
+    s.tunerEnabled = source.get(tunerEnabled) > 0.5f;
+}
+
+/**
+ * Fills a snapshot from any source with get(Params::Index): the live
+ * parameter table on the audio thread, or a prebuilt preset.
+ */
+template <typename Source>
+void captureParameters(const Source& source, ParameterSnapshot& s)
+{
+    using namespace Params;
+
+    auto get = [&source](Index index) { return source.get(index); };
+    auto getBool = [&get](Index index) { return get(index) > 0.5f; };
+    auto getChoice = [&get](Index index) { return static_cast<int>(get(index)); };
+
+    captureGlobals(source, s);
+
+    s.gate.enabled = getBool(gateEnabled);
+    s.gate.params.thresholdDb = get(gateThreshold);
+    s.gate.params.attackMs = get(gateAttack);
+    s.gate.params.releaseMs = get(gateRelease);
+
+    s.comp.enabled = getBool(compEnabled);
+    s.comp.params.model = getChoice(compModel);
+    s.comp.params.threshold = get(compThreshold);
+    s.comp.params.ratio = get(compRatio);
+    s.comp.params.attack = get(compAttack);
+    s.comp.params.release = get(compRelease);
+    s.comp.params.makeup = get(compMakeup);
+
+    s.od.enabled = getBool(odEnabled);
+    s.od.params.model = getChoice(odModel);
+    s.od.params.drive = get(odDrive);
+    s.od.params.tone = get(odTone);
+    s.od.params.level = get(odLevel);
+
+    s.dist.enabled = getBool(distEnabled);
+    s.dist.params.model = getChoice(distModel);
+    s.dist.params.gain = get(distGain);
+    s.dist.params.tone = get(distTone);
+    s.dist.params.level = get(distLevel);
+
+    s.hg.enabled = getBool(hgEnabled);
+    s.hg.params.model = getChoice(hgModel);
+    s.hg.params.gain = get(hgGain);
+    s.hg.params.tone = get(hgTone);
+    s.hg.params.level = get(hgLevel);
+    s.hg.params.tight = getBool(hgTight);
+
+    s.amp.enabled = getBool(ampEnabled);
+    s.amp.params.model = getChoice(ampModel);
+    s.amp.params.gain = get(ampGain);
+    s.amp.params.channelVolume = get(ampChannel);
+
+    // Tone stack and power amp have no bypass switch
+    s.toneStack.params.bass = get(tsBass);
+    s.toneStack.params.mid = get(tsMid);
+    s.toneStack.params.treble = get(tsTreble);
+
+    s.powerAmp.params.presence = get(paPresence);
+    s.powerAmp.params.resonance = get(paResonance);
+    s.powerAmp.params.master = get(paMaster);
+
+    s.cab.enabled = getBool(cabEnabled);
+    s.cab.params.model = getChoice(cabModel);
+    s.cab.params.micPosition = getChoice(cabMic);
+
+    s.delay.enabled = getBool(delayEnabled);
+    s.delay.params.model = getChoice(delayModel);
+    s.delay.params.timeMs = get(delayTime);
+    s.delay.params.feedback = get(delayFeedback);
+    s.delay.params.mix = get(delayMix);
+    s.delay.params.modulation = get(delayMod);
+
+    s.reverb.enabled = getBool(reverbEnabled);
+    s.reverb.params.model = getChoice(reverbModel);
+    s.reverb.params.size = get(reverbSize);
+    s.reverb.params.damping = get(reverbDamping);
+    s.reverb.params.preDelayMs = get(reverbPreDelay);
+    s.reverb.params.mix = get(reverbMix);
+
+    s.chorus.enabled = getBool(chorusEnabled);
+    s.chorus.params.rate = get(chorusRate);
+    s.chorus.params.depth = get(chorusDepth);
+    s.chorus.params.mix = get(chorusMix);
+
+    s.flanger.enabled = getBool(flangerEnabled);
+    s.flanger.params.rate = get(flangerRate);
+    s.flanger.params.depth = get(flangerDepth);
+    s.flanger.params.feedback = get(flangerFeedback);
+    s.flanger.params.mix = get(flangerMix);
+
+    s.phaser.enabled = getBool(phaserEnabled);
+    s.phaser.params.rate = get(phaserRate);
+    s.phaser.params.depth = get(phaserDepth);
+    s.phaser.params.feedback = get(phaserFeedback);
+    s.phaser.params.stages = getChoice(phaserStages);
+    s.phaser.params.mix = get(phaserMix);
+
+    s.harmonizer.enabled = getBool(harmEnabled);
+    s.harmonizer.params.interval = getChoice(harmInterval);
+    s.harmonizer.params.mix = get(harmMix);
+
+    s.stringSynth.enabled = getBool(stringEnabled);
+    s.stringSynth.params.attackMs = get(stringAttack);
+    s.stringSynth.params.octaveMix = get(stringOctave);
+    s.stringSynth.params.brightness = get(stringBrightness);
+    s.stringSynth.params.resonance = get(stringResonance);
+    s.stringSynth.params.mix = get(stringMix);
+
+    // Parametric EQ IDs are laid out freq/gain/Q per band
+    s.peq.enabled = getBool(peqEnabled);
+    for (int band = 0; band < 4; ++band)
+    {
+        const int base = peqFreq0 + band * 3;
+        s.peq.params.bands[band].freq = get(static_cast<Index>(base));
+        s.peq.params.bands[band].gainDb = get(static_cast<Index>(base + 1));
+        s.peq.params.bands[band].q = get(static_cast<Index>(base + 2));
+    }
+
+    s.geq.enabled = getBool(geqEnabled);
+    for (int band = 0; band < 10; ++band)
+        s.geq.params.gainsDb[band] = get(static_cast<Index>(geqBand0 + band));
+
+    s.talkBox.enabled = getBool(talkEnabled);
+    s.talkBox.params.vowel = get(talkVowel);
+    s.talkBox.params.mix = get(talkMix);
+
+    s.autoWah.enabled = getBool(autoWahEnabled);
+    s.autoWah.params.sensitivity = get(autoWahSens);
+    s.autoWah.params.attackMs = get(autoWahAttack);
+    s.autoWah.params.releaseMs = get(autoWahRelease);
+    s.autoWah.params.range = get(autoWahRange);
+}
+
+/**
+ * ParameterTable - Resolves every APVTS raw value pointer once, indexed by
+ * Params::Index, so the audio thread never builds or hashes an ID string.
+ */
+class ParameterTable
+{
+public:
+    explicit ParameterTable(juce::AudioProcessorValueTreeState& apvts)
+    {
+        for (int i = 0; i < Params::count; ++i)
+        {
+            values[(size_t) i] = apvts.getRawParameterValue(Params::ids[i]);
+            jassert(values[(size_t) i] != nullptr); // Params::ids out of sync with the layout
+        }
+    }
+
+    float get(Params::Index index) const { return values[(size_t) index]->load(std::memory_order_relaxed); }
+    bool getBool(Params::Index index) const { return get(index) > 0.5f; }
+    int getChoice(Params::Index index) const { return static_cast<int>(get(index)); }
+
+    void capture(ParameterSnapshot& s) const { captureParameters(*this, s); }
+
+    /** Current value of every parameter, e.g. as the base a preset is built on. */
+    void copyValues(ParameterValues& v) const
+    {
+        for (int i = 0; i < Params::count; ++i)
+            v.set(static_cast<Params::Index>(i), get(static_cast<Params::Index>(i)));
+    }
+
+private:
+    std::array<std::atomic<float>*, Params::count> values {};
+};
@@ -0,0 +1,172 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Params - Fixed index table for every plugin parameter.
+ * Order matches createParameterLayout(), so each parameter can be addressed
+ * by integer index instead of a string lookup. Deliberately JUCE-free so
+ * standalone tools can include it.
+ */
+namespace Params
+{
+    enum Index : int
+    {
+        // Master
+        inputGain, outputGain, oversampling,
+        // Tuner
+        tunerEnabled,
+        // Noise gate
+        gateEnabled, gateThreshold, gateAttack, gateRelease,
+        // Compressor
+        compEnabled, compModel, compThreshold, compRatio, compAttack, compRelease, compMakeup,
+        // Overdrive
+        odEnabled, odModel, odDrive, odTone, odLevel,
+        // Distortion
+        distEnabled, distModel, distGain, distTone, distLevel,
+        // High gain distortion
+        hgEnabled, hgModel, hgGain, hgTone, hgLevel, hgTight,
+        // Preamp
+        ampEnabled, ampModel, ampGain, ampChannel,
+        // Tone stack
+        tsBass, tsMid, tsTreble,
+        // Power amp
+        paPresence, paResonance, paMaster,
+        // Cabinet
+        cabEnabled, cabModel, cabMic,
+        // Delay
+        delayEnabled, delayModel, delayTime, delayFeedback, delayMix, delayMod,
+        // Reverb
+        reverbEnabled, reverbModel, reverbSize, reverbDamping, reverbPreDelay, reverbMix,
+        // Chorus
+        chorusEnabled, chorusRate, chorusDepth, chorusMix,
+        // Flanger
+        flangerEnabled, flangerRate, flangerDepth, flangerFeedback, flangerMix,
+        // Phaser
+        phaserEnabled, phaserRate, phaserDepth, phaserFeedback, phaserStages, phaserMix,
+        // Harmonizer
+        harmEnabled, harmInterval, harmMix,
+        // String synth
+        stringEnabled, stringAttack, stringOctave, stringBrightness, stringResonance, stringMix,
+        // Parametric EQ (freq, gain, Q per band)
+        peqEnabled,
+        peqFreq0, peqGain0, peqQ0,
+        peqFreq1, peqGain1, peqQ1,
+        peqFreq2, peqGain2, peqQ2,
+        peqFreq3, peqGain3, peqQ3,
+        // Graphic EQ
+        geqEnabled,
+        geqBand0, geqBand1, geqBand2, geqBand3, geqBand4,
+        geqBand5, geqBand6, geqBand7, geqBand8, geqBand9,
+        // Talk box
+        talkEnabled, talkVowel, talkMix,
+        // Auto wah
+        autoWahEnabled, autoWahSens, autoWahAttack, autoWahRelease, autoWahRange,
+
+        count
+    };
+
+    inline constexpr const char* ids[count] = {
+        "inputGain", "outputGain", "oversampling",
+        "tunerEnabled",
+        "gateEnabled", "gateThreshold", "gateAttack", "gateRelease",
+        "compEnabled", "compModel", "compThreshold", "compRatio", "compAttack", "compRelease", "compMakeup",
+        "odEnabled", "odModel", "odDrive", "odTone", "odLevel",
+        "distEnabled", "distModel", "distGain", "distTone", "distLevel",
+        "hgEnabled", "hgModel", "hgGain", "hgTone", "hgLevel", "hgTight",
+        "ampEnabled", "ampModel", "ampGain", "ampChannel",
+        "tsBass", "tsMid", "tsTreble",
+        "paPresence", "paResonance", "paMaster",
+        "cabEnabled", "cabModel", "cabMic",
+        "delayEnabled", "delayModel", "delayTime", "delayFeedback", "delayMix", "delayMod",
+        "reverbEnabled", "reverbModel", "reverbSize", "reverbDamping", "reverbPreDelay", "reverbMix",
+        "chorusEnabled", "chorusRate", "chorusDepth", "chorusMix",
+        "flangerEnabled", "flangerRate", "flangerDepth", "flangerFeedback", "flangerMix",
+        "phaserEnabled", "phaserRate", "phaserDepth", "phaserFeedback", "phaserStages", "phaserMix",
+        "harmEnabled", "harmInterval", "harmMix",
+        "stringEnabled", "stringAttack", "stringOctave", "stringBrightness", "stringResonance", "stringMix",
+        "peqEnabled",
+        "peqFreq0", "peqGain0", "peqQ0",
+        "peqFreq1", "peqGain1", "peqQ1",
+        "peqFreq2", "peqGain2", "peqQ2",
+        "peqFreq3", "peqGain3", "peqQ3",
+        "geqEnabled",
+        "geqBand0", "geqBand1", "geqBand2", "geqBand3", "geqBand4",
+        "geqBand5", "geqBand6", "geqBand7", "geqBand8", "geqBand9",
+        "talkEnabled", "talkVowel", "talkMix",
+        "autoWahEnabled", "autoWahSens", "autoWahAttack", "autoWahRelease", "autoWahRange"
+    };
+
+    /**
+     * The master settings at the front of the table (gains, oversampling,
+     * tuner) belong to the session, not to a preset: recalling a bank preset
+     * leaves them where they are.
+     */
+    inline constexpr int numGlobals = tunerEnabled + 1;
+
+    inline constexpr bool isGlobal(int index) { return index < numGlobals; }
+
+    /** Index for a parameter ID, or -1. Linear search: not for the audio thread. */
+    inline int indexOf(const char* id)
+    {
+        for (int i = 0; i < count; ++i)
+            if (std::strcmp(ids[i], id) == 0)
+                return i;
+        return -1;
+    }
+
+    /** Key for an ID in saved state (32-bit FNV-1a): stable however the table is reordered. */
+    constexpr std::uint32_t hashOf(const char* id)
+    {
+        std::uint32_t hash = 2166136261u;
+        for (; *id != 0; ++id)
+            hash = (hash ^ (std::uint8_t) *id) * 16777619u;
+        return hash;
+    }
+
+    /** Index for a hashOf() key, or -1; tries the given index first. */
+    inline int indexOfHash(std::uint32_t hash, int likelyIndex = -1)
+    {
+        static const auto hashes = []
+        {
+            std::array<std::uint32_t, count> h {};
+            for (int i = 0; i < count; ++i)
+                h[(size_t) i] = hashOf(ids[i]);
+            return h;
+        }();
+
+        if (likelyIndex >= 0 && likelyIndex < count && hashes[(size_t) likelyIndex] == hash)
+            return likelyIndex;
+
+        for (int i = 0; i < count; ++i)
+            if (hashes[(size_t) i] == hash)
+                return i;
+        return -1;
+    }
+}
+
+/**
+ * ParameterValues - Plain (denormalised) value of every parameter, indexed
+ * by Params::Index: a complete preset, built away from the audio thread.
+ */
+struct ParameterValues
+{
+    std::array<float, Params::count> values {};
+
+    float get(Params::Index index) const { return values[(size_t) index]; }
+    void set(Params::Index index, float value) { values[(size_t) index] = value; }
+
+    /** Takes the session-wide settings (see Params::numGlobals) from current. */
+    void keepGlobals(const ParameterValues& current)
+    {
+        std::copy_n(current.values.begin(), Params::numGlobals, values.begin());
+    }
+
+    /** Same preset, whatever the session-wide settings. */
+    bool isSamePreset(const ParameterValues& other) const
+    {
+        return std::equal(values.begin() + Params::numGlobals, values.end(), other.values.begin() + Params::numGlobals);
+    }
+};
@@ -4,7 +4,6 @@
 GuitarMultiFXEditor::GuitarMultiFXEditor(GuitarMultiFXProcessor& p)
     : AudioProcessorEditor(&p),
       processorRef(p),
-      presetPanel(p.getAPVTS()),
       tunerComponent(p),
       ampSection(p.getAPVTS()),
       pedalBoard(p.getAPVTS())
@@ -17,6 +16,26 @@ GuitarMultiFXEditor::GuitarMultiFXEditor(GuitarMultiFXProcessor& p)
     addAndMakeVisible(pedalBoard);
 
     presetPanel.onLicenseClicked = [this]() { showActivationDialog(); };
+    presetPanel.onPresetChosen = [this](int slot) { processorRef.loadPresetSlot(slot); };
+    presetPanel.onSpilloverChanged = [this](bool shouldSpill) { processorRef.setPresetSpillover(shouldSpill); };
+    presetPanel.onStandbyChanged = [this](int count) { processorRef.setStandbyEngines(count); };
+    presetPanel.onUserBankChosen = [this](const juce::File& file)
+    {
+        if (processorRef.loadUserBank(file))
+            presetPanel.setPresetNames(processorRef.getPresetSlotNames());
+    };
+    presetPanel.onSaveToUserBank = [this](const juce::File& file, const juce::String& name)
+    {
+        if (processorRef.saveToUserBank(file, name))
+            presetPanel.setPresetNames(processorRef.getPresetSlotNames());
+    };
+    presetPanel.onSavePresetFile = [this](const juce::File& file) { processorRef.savePresetFile(file); };
+    presetPanel.onLoadPresetFile = [this](const juce::File& file) { processorRef.loadPresetFile(file); };
+    presetPanel.setPresetNames(processorRef.getPresetSlotNames());
+    presetPanel.setSpillover(processorRef.getPresetSpillover());
+    presetPanel.setStandbyEngines(processorRef.getStandbyEngines());
+    ampSection.onIRFileChosen = [this](const juce::File& file) { processorRef.loadCabinetIR(file); };
+    ampSection.onCaptureFileChosen = [this](const juce::File& file) { return processorRef.loadAmpCapture(file); };
 
     // Trial banner (hidden by default)
     trialBanner.setFont(juce::Font(12.0f, juce::Font::bold));
@@ -26,6 +45,21 @@ GuitarMultiFXEditor::GuitarMultiFXEditor(GuitarMultiFXProcessor& p)
     trialBanner.setVisible(false);
     addAndMakeVisible(trialBanner);
 
+#if JAGATFX_PROFILER
+    profilerOverlay = std::make_unique<ProfilerOverlay>(processorRef.profiler);
+    addChildComponent(*profilerOverlay);
+
+    cpuButton.setButtonText("CPU");
+    cpuButton.setTooltip("Show per-stage processing time");
+    cpuButton.setClickingTogglesState(true);
+    cpuButton.onClick = [this]()
+    {
+        profilerOverlay->setVisible(cpuButton.getToggleState());
+        profilerOverlay->toFront(false);
+    };
+    addAndMakeVisible(cpuButton);
+#endif
+
     // Load background image
     backgroundImage = juce::ImageCache::getFromMemory(
         BinaryData::guitar_bg_png, BinaryData::guitar_bg_pngSize);
@@ -37,13 +71,30 @@ GuitarMultiFXEditor::GuitarMultiFXEditor(GuitarMultiFXProcessor& p)
 
     // Check license on startup
     checkLicenseStatus();
+
+    // The processor only measures levels while an editor is watching
+    processorRef.meters.addViewer();
+    startTimerHz(30);
 }
 
 GuitarMultiFXEditor::~GuitarMultiFXEditor()
 {
+    stopTimer();
+    processorRef.meters.removeViewer();
     setLookAndFeel(nullptr);
 }
 
+void GuitarMultiFXEditor::timerCallback()
+{
+    pedalBoard.updateMeters(processorRef.meters);
+    ampSection.updateMeters(processorRef.meters);
+
+#if JAGATFX_PROFILER
+    if (profilerOverlay->isVisible())
+        profilerOverlay->refresh();
+#endif
+}
+
 void GuitarMultiFXEditor::parentHierarchyChanged()
 {
     if (auto* dw = dynamic_cast<juce::DocumentWindow*>(getTopLevelComponent()))
@@ -208,9 +259,14 @@ void GuitarMultiFXEditor::resized()
     bounds.removeFromTop(6); // spacing
 
     // Top-Mid: Tuner Component (small band)
-    tunerComponent.setBounds(bounds.removeFromTop(45).withSizeKeepingCentre(400, 45));
+    auto tunerBand = bounds.removeFromTop(45);
+    tunerComponent.setBounds(tunerBand.withSizeKeepingCentre(400, 45));
     bounds.removeFromTop(6);
 
+#if JAGATFX_PROFILER
+    cpuButton.setBounds(tunerBand.removeFromRight(60).reduced(4, 10));
+#endif
+
     // Middle: Amp section (~30% of remaining to give PedalBoard more space)
     int ampHeight = (int)((float)bounds.getHeight() * 0.30f);
     ampSection.setBounds(bounds.removeFromTop(ampHeight));
@@ -218,4 +274,8 @@ void GuitarMultiFXEditor::resized()
 
     // Bottom: Pedal board (remaining space)
     pedalBoard.setBounds(bounds);
+
+#if JAGATFX_PROFILER
+    profilerOverlay->setBounds(bounds.withSizeKeepingCentre(juce::jmin(bounds.getWidth(), 640), bounds.getHeight()));
+#endif
 }
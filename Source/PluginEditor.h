@@ -8,8 +8,10 @@
 #include "GUI/PresetPanel.h"
 #include "GUI/TunerComponent.h"
 #include "GUI/ActivationDialog.h"
+#include "GUI/ProfilerOverlay.h"
 
-class GuitarMultiFXEditor : public juce::AudioProcessorEditor
+class GuitarMultiFXEditor : public juce::AudioProcessorEditor,
+                            private juce::Timer
 {
 public:
     explicit GuitarMultiFXEditor(GuitarMultiFXProcessor&);
@@ -20,6 +22,8 @@ public:
     void parentHierarchyChanged() override;
 
 private:
+    void timerCallback() override; // Meter refresh
+
     void checkLicenseStatus();
     void showActivationDialog();
     void hideActivationDialog();
@@ -44,5 +48,11 @@ private:
     // Trial banner
     juce::Label trialBanner;
 
+#if JAGATFX_PROFILER
+    // CPU overlay toggle (profiling builds only)
+    juce::TextButton cpuButton;
+    std::unique_ptr<ProfilerOverlay> profilerOverlay;
+#endif
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GuitarMultiFXEditor)
 };
@@ -1,5 +1,9 @@
 #include "PluginProcessor.h"
-#include "PluginEditor.h"
+#include "FactoryPresets.h"
+#include "SessionState.h"
+#if ! JAGATFX_HEADLESS
+ #include "PluginEditor.h"
+#endif
 
 GuitarMultiFXProcessor::GuitarMultiFXProcessor()
     : AudioProcessor(BusesProperties()
@@ -7,9 +11,14 @@ GuitarMultiFXProcessor::GuitarMultiFXProcessor()
         .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
       apvts(*this, nullptr, "Parameters", createParameterLayout())
 {
+    updateMidiSlots();
+    startTimerHz(30);
 }
 
-GuitarMultiFXProcessor::~GuitarMultiFXProcessor() {}
+GuitarMultiFXProcessor::~GuitarMultiFXProcessor()
+{
+    stopTimer();
+}
 
 juce::AudioProcessorValueTreeState::ParameterLayout GuitarMultiFXProcessor::createParameterLayout()
 {
@@ -20,6 +29,9 @@ juce::AudioProcessorValueTreeState::ParameterLayout GuitarMultiFXProcessor::crea
         juce::ParameterID("inputGain", 1), "Input Gain", juce::NormalisableRange<float>(-24.0f, 24.0f, 0.1f), 0.0f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID("outputGain", 1), "Output Gain", juce::NormalisableRange<float>(-60.0f, 12.0f, 0.1f), 0.0f));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("oversampling", 1), "Oversampling",
+        juce::StringArray{"Off", "2x", "4x", "8x"}, 1));
 
     // ===== TUNER =====
     params.push_back(std::make_unique<juce::AudioParameterBool>(
@@ -92,9 +104,12 @@ juce::AudioProcessorValueTreeState::ParameterLayout GuitarMultiFXProcessor::crea
     // ===== PREAMP =====
     params.push_back(std::make_unique<juce::AudioParameterBool>(
         juce::ParameterID("ampEnabled", 1), "Amp On", true));
+    // New models go on the end only: presets and sessions store the index,
+    // so earlier ones keep theirs (host automation, being normalised, shifts)
     params.push_back(std::make_unique<juce::AudioParameterChoice>(
         juce::ParameterID("ampModel", 1), "Amp Model",
-        juce::StringArray{"Clean", "Crunch", "High Gain", "Metal", "Fender Twin", "Marshall JCM", "Mesa Rectifier"}, 0));
+        juce::StringArray{"Clean", "Crunch", "High Gain", "Metal", "Fender Twin", "Marshall JCM", "Mesa Rectifier",
+                          "Soldano Lead", "Neural Capture"}, 0));
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID("ampGain", 1), "Amp Gain", juce::NormalisableRange<float>(0.0f, 10.0f, 0.01f), 5.0f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
@@ -269,319 +284,550 @@ juce::AudioProcessorValueTreeState::ParameterLayout GuitarMultiFXProcessor::crea
 }
 
 const juce::String GuitarMultiFXProcessor::getName() const { return JucePlugin_Name; }
-bool GuitarMultiFXProcessor::acceptsMidi() const { return false; }
+bool GuitarMultiFXProcessor::acceptsMidi() const { return true; }
 bool GuitarMultiFXProcessor::producesMidi() const { return false; }
 bool GuitarMultiFXProcessor::isMidiEffect() const { return false; }
-double GuitarMultiFXProcessor::getTailLengthSeconds() const { return 2.0; }
-int GuitarMultiFXProcessor::getNumPrograms() { return 1; }
-int GuitarMultiFXProcessor::getCurrentProgram() { return 0; }
-void GuitarMultiFXProcessor::setCurrentProgram(int) {}
-const juce::String GuitarMultiFXProcessor::getProgramName(int) { return {}; }
+
+// Host programs are the preset slots, as for MIDI program change
+int GuitarMultiFXProcessor::getNumPrograms() { return juce::jmax(1, FactoryPresets::getNumPresets() + userBank.getNumPresets()); }
+int GuitarMultiFXProcessor::getCurrentProgram() { return juce::jmax(0, lastPresetSlot); }
+void GuitarMultiFXProcessor::setCurrentProgram(int index) { loadPresetSlot(index); }
+const juce::String GuitarMultiFXProcessor::getProgramName(int index) { return getPresetSlotNames()[index]; }
 void GuitarMultiFXProcessor::changeProgramName(int, const juce::String&) {}
 
+double GuitarMultiFXProcessor::getTailLengthSeconds() const
+{
+    ParameterSnapshot s;
+    parameterTable.capture(s);
+
+    return FXEngine::getTailSeconds(s, getSampleRate() > 0.0 ? getSampleRate() : 44100.0);
+}
+
 void GuitarMultiFXProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
-    spec.numChannels = static_cast<juce::uint32>(getTotalNumOutputChannels());
-
-    noiseGate.prepare(spec);
-    compressor.prepare(spec);
-    overdrive.prepare(spec);
-    distortion.prepare(spec);
-    highGainDist.prepare(spec);
-    preamp.prepare(spec);
-    toneStack.prepare(spec);
-    powerAmp.prepare(spec);
-    cabinetSim.prepare(spec);
-    chorus.prepare(spec);
-    flanger.prepare(spec);
-    phaser.prepare(spec);
-    harmonizer.prepare(spec);
-    stringSynth.prepare(spec);
-    delay.prepare(spec);
-    reverb.prepare(spec);
-    parametricEQ.prepare(spec);
-    graphicEQ.prepare(spec);
-    talkBox.prepare(spec);
-    autoWah.prepare(spec);
+    enginePool.prepare(sampleRate, samplesPerBlock, getTotalNumOutputChannels(), parameterTable.getChoice(Params::oversampling));
+    setLatencySamples(enginePool.getLatencySamples());
     tuner.prepare(sampleRate);
+
+    presetSwitcher.prepare(sampleRate);
+    midiControl.prepare(sampleRate);
 }
 
-void GuitarMultiFXProcessor::releaseResources() {}
+void GuitarMultiFXProcessor::releaseResources()
+{
+    tuner.release();
+    enginePool.release();
+}
 
-bool GuitarMultiFXProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+void GuitarMultiFXProcessor::loadCabinetIR(const juce::File& irFile)
 {
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-        && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
-        return false;
+    if (! irFile.existsAsFile())
+        return;
 
-    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+    // Stored on the state tree so it is saved with the session
+    apvts.state.setProperty(cabIRPathProperty, irFile.getFullPathName(), nullptr);
+    enginePool.loadCabinetIR(irFile);
+}
+
+bool GuitarMultiFXProcessor::loadAmpCapture(const juce::File& captureFile)
+{
+    if (! enginePool.loadAmpCapture(captureFile))
         return false;
 
+    apvts.state.setProperty(ampCapturePathProperty, captureFile.getFullPathName(), nullptr);
     return true;
 }
 
-void GuitarMultiFXProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+void GuitarMultiFXProcessor::applyPreset(const ParameterValues& preset)
 {
-    juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
+    // Whatever MIDI changed is written back first, so this preset lands on top
+    mirrorMidiChanges();
 
-    // Jika input Mono dan output Stereo, copy sinyal channel 0 ke channel 1 agar efek stereo berfungsi
-    if (totalNumInputChannels == 1 && totalNumOutputChannels == 2)
+    const auto values = snapToParameters(preset);
+
+    ParameterSnapshot next;
+    captureParameters(values, next);
+
+    // A warm standby engine (or a free one, configured here) takes over with
+    // a crossfade; without one the live engine switches under the fade
+    const int engine = enginePool.claim(values, next, presetSwitcher.getNextPostSerial());
+
+    presetSwitcher.beginParameterWrites();
+    presetSwitcher.post(next, engine);
+    writeParameters(values);
+    presetSwitcher.endParameterWrites();
+}
+
+void GuitarMultiFXProcessor::writeParameters(const ParameterValues& values)
+{
+    // Only parameters that actually change notify the host and listeners
+    for (int i = 0; i < Params::count; ++i)
     {
-        buffer.copyFrom(1, 0, buffer, 0, 0, buffer.getNumSamples());
-    }
-    else
-    {
-        // Bersihkan channel output sisanya agar tidak bising
-        for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-            buffer.clear(i, 0, buffer.getNumSamples());
+        auto* param = apvts.getParameter(Params::ids[i]);
+        const float normalised = param->convertTo0to1(values.get(static_cast<Params::Index>(i)));
+        if (normalised != param->getValue())
+            param->setValueNotifyingHost(normalised);
     }
+}
 
-    // Process tuner independently of input gain and effects
-    if (totalNumInputChannels > 0)
+void GuitarMultiFXProcessor::mirrorMidiChanges()
+{
+    // A program change the audio thread has already switched to
+    int slot = 0;
+    juce::uint32 serial = 0;
+    if (midiControl.takeRecall(slot, serial))
     {
-        tuner.processBlock(buffer.getReadPointer(0), buffer.getNumSamples());
-        currentTunerFreq.store(tuner.getFrequency(), std::memory_order_relaxed);
+        ParameterValues values;
+        if (getSlotValues(slot, values))
+        {
+            writeParameters(snapToParameters(values));
+            updateStandbyTargets(slot);
+        }
+
+        presetSwitcher.setRecallMirrored(serial);
     }
 
-    // Check if tuner is enabled to mute everything else
-    if (*apvts.getRawParameterValue("tunerEnabled") > 0.5f)
+    midiControl.takeControllerValues([this](Params::Index index, float value)
     {
-        for (auto i = 0; i < totalNumOutputChannels; ++i)
-            buffer.clear(i, 0, buffer.getNumSamples());
-        return; // Don't process other effects, mute sound
-    }
+        auto* param = apvts.getParameter(Params::ids[index]);
+        param->setValueNotifyingHost(param->convertTo0to1(value));
+    });
+}
 
-    // === Input Gain ===
-    float inputGainDb = *apvts.getRawParameterValue("inputGain");
-    float inputGain = juce::Decibels::decibelsToGain(inputGainDb);
-    buffer.applyGain(inputGain);
+void GuitarMultiFXProcessor::updateMidiSlots()
+{
+    auto table = std::make_unique<MidiControl::SlotTable>((size_t) (FactoryPresets::getNumPresets() + userBank.getNumPresets()));
 
-    // === 1. NOISE GATE (with hold time for sustain) ===
-    if (*apvts.getRawParameterValue("gateEnabled") > 0.5f)
+    for (size_t i = 0; i < table->size(); ++i)
     {
-        noiseGate.setThreshold(*apvts.getRawParameterValue("gateThreshold"));
-        noiseGate.setAttack(*apvts.getRawParameterValue("gateAttack"));
-        noiseGate.setRelease(*apvts.getRawParameterValue("gateRelease"));
-        noiseGate.process(buffer);
+        auto& slot = (*table)[i];
+        getSlotValues((int) i, slot.values);
+        slot.values = snapToParameters(slot.values);
+        captureParameters(slot.values, slot.snapshot);
     }
 
-    // === 2. PRE-EFFECTS: Compressor ===
-    if (*apvts.getRawParameterValue("compEnabled") > 0.5f)
-    {
-        compressor.setModel(static_cast<int>(*apvts.getRawParameterValue("compModel")));
-        compressor.setThreshold(*apvts.getRawParameterValue("compThreshold"));
-        compressor.setRatio(*apvts.getRawParameterValue("compRatio"));
-        compressor.setAttack(*apvts.getRawParameterValue("compAttack"));
-        compressor.setRelease(*apvts.getRawParameterValue("compRelease"));
-        compressor.setMakeup(*apvts.getRawParameterValue("compMakeup"));
-        compressor.process(buffer);
-    }
+    midiControl.setSlots(std::move(table));
+}
 
-    // === 2. PRE-EFFECTS: Overdrive ===
-    if (*apvts.getRawParameterValue("odEnabled") > 0.5f)
+void GuitarMultiFXProcessor::setMidiMappings(const std::vector<MidiControl::Mapping>& mappings)
+{
+    // Each mapping stays inside its parameter's range; choices and switches step
+    auto checked = mappings;
+    for (auto& m : checked)
     {
-        overdrive.setModel(static_cast<int>(*apvts.getRawParameterValue("odModel")));
-        overdrive.setDrive(*apvts.getRawParameterValue("odDrive"));
-        overdrive.setTone(*apvts.getRawParameterValue("odTone"));
-        overdrive.setLevel(*apvts.getRawParameterValue("odLevel"));
-        overdrive.process(buffer);
+        auto* param = apvts.getParameter(Params::ids[m.parameter]);
+        const auto& range = param->getNormalisableRange();
+        m.minimum = juce::jlimit(range.start, range.end, m.minimum);
+        m.maximum = juce::jlimit(range.start, range.end, m.maximum);
+        m.stepped = param->isDiscrete() || param->isBoolean();
     }
 
-    // === 2. PRE-EFFECTS: Distortion ===
-    if (*apvts.getRawParameterValue("distEnabled") > 0.5f)
-    {
-        distortion.setModel(static_cast<int>(*apvts.getRawParameterValue("distModel")));
-        distortion.setGain(*apvts.getRawParameterValue("distGain"));
-        distortion.setTone(*apvts.getRawParameterValue("distTone"));
-        distortion.setLevel(*apvts.getRawParameterValue("distLevel"));
-        distortion.process(buffer);
-    }
+    midiControl.setMappings(checked);
+    apvts.state.setProperty(midiMappingsProperty, MidiControl::toString(midiControl.getMappings()), nullptr);
+}
 
-    // === 2. PRE-EFFECTS: High Gain Distortion ===
-    if (*apvts.getRawParameterValue("hgEnabled") > 0.5f)
+ParameterValues GuitarMultiFXProcessor::snapToParameters(const ParameterValues& values) const
+{
+    // Snap each value the way the parameter will store it, so the snapshot
+    // the audio thread switches to is exactly what the table reads afterwards
+    ParameterValues snapped;
+    for (int i = 0; i < Params::count; ++i)
     {
-        highGainDist.setModel(static_cast<int>(*apvts.getRawParameterValue("hgModel")));
-        highGainDist.setGain(*apvts.getRawParameterValue("hgGain"));
-        highGainDist.setTone(*apvts.getRawParameterValue("hgTone"));
-        highGainDist.setLevel(*apvts.getRawParameterValue("hgLevel"));
-        highGainDist.setTight(*apvts.getRawParameterValue("hgTight") > 0.5f);
-        highGainDist.process(buffer);
+        const auto index = static_cast<Params::Index>(i);
+        auto* param = apvts.getParameter(Params::ids[i]);
+        snapped.set(index, param->convertFrom0to1(param->convertTo0to1(values.get(index))));
     }
+    return snapped;
+}
 
-    // === 3. PREAMP (Waveshaper) ===
-    if (*apvts.getRawParameterValue("ampEnabled") > 0.5f)
+ParameterValues GuitarMultiFXProcessor::getDefaultValues() const
+{
+    ParameterValues values;
+    for (int i = 0; i < Params::count; ++i)
     {
-        preamp.setModel(static_cast<int>(*apvts.getRawParameterValue("ampModel")));
-        preamp.setGain(*apvts.getRawParameterValue("ampGain"));
-        preamp.setChannelVolume(*apvts.getRawParameterValue("ampChannel"));
-        preamp.process(buffer);
+        auto* param = apvts.getParameter(Params::ids[i]);
+        values.set(static_cast<Params::Index>(i), param->convertFrom0to1(param->getDefaultValue()));
     }
+    return values;
+}
 
-    // === 4. TONE STACK ===
-    toneStack.setBass(*apvts.getRawParameterValue("tsBass"));
-    toneStack.setMid(*apvts.getRawParameterValue("tsMid"));
-    toneStack.setTreble(*apvts.getRawParameterValue("tsTreble"));
-    toneStack.process(buffer);
+juce::StringArray GuitarMultiFXProcessor::getPresetSlotNames() const
+{
+    auto names = FactoryPresets::getNames();
+    names.addArray(userBank.getNames());
+    return names;
+}
 
-    // === 5. POWER AMP ===
-    powerAmp.setPresence(*apvts.getRawParameterValue("paPresence"));
-    powerAmp.setResonance(*apvts.getRawParameterValue("paResonance"));
-    powerAmp.setMaster(*apvts.getRawParameterValue("paMaster"));
-    powerAmp.process(buffer);
+bool GuitarMultiFXProcessor::getSlotValues(int slot, ParameterValues& values) const
+{
+    // Start from defaults so a bank without some parameter still recalls one sound
+    values = getDefaultValues();
+    const int numFactory = FactoryPresets::getNumPresets();
+
+    if (juce::isPositiveAndBelow(slot, numFactory))
+        FactoryPresets::build(values, slot + 1);
+    else if (juce::isPositiveAndBelow(slot - numFactory, userBank.getNumPresets()))
+        userBank.getValues(slot - numFactory, values);
+    else
+        return false;
 
-    // === 6. CABINET (IR Convolution) ===
-    if (*apvts.getRawParameterValue("cabEnabled") > 0.5f)
-    {
-        cabinetSim.setModel(static_cast<int>(*apvts.getRawParameterValue("cabModel")));
-        cabinetSim.setMicPosition(static_cast<int>(*apvts.getRawParameterValue("cabMic")));
-        cabinetSim.process(buffer);
-    }
+    // Gains, oversampling and the tuner stay as the session has them
+    ParameterValues current;
+    parameterTable.copyValues(current);
+    values.keepGlobals(current);
+    return true;
+}
 
-    // === 7. POST-EFFECTS: Parametric EQ ===
-    if (*apvts.getRawParameterValue("peqEnabled") > 0.5f)
-    {
-        for (int i = 0; i < 4; ++i)
+void GuitarMultiFXProcessor::loadPresetSlot(int slot)
+{
+    ParameterValues values;
+    if (! getSlotValues(slot, values))
+        return;
+
+    applyPreset(values);
+    updateStandbyTargets(slot);
+}
+
+void GuitarMultiFXProcessor::updateStandbyTargets(int slot)
+{
+    const int numSlots = FactoryPresets::getNumPresets() + userBank.getNumPresets();
+
+    // Stepping back (or wrapping round to the last slot) makes the previous slot the likelier next one
+    const bool wrappedBack = lastPresetSlot == 0 && slot == numSlots - 1;
+    const bool wrappedForward = lastPresetSlot == numSlots - 1 && slot == 0;
+    const int step = (slot < lastPresetSlot && ! wrappedForward) || wrappedBack ? -1 : 1;
+    lastPresetSlot = slot;
+
+    std::array<ParameterValues, EnginePool::maxStandby> targets;
+    int numTargets = 0;
+
+    for (const int neighbour : { slot + step, slot - step })
+        if (numTargets < enginePool.getStandbyCount()
+            && getSlotValues((neighbour + numSlots) % numSlots, targets[(size_t) numTargets]))
         {
-            auto idx = juce::String(i);
-            parametricEQ.setBand(i,
-                *apvts.getRawParameterValue("peqFreq" + idx),
-                *apvts.getRawParameterValue("peqGain" + idx),
-                *apvts.getRawParameterValue("peqQ" + idx));
+            targets[(size_t) numTargets] = snapToParameters(targets[(size_t) numTargets]);
+            ++numTargets;
         }
-        parametricEQ.process(buffer);
-    }
 
-    // === 7. POST-EFFECTS: Graphic EQ ===
-    if (*apvts.getRawParameterValue("geqEnabled") > 0.5f)
+    enginePool.setTargets(targets.data(), numTargets);
+}
+
+bool GuitarMultiFXProcessor::loadUserBank(const juce::File& bankFile)
+{
+    if (! userBank.openFile(bankFile))
+        return false;
+
+    apvts.state.setProperty(userBankPathProperty, bankFile.getFullPathName(), nullptr);
+    updateMidiSlots();
+    updateHostDisplay();
+    return true;
+}
+
+bool GuitarMultiFXProcessor::saveToUserBank(const juce::File& bankFile, const juce::String& presetName)
+{
+    // Keep what the file already holds, then add the current settings
+    juce::StringArray names;
+    std::vector<ParameterValues> presets;
     {
-        for (int i = 0; i < 10; ++i)
+        PresetBank existing;
+        if (bankFile.existsAsFile() && existing.openFile(bankFile))
         {
-            graphicEQ.setBand(i, *apvts.getRawParameterValue("geqBand" + juce::String(i)));
+            for (int i = 0; i < existing.getNumPresets(); ++i)
+            {
+                presets.push_back(getDefaultValues());
+                existing.getValues(i, presets.back());
+                names.add(existing.getName(i));
+            }
         }
-        graphicEQ.process(buffer);
     }
 
-    // === 7. POST-EFFECTS: Talk Box ===
-    if (*apvts.getRawParameterValue("talkEnabled") > 0.5f)
+    presets.emplace_back();
+    parameterTable.copyValues(presets.back());
+    names.add(presetName);
+
+    // The file may be the open user bank, which maps it
+    const juce::File openBank(apvts.state.getProperty(userBankPathProperty).toString());
+    userBank.close();
+
+    juce::TemporaryFile temp(bankFile);
+    bool written = false;
     {
-        talkBox.setVowel(*apvts.getRawParameterValue("talkVowel"));
-        talkBox.setMix(*apvts.getRawParameterValue("talkMix"));
-        talkBox.process(buffer);
+        juce::FileOutputStream out(temp.getFile());
+        written = out.openedOk() && PresetBank::write(out, names, presets);
     }
 
-    // === 7. POST-EFFECTS: Auto Wah ===
-    if (*apvts.getRawParameterValue("autoWahEnabled") > 0.5f)
+    if (written && temp.overwriteTargetFileWithTemporary())
+        return loadUserBank(bankFile);
+
+    if (openBank.existsAsFile())
+        userBank.openFile(openBank);
+    updateMidiSlots();
+    return false;
+}
+
+bool GuitarMultiFXProcessor::savePresetFile(const juce::File& file)
+{
+    // Parameters only: the IR, capture and options belong to the session
+    ParameterValues values;
+    parameterTable.copyValues(values);
+
+    juce::MemoryBlock data;
     {
-        autoWah.setParameters(
-            *apvts.getRawParameterValue("autoWahSens"),
-            *apvts.getRawParameterValue("autoWahAttack"),
-            *apvts.getRawParameterValue("autoWahRelease"),
-            *apvts.getRawParameterValue("autoWahRange"));
-        autoWah.process(buffer);
+        juce::MemoryOutputStream out(data, false);
+        SessionState::write(out, values, {});
     }
 
-    // === 7. POST-EFFECTS: Chorus ===
-    if (*apvts.getRawParameterValue("chorusEnabled") > 0.5f)
+    return file.replaceWithData(data.getData(), data.getSize());
+}
+
+bool GuitarMultiFXProcessor::loadPresetFile(const juce::File& file)
+{
+    juce::MemoryBlock data;
+    if (! file.loadFileAsData(data))
+        return false;
+
+    auto values = getDefaultValues();
+    juce::NamedValueSet properties;
+
+    if (! SessionState::read(data.getData(), data.getSize(), values, properties))
     {
-        chorus.setRate(*apvts.getRawParameterValue("chorusRate"));
-        chorus.setDepth(*apvts.getRawParameterValue("chorusDepth"));
-        chorus.setMix(*apvts.getRawParameterValue("chorusMix"));
-        chorus.process(buffer);
+        // Preset files saved as XML state
+        auto xml = juce::parseXML(file);
+        if (xml == nullptr || ! readXmlState(*xml, values, properties))
+            return false;
     }
 
-    // === 7. POST-EFFECTS: Flanger ===
-    if (*apvts.getRawParameterValue("flangerEnabled") > 0.5f)
+    applyPreset(values);
+    return true;
+}
+
+void GuitarMultiFXProcessor::setPresetSpillover(bool shouldSpill)
+{
+    presetSwitcher.setSpillover(shouldSpill);
+    apvts.state.setProperty(presetSpilloverProperty, shouldSpill, nullptr);
+}
+
+void GuitarMultiFXProcessor::timerCallback()
+{
+    mirrorMidiChanges();
+    updateOversampling();
+}
+
+void GuitarMultiFXProcessor::updateOversampling()
+{
+    const int stages = parameterTable.getChoice(Params::oversampling);
+    if (stages == enginePool.getOversamplingStages())
+        return;
+
+    const bool wasSuspended = isSuspended();
+    suspendProcessing(true);
+    enginePool.setOversamplingStages(stages);
+    setLatencySamples(enginePool.getLatencySamples());
+    suspendProcessing(wasSuspended);
+}
+
+void GuitarMultiFXProcessor::setStandbyEngines(int count)
+{
+    // Engines are created and freed here, so the audio callback has to wait
+    if (count != enginePool.getStandbyCount())
     {
-        flanger.setRate(*apvts.getRawParameterValue("flangerRate"));
-        flanger.setDepth(*apvts.getRawParameterValue("flangerDepth"));
-        flanger.setFeedback(*apvts.getRawParameterValue("flangerFeedback"));
-        flanger.setMix(*apvts.getRawParameterValue("flangerMix"));
-        flanger.process(buffer);
+        const bool wasSuspended = isSuspended();
+        suspendProcessing(true);
+        enginePool.setStandbyCount(count);
+        suspendProcessing(wasSuspended);
     }
 
-    // === 7. POST-EFFECTS: Phaser ===
-    if (*apvts.getRawParameterValue("phaserEnabled") > 0.5f)
+    apvts.state.setProperty(standbyEnginesProperty, enginePool.getStandbyCount(), nullptr);
+
+    if (lastPresetSlot >= 0)
+        updateStandbyTargets(lastPresetSlot);
+}
+
+bool GuitarMultiFXProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
+        && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+        return false;
+
+    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+        return false;
+
+    return true;
+}
+
+void GuitarMultiFXProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ScopedNoDenormals noDenormals;
+#if JAGATFX_PROFILER
+    profiler.beginBlock(buffer.getNumSamples(), getSampleRate());
+#endif
+    JAGATFX_PROFILE_STAGE(total);
+
+    auto totalNumInputChannels = getTotalNumInputChannels();
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
+
+    auto numSamples = buffer.getNumSamples();
+
+    // Guitar input is mono (or a stereo track carrying identical channels).
+    // Run on channel 0 alone until a stage really needs stereo, then fan out.
+    const bool dualMono = totalNumOutputChannels == 2
+        && (totalNumInputChannels == 1
+            || std::equal(buffer.getReadPointer(0), buffer.getReadPointer(0) + numSamples, buffer.getReadPointer(1)));
+
+    if (! dualMono)
     {
-        phaser.setRate(*apvts.getRawParameterValue("phaserRate"));
-        phaser.setDepth(*apvts.getRawParameterValue("phaserDepth"));
-        phaser.setFeedback(*apvts.getRawParameterValue("phaserFeedback"));
-        phaser.setStages(static_cast<int>(*apvts.getRawParameterValue("phaserStages")));
-        phaser.setMix(*apvts.getRawParameterValue("phaserMix"));
-        phaser.process(buffer);
+        // Bersihkan channel output sisanya agar tidak bising
+        for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+            buffer.clear(i, 0, numSamples);
     }
 
-    // === 7. POST-EFFECTS: Harmonizer ===
-    if (*apvts.getRawParameterValue("harmEnabled") > 0.5f)
+    // Resolve every parameter once for this block (no string lookups below).
+    // While a preset switch is under way, the switcher supplies the snapshot.
+    const bool spillTails = presetSwitcher.getSpillover();
+
+    // A program change switches here, on a matching warm standby if there is
+    // one; controller moves retarget their mappings
+    if (const auto* slot = midiControl.handleMidi(midiMessages, numSamples))
     {
-        harmonizer.setInterval(static_cast<int>(*apvts.getRawParameterValue("harmInterval")));
-        harmonizer.setMix(*apvts.getRawParameterValue("harmMix"));
-        harmonizer.process(buffer);
+        // The slot table's session-wide settings may be stale: take the live ones
+        auto preset = slot->snapshot;
+        captureGlobals(parameterTable, preset);
+        midiControl.reportRecall(presetSwitcher.recall(preset, enginePool.claimReady(slot->values)));
     }
 
-    // === 7. POST-EFFECTS: String Synth ===
-    if (*apvts.getRawParameterValue("stringEnabled") > 0.5f)
+    if (! presetSwitcher.beginBlock(snapshot))
+        midiControl.capture(parameterTable, snapshot);
+
+    // The new preset takes over here: on a standby engine with a crossfade,
+    // or within the live engine with the fade at silence
+    if (presetSwitcher.hasSwitched())
     {
-        stringSynth.setAttack(*apvts.getRawParameterValue("stringAttack"));
-        stringSynth.setOctaveMix(*apvts.getRawParameterValue("stringOctave"));
-        stringSynth.setBrightness(*apvts.getRawParameterValue("stringBrightness"));
-        stringSynth.setResonance(*apvts.getRawParameterValue("stringResonance"));
-        stringSynth.setMix(*apvts.getRawParameterValue("stringMix"));
-        stringSynth.process(buffer);
+        if (presetSwitcher.getSwitchEngine() >= 0)
+            enginePool.switchTo(presetSwitcher.getSwitchEngine(), spillTails, presetSwitcher.getOutgoingGain());
+        else
+            enginePool.getLiveEngine().beginPresetSwitch(enginePool.getLiveEngine().getSnapshot(), snapshot, spillTails);
     }
 
-    // === 7. POST-EFFECTS: Delay ===
-    if (*apvts.getRawParameterValue("delayEnabled") > 0.5f)
+    if (presetSwitcher.hasTakenPost())
+        enginePool.dropStaleClaims(presetSwitcher.getTakenSerial());
+
+    // Feed the tuner independently of input gain and effects (analysis runs off-thread)
+    if (totalNumInputChannels > 0)
     {
-        delay.setModel(static_cast<int>(*apvts.getRawParameterValue("delayModel")));
-        delay.setTime(*apvts.getRawParameterValue("delayTime"));
-        delay.setFeedback(*apvts.getRawParameterValue("delayFeedback"));
-        delay.setMix(*apvts.getRawParameterValue("delayMix"));
-        delay.setModulation(*apvts.getRawParameterValue("delayMod"));
-        delay.process(buffer);
+        JAGATFX_PROFILE_STAGE(tuner);
+        tuner.processBlock(buffer.getReadPointer(0), buffer.getNumSamples(), snapshot.tunerEnabled);
     }
 
-    // === 7. POST-EFFECTS: Reverb ===
-    if (*apvts.getRawParameterValue("reverbEnabled") > 0.5f)
+    // Check if tuner is enabled to mute everything else
+    if (snapshot.tunerEnabled)
     {
-        reverb.setModel(static_cast<int>(*apvts.getRawParameterValue("reverbModel")));
-        reverb.setSize(*apvts.getRawParameterValue("reverbSize"));
-        reverb.setDamping(*apvts.getRawParameterValue("reverbDamping"));
-        reverb.setPreDelay(*apvts.getRawParameterValue("reverbPreDelay"));
-        reverb.setMix(*apvts.getRawParameterValue("reverbMix"));
-        reverb.process(buffer);
+        for (auto i = 0; i < totalNumOutputChannels; ++i)
+            buffer.clear(i, 0, buffer.getNumSamples());
+
+        // Muted either way, but a preset switch posted meanwhile still has to
+        // run its fade, or the switcher would hold the old snapshot for good
+        presetSwitcher.applyFade(buffer);
+        return; // Don't process other effects, mute sound
     }
 
-    // === Output Gain ===
-    float outputGainDb = *apvts.getRawParameterValue("outputGain");
-    float outputGain = juce::Decibels::decibelsToGain(outputGainDb);
-    buffer.applyGain(outputGain);
+    FXEngine::BlockHooks hooks;
+    hooks.fade = &presetSwitcher;
+    hooks.fadeBeforeTails = spillTails;
+    hooks.meters = &meters;
+#if JAGATFX_PROFILER
+    hooks.profiler = &profiler;
+#endif
+
+    enginePool.process(buffer, dualMono, snapshot, hooks);
 }
 
 juce::AudioProcessorEditor* GuitarMultiFXProcessor::createEditor()
 {
+#if JAGATFX_HEADLESS
+    return nullptr;
+#else
     return new GuitarMultiFXEditor(*this);
+#endif
 }
 
-bool GuitarMultiFXProcessor::hasEditor() const { return true; }
+bool GuitarMultiFXProcessor::hasEditor() const { return ! JAGATFX_HEADLESS; }
 
 void GuitarMultiFXProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    ParameterValues values;
+    parameterTable.copyValues(values);
+
+    juce::NamedValueSet properties;
+    for (int i = 0; i < apvts.state.getNumProperties(); ++i)
+        properties.set(apvts.state.getPropertyName(i), apvts.state.getProperty(apvts.state.getPropertyName(i)));
+
+    juce::MemoryOutputStream out(destData, false);
+    SessionState::write(out, values, properties);
 }
 
 void GuitarMultiFXProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
-    if (xmlState != nullptr)
-        if (xmlState->hasTagName(apvts.state.getType()))
-            apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+    auto values = getDefaultValues();
+    juce::NamedValueSet properties;
+
+    if (! SessionState::read(data, (size_t) juce::jmax(0, sizeInBytes), values, properties))
+    {
+        // Sessions saved before the binary format
+        std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
+        if (xmlState == nullptr || ! readXmlState(*xmlState, values, properties))
+            return;
+    }
+
+    apvts.state.removeAllProperties(nullptr);
+    for (int i = 0; i < properties.size(); ++i)
+        apvts.state.setProperty(properties.getName(i), properties.getValueAt(i), nullptr);
+
+    // Not replaceState: only the parameters that differ notify, and the
+    // audio thread gets the whole session as one switch
+    applyPreset(values);
+    afterStateRestored();
+}
+
+bool GuitarMultiFXProcessor::readXmlState(const juce::XmlElement& xml, ParameterValues& values,
+                                          juce::NamedValueSet& properties) const
+{
+    if (! xml.hasTagName(apvts.state.getType()))
+        return false;
+
+    const auto state = juce::ValueTree::fromXml(xml);
+    for (const auto& child : state)
+    {
+        const int index = Params::indexOf(child.getProperty("id").toString().toRawUTF8());
+        if (child.hasType("PARAM") && index >= 0)
+            values.set(static_cast<Params::Index>(index), (float) child.getProperty("value"));
+    }
+
+    properties.clear();
+    for (int i = 0; i < state.getNumProperties(); ++i)
+        properties.set(state.getPropertyName(i), state.getProperty(state.getPropertyName(i)));
+
+    return true;
+}
+
+void GuitarMultiFXProcessor::afterStateRestored()
+{
+    juce::File irFile(apvts.state.getProperty(cabIRPathProperty).toString());
+    if (irFile.existsAsFile())
+        enginePool.loadCabinetIR(irFile);
+
+    juce::File captureFile(apvts.state.getProperty(ampCapturePathProperty).toString());
+    if (captureFile.existsAsFile())
+        enginePool.loadAmpCapture(captureFile);
+
+    presetSwitcher.setSpillover(apvts.state.getProperty(presetSpilloverProperty, true));
+    setStandbyEngines(apvts.state.getProperty(standbyEnginesProperty, 0));
+
+    juce::File bankFile(apvts.state.getProperty(userBankPathProperty).toString());
+    if (bankFile.existsAsFile())
+        userBank.openFile(bankFile);
+    updateMidiSlots();
+
+    setMidiMappings(MidiControl::fromString(apvts.state.getProperty(midiMappingsProperty).toString()));
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
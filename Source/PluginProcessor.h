@@ -1,29 +1,22 @@
 #pragma once
 #include <JuceHeader.h>
-#include "DSP/NoiseGate.h"
-#include "DSP/Preamp.h"
-#include "DSP/ToneStack.h"
-#include "DSP/PowerAmp.h"
-#include "DSP/CabinetSim.h"
-#include "DSP/Overdrive.h"
-#include "DSP/Distortion.h"
-#include "DSP/HighGainDist.h"
-#include "DSP/Delay.h"
-#include "DSP/ReverbEffect.h"
-#include "DSP/Chorus.h"
-#include "DSP/Flanger.h"
-#include "DSP/Phaser.h"
-#include "DSP/Harmonizer.h"
-#include "DSP/StringSynth.h"
-#include "DSP/Compressor.h"
-#include "DSP/ParametricEQ.h"
-#include "DSP/GraphicEQ.h"
-#include "DSP/TalkBox.h"
-#include "DSP/AutoWah.h"
 #include "DSP/Tuner.h"
+#include "DSP/Metering.h"
+#include "DSP/StageProfiler.h"
+#include "ParameterSnapshot.h"
+#include "PresetSwitcher.h"
+#include "PresetBank.h"
+#include "EnginePool.h"
+#include "MidiControl.h"
 #include <atomic>
 
-class GuitarMultiFXProcessor : public juce::AudioProcessor
+// Headless builds (offline tools) leave the editor out entirely
+#ifndef JAGATFX_HEADLESS
+ #define JAGATFX_HEADLESS 0
+#endif
+
+class GuitarMultiFXProcessor : public juce::AudioProcessor,
+                               private juce::Timer
 {
 public:
     GuitarMultiFXProcessor();
@@ -55,34 +48,98 @@ public:
 
     juce::AudioProcessorValueTreeState& getAPVTS() { return apvts; }
 
-    // DSP Modules - accessible for GUI
-    NoiseGate noiseGate;
-    Compressor compressor;
-    Overdrive overdrive;
-    Distortion distortion;
-    HighGainDist highGainDist;
-    Preamp preamp;
-    ToneStack toneStack;
-    PowerAmp powerAmp;
-    CabinetSim cabinetSim;
-    Chorus chorus;
-    Flanger flanger;
-    Phaser phaser;
-    Harmonizer harmonizer;
-    StringSynth stringSynth;
-    DelayEffect delay;
-    ReverbEffect reverb;
-    ParametricEQ parametricEQ;
-    GraphicEQ graphicEQ;
-    TalkBox talkBox;
-    AutoWah autoWah;
+    // Custom cabinet IR (message thread); the path is persisted in the state tree
+    void loadCabinetIR(const juce::File& irFile);
+    static constexpr const char* cabIRPathProperty = "cabIRPath";
+
+    // Neural amp capture for the "Neural Capture" amp model (message thread);
+    // returns false if the file can't be used
+    bool loadAmpCapture(const juce::File& captureFile);
+    static constexpr const char* ampCapturePathProperty = "ampCapturePath";
+
+    // Switches to a complete preset at one block boundary, with a short fade
+    // (message thread). The host and editor see the new values as usual.
+    void applyPreset(const ParameterValues& preset);
+
+    // Preset slots: the factory bank, then the user bank if one is open
+    // (message thread). User banks use the factory .gfxbank format.
+    juce::StringArray getPresetSlotNames() const;
+    void loadPresetSlot(int slot);
+    bool loadUserBank(const juce::File& bankFile);
+    bool saveToUserBank(const juce::File& bankFile, const juce::String& presetName); // Appends
+    static constexpr const char* userBankPathProperty = "userBankPath";
+
+    // Single presets as .gfxpreset files (message thread). Saved in the binary
+    // session format; older XML preset files still load.
+    bool savePresetFile(const juce::File& file);
+    bool loadPresetFile(const juce::File& file);
+
+    // Whether delay and reverb tails ring on across a preset switch
+    void setPresetSpillover(bool shouldSpill);
+    bool getPresetSpillover() const { return presetSwitcher.getSpillover(); }
+    static constexpr const char* presetSpilloverProperty = "presetSpillover";
+
+    // Warm standby: spare engines configured in the background for the
+    // presets next to the current one, so stepping to them is a crossfade.
+    // 0 = off; each standby costs a full extra chain (see EnginePool).
+    void setStandbyEngines(int count);
+    int getStandbyEngines() const { return enginePool.getStandbyCount(); }
+    static constexpr const char* standbyEnginesProperty = "standbyEngines";
+
+    // MIDI controllers mapped to parameters, each with its own range and
+    // smoothing (message thread). Program change n recalls preset slot n.
+    void setMidiMappings(const std::vector<MidiControl::Mapping>& mappings);
+    const std::vector<MidiControl::Mapping>& getMidiMappings() const { return midiControl.getMappings(); }
+    static constexpr const char* midiMappingsProperty = "midiMappings";
+
     Tuner tuner;
 
-    std::atomic<float> currentTunerFreq { 0.0f };
+    // Per-module levels for the editor; only measured while it has a viewer
+    MeterBank meters;
+
+#if JAGATFX_PROFILER
+    // Per-stage processBlock timings for the editor's CPU overlay
+    StageProfiler profiler;
+#endif
 
 private:
     juce::AudioProcessorValueTreeState apvts;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+    // The processing chain(s); one engine unless warm standby is on
+    EnginePool enginePool;
+
+    // Must follow apvts: resolves its raw value pointers on construction
+    ParameterTable parameterTable { apvts };
+    ParameterSnapshot snapshot;
+
+    PresetSwitcher presetSwitcher;
+    PresetBank userBank;
+
+    // State saved as XML, before SessionState: parameters over the given
+    // values, plus the tree's own properties. False if it isn't ours.
+    bool readXmlState(const juce::XmlElement& xml, ParameterValues& values, juce::NamedValueSet& properties) const;
+    void afterStateRestored(); // Reloads the files and options the state tree names
+
+    ParameterValues getDefaultValues() const;
+    ParameterValues snapToParameters(const ParameterValues& values) const;
+    bool getSlotValues(int slot, ParameterValues& values) const;
+
+    // Keeps the slots next to this one warm, the way the player is stepping first
+    void updateStandbyTargets(int slot);
+    int lastPresetSlot = -1;
+
+    // Program changes and controllers, acted on in processBlock; the timer
+    // writes what they changed back to the APVTS
+    MidiControl midiControl;
+    void updateMidiSlots(); // After the preset slots change
+    void mirrorMidiChanges();
+    void writeParameters(const ParameterValues& values); // Notifies only the ones that change
+    void timerCallback() override;
+
+    // Oversampling re-prepares the drive and amp stages, so it changes here
+    // with the audio suspended, never in processBlock
+    void updateOversampling();
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GuitarMultiFXProcessor)
 };
@@ -0,0 +1,164 @@
+#pragma once
+#include <JuceHeader.h>
+#include "Parameters.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * PresetBank - Compact binary preset bank (.gfxbank), used for the factory
+ * presets (embedded via BinaryData) and user banks alike.
+ *
+ * Layout, little-endian, every field 4-byte aligned:
+ *   header   "GFXB", uint32 version, uint32 numColumns, uint32 numPresets
+ *   columns  numColumns parameter IDs, 32 bytes each, zero padded
+ *   presets  numPresets records: 64-byte UTF-8 name, numColumns float32 values
+ *
+ * Columns are matched to Params indices by ID once, when the bank is opened,
+ * so a bank written before parameters were added or reordered still loads.
+ * The data is used in place (embedded or memory-mapped), and recalling a
+ * preset is a straight copy of its values with no strings involved, safe
+ * for the audio thread.
+ */
+class PresetBank
+{
+public:
+    static constexpr juce::uint32 currentVersion = 1;
+    static constexpr int idLength = 32, nameLength = 64;
+    static constexpr const char* fileExtension = ".gfxbank";
+
+    /** Opens a bank in memory that outlives this object, e.g. BinaryData. */
+    bool openMemory(const void* bankData, size_t bankSize)
+    {
+        close();
+        return parse(static_cast<const char*>(bankData), bankSize);
+    }
+
+    /** Maps a bank file read-only instead of reading it in. */
+    bool openFile(const juce::File& file)
+    {
+        close();
+        mappedFile = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+        if (mappedFile->getData() != nullptr && parse(static_cast<const char*>(mappedFile->getData()), mappedFile->getSize()))
+            return true;
+
+        close();
+        return false;
+    }
+
+    void close()
+    {
+        data = nullptr;
+        numPresets = 0;
+        columnIndex.clear();
+        mappedFile.reset();
+    }
+
+    int getNumPresets() const { return numPresets; }
+
+    juce::String getName(int preset) const
+    {
+        if (! juce::isPositiveAndBelow(preset, numPresets))
+            return {};
+
+        const char* name = getRecord(preset);
+        return juce::String::fromUTF8(name, (int) strnlen(name, (size_t) nameLength));
+    }
+
+    juce::StringArray getNames() const
+    {
+        juce::StringArray names;
+        for (int i = 0; i < numPresets; ++i)
+            names.add(getName(i));
+        return names;
+    }
+
+    /** Copies a preset over the given values; parameters the bank has no column for keep theirs. */
+    void getValues(int preset, ParameterValues& values) const
+    {
+        if (! juce::isPositiveAndBelow(preset, numPresets))
+            return;
+
+        const char* column = getRecord(preset) + nameLength;
+        for (const int index : columnIndex)
+        {
+            if (index >= 0)
+            {
+                float value;
+                std::memcpy(&value, column, sizeof(float));
+                values.set(static_cast<Params::Index>(index), value);
+            }
+            column += sizeof(float);
+        }
+    }
+
+    /** Writes presets as a bank with one column per current parameter. */
+    static bool write(juce::OutputStream& out, const juce::StringArray& names, const std::vector<ParameterValues>& presets)
+    {
+        jassert(names.size() == (int) presets.size());
+
+        bool ok = out.write("GFXB", 4)
+               && out.writeInt((int) currentVersion)
+               && out.writeInt(Params::count)
+               && out.writeInt((int) presets.size());
+
+        for (int i = 0; i < Params::count && ok; ++i)
+            ok = writePadded(out, Params::ids[i], idLength);
+
+        for (size_t p = 0; p < presets.size() && ok; ++p)
+        {
+            ok = writePadded(out, names[(int) p].toRawUTF8(), nameLength);
+            for (int i = 0; i < Params::count && ok; ++i)
+                ok = out.writeFloat(presets[p].get(static_cast<Params::Index>(i)));
+        }
+
+        return ok;
+    }
+
+private:
+    static constexpr size_t headerSize = 16;
+
+    bool parse(const char* bankData, size_t bankSize)
+    {
+        if (bankData == nullptr || bankSize < headerSize || std::memcmp(bankData, "GFXB", 4) != 0)
+            return false;
+
+        const auto version = juce::ByteOrder::littleEndianInt(bankData + 4);
+        const auto columns = juce::ByteOrder::littleEndianInt(bankData + 8);
+        const auto presets = juce::ByteOrder::littleEndianInt(bankData + 12);
+        if (version != currentVersion || columns == 0 || columns > 4096)
+            return false;
+
+        recordSize = (size_t) nameLength + columns * sizeof(float);
+        firstRecord = headerSize + (size_t) columns * idLength;
+        if (bankSize < firstRecord || (bankSize - firstRecord) / recordSize < presets)
+            return false;
+
+        columnIndex.resize(columns);
+        for (juce::uint32 c = 0; c < columns; ++c)
+        {
+            const char* id = bankData + headerSize + c * idLength;
+            columnIndex[c] = Params::indexOf(std::string(id, strnlen(id, (size_t) idLength)).c_str());
+        }
+
+        data = bankData;
+        numPresets = (int) presets;
+        return true;
+    }
+
+    const char* getRecord(int preset) const { return data + firstRecord + (size_t) preset * recordSize; }
+
+    static bool writePadded(juce::OutputStream& out, const char* text, int length)
+    {
+        char field[nameLength] = {};
+        std::strncpy(field, text, (size_t) length - 1);
+        return out.write(field, (size_t) length);
+    }
+
+    const char* data = nullptr;
+    int numPresets = 0;
+    size_t recordSize = 0, firstRecord = 0;
+    std::vector<int> columnIndex; // Params index per column, -1 if unknown
+
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+};
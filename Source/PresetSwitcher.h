@@ -0,0 +1,251 @@
+#pragma once
+#include <JuceHeader.h>
+#include "ParameterSnapshot.h"
+#include <atomic>
+#include <cmath>
+
+/**
+ * PresetSwitcher - Hands a complete preset to the audio thread in one piece.
+ *
+ * The message thread builds the whole ParameterSnapshot up front and posts
+ * it through a lock-free triple buffer (no allocation, no waiting on either
+ * side). A preset posted with a warm standby engine takes over at once and
+ * the EnginePool crossfades to it. Otherwise the audio thread fades the old
+ * sound out on the snapshot it already has, switches every module to the
+ * new one at a single block boundary and fades back in (equal-power
+ * curves), so no block ever runs a half-applied preset. While the message
+ * thread is still writing the same values into the APVTS for the host and
+ * editor, the audio thread keeps the posted snapshot instead of reading the
+ * half-written parameter table.
+ *
+ * A preset can also be recalled on the audio thread itself (a MIDI program
+ * change): it switches the same way, and its snapshot is held until the
+ * message thread reports that it has mirrored it into the APVTS.
+ */
+class PresetSwitcher
+{
+public:
+    static constexpr double fadeSeconds = 0.01; // Each way
+
+    //==============================================================================
+    // Message thread
+
+    /**
+     * Queues a preset; a newer one replaces any the audio thread hasn't taken
+     * yet. engine is the pool engine configured for it, or -1 to switch the
+     * live engine over with the fade.
+     */
+    void post(const ParameterSnapshot& preset, int engine = -1)
+    {
+        slots[(size_t) writeSlot].snapshot = preset;
+        slots[(size_t) writeSlot].engine = engine;
+        slots[(size_t) writeSlot].serial = ++postSerial;
+        writeSlot = middle.exchange(writeSlot | newFlag, std::memory_order_acq_rel) & indexMask;
+    }
+
+    /** The serial the next post() will carry; engines claimed for it are stamped with it. */
+    juce::uint32 getNextPostSerial() const { return postSerial + 1; }
+
+    /** Brackets the APVTS writes that mirror a posted preset. */
+    void beginParameterWrites() { writesInFlight.fetch_add(1, std::memory_order_acq_rel); }
+    void endParameterWrites()   { writesInFlight.fetch_sub(1, std::memory_order_acq_rel); }
+
+    /** The APVTS now holds the preset recalled with this serial (see recall()). */
+    void setRecallMirrored(juce::uint32 serial) { mirroredRecall.store(serial, std::memory_order_release); }
+
+    /** Delay and reverb tails carry on across a switch instead of being cut. */
+    void setSpillover(bool shouldSpill) { spillover.store(shouldSpill); }
+    bool getSpillover() const { return spillover.load(); }
+
+    //==============================================================================
+    // Audio thread
+
+    void prepare(double sampleRate)
+    {
+        fadeLength = juce::jmax(1, juce::roundToInt(sampleRate * fadeSeconds));
+        phase = Phase::idle;
+        fadePosition = 0;
+        holding = false;
+        switched = false;
+        tookPost = false;
+        recallPending = recalled = false;
+        switchEngine = -1;
+    }
+
+    /**
+     * Recalls a preset from the audio thread, before this block's
+     * beginBlock(); it supersedes anything posted. engine is as for post().
+     * Returns the serial the message thread passes to setRecallMirrored()
+     * once it has written the same values into the APVTS.
+     */
+    juce::uint32 recall(const ParameterSnapshot& preset, int engine = -1)
+    {
+        local.snapshot = preset;
+        local.engine = engine;
+        local.serial = ++recallSerial;
+        recallPending = true;
+        return local.serial;
+    }
+
+    /**
+     * Call at the top of each block. Returns true if it has supplied the
+     * block's snapshot itself: the previous block's (left untouched) while
+     * fading out, the new preset while its APVTS writes are in flight.
+     * False means capture from the parameter table as usual.
+     */
+    bool beginBlock(ParameterSnapshot& snapshot)
+    {
+        switched = false;
+        switchEngine = -1;
+        tookPost = false;
+        recalled = false;
+
+        if ((middle.load(std::memory_order_acquire) & newFlag) != 0)
+        {
+            readSlot = middle.exchange(readSlot, std::memory_order_acq_rel) & indexMask;
+            tookPost = true;
+            start(slots[(size_t) readSlot]);
+        }
+
+        if (recallPending)
+        {
+            recallPending = false;
+            recalled = true;
+            start(local);
+        }
+
+        if (phase == Phase::fadingOut)
+        {
+            if (fadePosition < fadeLength)
+                return true;
+
+            // Silent now: every module moves to the new preset together
+            phase = Phase::fadingIn;
+            fadePosition = 0;
+            switched = true;
+            holding = true;
+        }
+
+        if (holding && writesInFlight.load(std::memory_order_acquire) == 0
+            && (current != &local || mirroredRecall.load(std::memory_order_acquire) == local.serial))
+            holding = false;
+
+        if (holding)
+            snapshot = current->snapshot;
+
+        return holding;
+    }
+
+    /** True for the block in which the new preset took over. */
+    bool hasSwitched() const { return switched; }
+
+    /**
+     * True for the block in which a post was taken, superseding any older
+     * one. Engines claimed for posts before getTakenSerial() are stale; a
+     * recall in the same block makes the post just taken stale too.
+     */
+    bool hasTakenPost() const { return tookPost; }
+    juce::uint32 getTakenSerial() const { return slots[(size_t) readSlot].serial + (recalled ? 1u : 0u); }
+
+    /** The engine that took over in this block, or -1 if the live one switched. */
+    int getSwitchEngine() const { return switchEngine; }
+
+    /** The fade's gain on the live engine just before another engine took over. */
+    float getOutgoingGain() const { return outgoingGain; }
+
+    /** Applies the switch fade; call exactly once per block, at one point in the chain. */
+    void applyFade(juce::AudioBuffer<float>& buffer)
+    {
+        if (phase == Phase::idle)
+            return;
+
+        const int numSamples = buffer.getNumSamples();
+        const float scale = juce::MathConstants<float>::halfPi / (float) fadeLength;
+        const bool out = phase == Phase::fadingOut;
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            float* data = buffer.getWritePointer(ch);
+            for (int s = 0; s < numSamples; ++s)
+            {
+                const float x = (float) juce::jmin(fadePosition + s, fadeLength) * scale;
+                data[s] *= out ? std::cos(x) : std::sin(x);
+            }
+        }
+
+        fadePosition += numSamples;
+
+        if (phase == Phase::fadingIn && fadePosition >= fadeLength)
+            phase = Phase::idle;
+    }
+
+private:
+    enum class Phase { idle, fadingOut, fadingIn };
+
+    struct Posted
+    {
+        ParameterSnapshot snapshot;
+        int engine = -1;
+        juce::uint32 serial = 0;
+    };
+
+    void start(const Posted& preset)
+    {
+        current = &preset;
+        switched = false;
+        switchEngine = -1;
+
+        if (preset.engine >= 0)
+        {
+            // Another engine takes over now; the pool does the crossfade
+            outgoingGain = getGain();
+            phase = Phase::idle;
+            switchEngine = preset.engine;
+            switched = true;
+            holding = true;
+        }
+        else
+        {
+            // Turn around from wherever the fade is, at the same level
+            if (phase == Phase::fadingIn)
+                fadePosition = fadeLength - fadePosition;
+            else if (phase == Phase::idle)
+                fadePosition = 0;
+
+            phase = Phase::fadingOut;
+            holding = false;
+        }
+    }
+
+    float getGain() const
+    {
+        const float x = (float) juce::jmin(fadePosition, fadeLength) * juce::MathConstants<float>::halfPi / (float) fadeLength;
+        return phase == Phase::fadingOut ? std::cos(x) : phase == Phase::fadingIn ? std::sin(x) : 1.0f;
+    }
+
+    // Triple buffer: the writer fills its own slot and swaps it into the
+    // middle, flagged as new; the reader swaps the middle out when flagged
+    static constexpr int indexMask = 3, newFlag = 4;
+
+    std::array<Posted, 3> slots;
+    int writeSlot = 0;                // Message thread
+    juce::uint32 postSerial = 0;      // Message thread
+    std::atomic<int> middle { 1 };
+    int readSlot = 2;                 // Audio thread
+
+    // Audio-thread recalls, and the last one the message thread has mirrored
+    Posted local;
+    juce::uint32 recallSerial = 0;
+    bool recallPending = false, recalled = false;
+    std::atomic<juce::uint32> mirroredRecall { 0 };
+    const Posted* current = &slots[2];
+
+    std::atomic<int> writesInFlight { 0 };
+    std::atomic<bool> spillover { true };
+
+    Phase phase = Phase::idle;
+    int fadeLength = 441, fadePosition = 0;
+    bool holding = false, switched = false, tookPost = false;
+    int switchEngine = -1;
+    float outgoingGain = 1.0f;
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include <JuceHeader.h>
+#include "Parameters.h"
+#include <cstring>
+
+/**
+ * SessionState - Compact binary plugin state, for host sessions and
+ * .gfxpreset files alike.
+ *
+ * Layout, little-endian:
+ *   header      "GFXS", uint32 version, uint32 numParameters
+ *   parameters  numParameters x { uint32 Params::hashOf(id), float32 value }
+ *   properties  uint32 count, then per property a UTF-8 name and a juce::var
+ *
+ * Values are matched to Params indices by ID hash, so state saved before
+ * parameters were added or reordered still restores. The properties are
+ * the state tree's own (IR path, user bank, switching options). Anything
+ * without the header is left to the caller's XML fallback.
+ */
+struct SessionState
+{
+    static constexpr juce::uint32 currentVersion = 1;
+    static constexpr const char* fileExtension = ".gfxpreset";
+
+    static bool isSessionState(const void* data, size_t size)
+    {
+        return data != nullptr && size >= headerSize && std::memcmp(data, "GFXS", 4) == 0;
+    }
+
+    static void write(juce::OutputStream& out, const ParameterValues& values, const juce::NamedValueSet& properties)
+    {
+        out.write("GFXS", 4);
+        out.writeInt((int) currentVersion);
+        out.writeInt(Params::count);
+
+        for (int i = 0; i < Params::count; ++i)
+        {
+            out.writeInt((int) Params::hashOf(Params::ids[i]));
+            out.writeFloat(values.get(static_cast<Params::Index>(i)));
+        }
+
+        out.writeInt(properties.size());
+        for (int i = 0; i < properties.size(); ++i)
+        {
+            out.writeString(properties.getName(i).toString());
+            properties.getValueAt(i).writeToStream(out);
+        }
+    }
+
+    /**
+     * Reads values over the given ones (parameters the state lacks keep
+     * theirs) and the properties. False if this isn't a readable state.
+     */
+    static bool read(const void* data, size_t size, ParameterValues& values, juce::NamedValueSet& properties)
+    {
+        if (! isSessionState(data, size))
+            return false;
+
+        juce::MemoryInputStream in(data, size, false);
+        in.skipNextBytes(4);
+
+        const auto version = (juce::uint32) in.readInt();
+        const int numParameters = in.readInt();
+        if (version != currentVersion || numParameters < 0
+            || (size_t) numParameters * 8 > size - headerSize)
+            return false;
+
+        for (int i = 0; i < numParameters; ++i)
+        {
+            const auto hash = (std::uint32_t) in.readInt();
+            const float value = in.readFloat();
+
+            // Same layout as this build in the usual case, so the first guess hits
+            const int index = Params::indexOfHash(hash, i);
+            if (index >= 0)
+                values.set(static_cast<Params::Index>(index), value);
+        }
+
+        properties.clear();
+        for (int i = in.readInt(); i > 0 && ! in.isExhausted(); --i)
+        {
+            const auto name = in.readString();
+            const auto value = juce::var::readFromStream(in);
+            if (name.isNotEmpty())
+                properties.set(juce::Identifier(name), value);
+        }
+
+        return true;
+    }
+
+private:
+    static constexpr size_t headerSize = 12;
+};
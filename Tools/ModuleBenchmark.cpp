@@ -0,0 +1,568 @@
+// JAGAT MULTI FX - Module Benchmark
+// Times every DSP module on its own, across block sizes, sample rates, models
+// and mono/stereo, and checks the optimized kernels against ReferenceKernels.h
+//
+// Usage: ModuleBenchmark [--quick] [--module <name>] [--json <file>] [--baseline <file>]
+//   --quick            Block sizes 64 and 512 at 48 kHz only
+//   --module <name>    Only modules whose name contains <name>
+//   --json <file>      Write the results as JSON (stdout gets the text report either way)
+//   --baseline <file>  Compare against an earlier --json run; cases more than 10% slower are flagged
+//
+// Output: ns/sample per case, kernel agreement (max abs error vs. tolerance).
+// Exits with status 1 if any kernel disagrees with its reference.
+//
+// Compile against the plugin's JuceLibraryCode (JuceHeader.h) and JUCE modules, e.g.:
+//   g++ -std=c++17 -O3 -march=native -I../Builds/JuceLibraryCode -I../JUCE/modules
+//       ModuleBenchmark.cpp -o ModuleBenchmark <juce_core/juce_audio_basics/juce_dsp objects>
+//
+// The neural amp model is timed by NeuralAmpBenchmark, where it needs a capture to be
+// meaningful; its networks are checked here against ReferenceKernels.h.
+
+#include <JuceHeader.h>
+#include "../Source/DSP/NoiseGate.h"
+#include "../Source/DSP/Compressor.h"
+#include "../Source/DSP/Overdrive.h"
+#include "../Source/DSP/Distortion.h"
+#include "../Source/DSP/HighGainDist.h"
+#include "../Source/DSP/Preamp.h"
+#include "../Source/DSP/ToneStack.h"
+#include "../Source/DSP/PowerAmp.h"
+#include "../Source/DSP/CabinetSim.h"
+#include "../Source/DSP/ParametricEQ.h"
+#include "../Source/DSP/GraphicEQ.h"
+#include "../Source/DSP/TalkBox.h"
+#include "../Source/DSP/AutoWah.h"
+#include "../Source/DSP/Chorus.h"
+#include "../Source/DSP/Flanger.h"
+#include "../Source/DSP/Phaser.h"
+#include "../Source/DSP/Harmonizer.h"
+#include "../Source/DSP/StringSynth.h"
+#include "../Source/DSP/Delay.h"
+#include "../Source/DSP/ReverbEffect.h"
+#include "../Source/DSP/NeuralAmp.h"
+#include "../Source/DSP/LevelDetector.h"
+#include "ReferenceKernels.h"
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+
+namespace {
+
+using ProcessFn = std::function<void(juce::AudioBuffer<float>&)>;
+
+struct ModuleCase
+{
+    juce::String module;
+    int model;
+    juce::String modelName;
+    bool stereoOnly; // The processor always fans out to stereo ahead of it
+    std::function<ProcessFn(const juce::dsp::ProcessSpec&)> make;
+};
+
+template <typename Module>
+void runModule(Module& m, LevelDetector&, juce::AudioBuffer<float>& b) { m.process(b); }
+
+// The dynamics modules key off a sidechain FXEngine analyses once per block;
+// the analysis is counted here, as each would need it on its own
+void runModule(NoiseGate& m, LevelDetector& sidechain, juce::AudioBuffer<float>& b)
+{
+    sidechain.analyse(b);
+    m.process(b, sidechain);
+}
+
+void runModule(Compressor& m, LevelDetector& sidechain, juce::AudioBuffer<float>& b)
+{
+    sidechain.analyse(b);
+    m.process(b, sidechain);
+}
+
+// setParameters runs every block: the cost of a block in which the module's
+// values moved (FXEngine skips it otherwise)
+template <typename Module>
+ModuleCase makeCase(const char* module, int model, const char* modelName, bool stereoOnly, typename Module::Parameters params)
+{
+    return { module, model, modelName, stereoOnly, [params](const juce::dsp::ProcessSpec& spec) -> ProcessFn
+    {
+        auto m = std::make_shared<Module>();
+        auto sidechain = std::make_shared<LevelDetector>();
+        m->prepare(spec);
+        sidechain->prepare((int) spec.maximumBlockSize, spec.sampleRate);
+        return [m, sidechain, params](juce::AudioBuffer<float>& b)
+        {
+            m->setParameters(params);
+            runModule(*m, *sidechain, b);
+        };
+    } };
+}
+
+template <typename Module, typename Params>
+void addModels(std::vector<ModuleCase>& cases, const char* module, const juce::StringArray& models,
+               Params params, const std::function<void(Params&, int)>& setModel, const std::function<bool(int)>& stereoOnly = {})
+{
+    for (int m = 0; m < models.size(); ++m)
+    {
+        setModel(params, m);
+        cases.push_back(makeCase<Module>(module, m, models[m].toRawUTF8(), stereoOnly && stereoOnly(m), params));
+    }
+}
+
+std::vector<ModuleCase> getCases()
+{
+    std::vector<ModuleCase> cases;
+    auto setModel = [](auto& p, int m) { p.model = m; };
+
+    cases.push_back(makeCase<NoiseGate>("NoiseGate", 0, "", false, {}));
+    addModels<Compressor, Compressor::Parameters>(cases, "Compressor", { "VCA", "Optical", "FET" }, {}, setModel);
+    addModels<Overdrive, Overdrive::Parameters>(cases, "Overdrive", { "Tube Screamer", "Blues Driver", "Klon" }, {}, setModel);
+    addModels<Distortion, Distortion::Parameters>(cases, "Distortion", { "DS-1", "RAT", "Metal Zone" }, {}, setModel);
+    addModels<HighGainDist, HighGainDist::Parameters>(cases, "HighGainDist", { "Rectifier", "5150", "Dual Rec", "Djent" }, {}, setModel);
+    addModels<Preamp, Preamp::Parameters>(cases, "Preamp", { "Clean", "Crunch", "High Gain", "Metal", "Fender Twin",
+                                                              "Marshall JCM", "Mesa Rectifier", "Soldano Lead" }, {}, setModel);
+    cases.push_back(makeCase<ToneStack>("ToneStack", 0, "", false, {}));
+    cases.push_back(makeCase<PowerAmp>("PowerAmp", 0, "", false, {}));
+    addModels<CabinetSim, CabinetSim::Parameters>(cases, "CabinetSim", { "1x12 Open Back", "2x12 Closed", "4x12 V30", "4x12 Greenback" }, {}, setModel);
+
+    ParametricEQ::Parameters peq;
+    for (auto& band : peq.bands)
+        band.gainDb = 4.0f;
+    cases.push_back(makeCase<ParametricEQ>("ParametricEQ", 0, "", false, peq));
+
+    GraphicEQ::Parameters geq;
+    for (int band = 0; band < GraphicEQ::numBands; ++band)
+        geq.gainsDb[band] = band % 2 == 0 ? 3.0f : -3.0f;
+    cases.push_back(makeCase<GraphicEQ>("GraphicEQ", 0, "", false, geq));
+
+    cases.push_back(makeCase<TalkBox>("TalkBox", 0, "", false, {}));
+    cases.push_back(makeCase<AutoWah>("AutoWah", 0, "", false, {}));
+    cases.push_back(makeCase<Chorus>("Chorus", 0, "", true, {}));
+    cases.push_back(makeCase<Flanger>("Flanger", 0, "", false, {}));
+    addModels<Phaser, Phaser::Parameters>(cases, "Phaser", { "4 stages", "8 stages", "12 stages" }, {},
+                                          [](Phaser::Parameters& p, int m) { p.stages = m; });
+    addModels<Harmonizer, Harmonizer::Parameters>(cases, "Harmonizer", { "Min 3rd", "Maj 3rd", "4th", "5th", "Oct Up", "Oct Down" }, {},
+                                                  [](Harmonizer::Parameters& p, int m) { p.interval = m; });
+    cases.push_back(makeCase<StringSynth>("StringSynth", 0, "", false, {}));
+    addModels<DelayEffect, DelayEffect::Parameters>(cases, "DelayEffect", { "Digital", "Analog", "Tape", "Ping-Pong" }, {}, setModel,
+                                                    [](int m) { return m == 3; });
+    addModels<ReverbEffect, ReverbEffect::Parameters>(cases, "ReverbEffect", { "Hall", "Room", "Plate", "Spring", "Cathedral" }, {}, setModel,
+                                                      [](int) { return true; });
+    return cases;
+}
+
+//==============================================================================
+// Timing
+
+// Guitar-like test signal: decaying plucks over a little noise
+juce::AudioBuffer<float> makeSignal(int numChannels, int numSamples, double sampleRate)
+{
+    juce::AudioBuffer<float> signal(numChannels, numSamples);
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> noise(-0.01f, 0.01f);
+
+    for (int s = 0; s < numSamples; ++s)
+    {
+        const double t = std::fmod(s / sampleRate, 0.5);
+        const float v = (float) (0.6 * std::exp(-6.0 * t) * std::sin(juce::MathConstants<double>::twoPi * 110.0 * s / sampleRate)) + noise(rng);
+        for (int ch = 0; ch < numChannels; ++ch)
+            signal.setSample(ch, s, v);
+    }
+
+    return signal;
+}
+
+// Best of three passes over the signal, block by block
+double measureNsPerSample(const ProcessFn& process, const juce::AudioBuffer<float>& signal, int blockSize)
+{
+    juce::AudioBuffer<float> block(signal.getNumChannels(), blockSize);
+    const int numBlocks = signal.getNumSamples() / blockSize;
+    double best = 1.0e30;
+
+    for (int run = 0; run < 3; ++run)
+    {
+        double total = 0.0;
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            for (int ch = 0; ch < signal.getNumChannels(); ++ch)
+                block.copyFrom(ch, 0, signal, ch, b * blockSize, blockSize);
+
+            const auto start = std::chrono::steady_clock::now();
+            process(block);
+            total += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        }
+        best = std::min(best, total);
+    }
+
+    return best / (numBlocks * blockSize);
+}
+
+juce::String getCaseKey(const juce::var& r)
+{
+    return r["module"].toString() + "/" + r["model"].toString() + "/" + r["sampleRate"].toString()
+         + "/" + r["blockSize"].toString() + "/" + r["channels"].toString();
+}
+
+//==============================================================================
+// Kernel agreement
+
+struct Check
+{
+    juce::String kernel;
+    double maxError;
+    double tolerance;
+};
+
+std::vector<float> makeNoise(int n, std::mt19937& rng, float amplitude = 0.5f)
+{
+    std::uniform_real_distribution<float> dist(-amplitude, amplitude);
+    std::vector<float> v((size_t) n);
+    for (auto& x : v)
+        x = dist(rng);
+    return v;
+}
+
+Check checkFilterCascade(std::mt19937& rng)
+{
+    constexpr double rate = 48000.0;
+    Biquad filters[6];
+    for (auto& f : filters)
+        f.prepare(rate);
+
+    filters[0].setHighPass(80.0f);
+    filters[1].setPeak(400.0f, 1.0f, 2.0f);
+    filters[2].setPeak(1800.0f, 2.0f, 0.5f);
+    filters[3].setLowShelf(200.0f, Biquad::defaultQ, 1.5f);
+    filters[4].setHighShelf(4000.0f, Biquad::defaultQ, 0.7f);
+    filters[5].setLowPass(6000.0f);
+
+    const auto input = makeNoise(9600, rng);
+    std::vector<Biquad::Coefficients> sections;
+
+    FilterCascade cascade;
+    cascade.reset();
+
+    // Odd block sizes so state carries across block edges
+    juce::AudioBuffer<float> block(1, 333);
+    std::vector<float> output;
+    for (size_t start = 0; start < input.size(); start += 333)
+    {
+        const int n = (int) std::min<size_t>(333, input.size() - start);
+        cascade.begin();
+        for (auto& f : filters)
+            cascade.add(f);
+        cascade.skip(2);
+        cascade.addGain(0.8f);
+
+        juce::AudioBuffer<float> view(block.getArrayOfWritePointers(), 1, n);
+        std::copy(input.begin() + (long) start, input.begin() + (long) start + n, view.getWritePointer(0));
+        cascade.process(view);
+        output.insert(output.end(), view.getReadPointer(0), view.getReadPointer(0) + n);
+    }
+
+    for (auto& f : filters)
+        sections.push_back(f.getCoefficients());
+
+    return { "FilterCascade", ReferenceKernels::maxAbsDifference(output, ReferenceKernels::biquadCascade(sections, input, 0.8)), 1.0e-4 };
+}
+
+Check checkConvolver(std::mt19937& rng)
+{
+    // Long enough to reach both FFT stages
+    auto irSamples = makeNoise(3000, rng);
+    for (size_t i = 0; i < irSamples.size(); ++i)
+        irSamples[i] *= (float) std::exp(-3.0 * (double) i / irSamples.size()) * 0.1f;
+
+    juce::AudioBuffer<float> ir(1, (int) irSamples.size());
+    std::copy(irSamples.begin(), irSamples.end(), ir.getWritePointer(0));
+
+    PartitionedConvolver convolver(ir);
+    convolver.reset();
+
+    const auto input = makeNoise(20000, rng);
+    std::vector<float> output;
+    juce::AudioBuffer<float> block(1, 1000);
+    const int blockSizes[] = { 37, 256, 1000, 64, 1 };
+
+    for (size_t start = 0, i = 0; start < input.size(); ++i)
+    {
+        const int n = (int) std::min<size_t>((size_t) blockSizes[i % 5], input.size() - start);
+        juce::AudioBuffer<float> view(block.getArrayOfWritePointers(), 1, n);
+        std::copy(input.begin() + (long) start, input.begin() + (long) start + n, view.getWritePointer(0));
+        convolver.process(view);
+        output.insert(output.end(), view.getReadPointer(0), view.getReadPointer(0) + n);
+        start += (size_t) n;
+    }
+
+    return { "PartitionedConvolver", ReferenceKernels::maxAbsDifference(output, ReferenceKernels::convolve(irSamples, input)), 1.0e-4 };
+}
+
+Check checkWaveshaper()
+{
+    const WaveshaperTable table([](double x) { return std::tanh(std::tanh(x * 3.0) * 2.0) * 0.9; });
+
+    std::vector<float> data(20001);
+    std::vector<double> reference(data.size());
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = -2.0f + 4.0f * (float) i / (float) (data.size() - 1);
+        const double x = (double) data[i] * 1.7;
+        reference[i] = std::tanh(std::tanh(x * 3.0) * 2.0) * 0.9 * 0.5;
+    }
+
+    table.process(data.data(), (int) data.size(), 1.7f, 0.5f);
+    return { "WaveshaperTable", ReferenceKernels::maxAbsDifference(data, reference), 1.0e-5 };
+}
+
+template <int Rows, int Cols>
+Check checkMultiplyAdd(std::mt19937& rng)
+{
+    const auto rowMajor = makeNoise(Rows * Cols, rng);
+    const auto x = makeNoise(Cols, rng);
+    const auto y0 = makeNoise(Rows, rng);
+
+    std::vector<float> columnMajor(rowMajor.size());
+    NeuralKernels::transpose(columnMajor.data(), rowMajor.data(), Rows, Cols);
+
+    std::vector<float> y(y0);
+    NeuralKernels::multiplyAdd<Rows, Cols>(y.data(), columnMajor.data(), x.data());
+
+    std::vector<double> reference(y0.begin(), y0.end());
+    ReferenceKernels::multiplyAdd(reference, rowMajor, x);
+
+    return { "NeuralKernels::multiplyAdd<" + juce::String(Rows) + "," + juce::String(Cols) + ">",
+             ReferenceKernels::maxAbsDifference(y, reference), 1.0e-5 };
+}
+
+Check checkDot(std::mt19937& rng)
+{
+    const auto a = makeNoise(40, rng), b = makeNoise(40, rng);
+    const double error = std::abs(NeuralKernels::dot<40>(a.data(), b.data()) - ReferenceKernels::dot(a, b));
+    return { "NeuralKernels::dot<40>", error, 1.0e-5 };
+}
+
+Check checkActivations()
+{
+    double worst = 0.0;
+    for (int i = -8000; i <= 8000; ++i)
+    {
+        const float x = (float) i * 0.001f;
+        worst = std::max(worst, std::abs((double) NeuralKernels::tanh(x) - std::tanh((double) x)));
+        worst = std::max(worst, std::abs((double) NeuralKernels::sigmoid(x) - ReferenceKernels::sigmoid(x)));
+    }
+
+    // The Pade tanh is clamped at +-4.97, where it sits 1e-4 below 1
+    return { "NeuralKernels::tanh/sigmoid", worst, 2.0e-4 };
+}
+
+// Whole capture networks against double-precision references using std::tanh
+// and std::exp. The recurrent nets land near 1e-7; the conv stack sums eight
+// layers of activations that often sit near the tanh clamp, and lands near 3e-4
+Check checkNeuralNetwork(const juce::String& name, const NeuralConfig& config, std::mt19937& rng)
+{
+    const int size = config.architecture == NeuralConfig::convNet ? config.channels : config.hiddenSize;
+    std::normal_distribution<float> dist(0.0f, 1.0f / std::sqrt((float) size));
+    std::vector<float> weights((size_t) config.getNumWeights());
+    for (auto& w : weights)
+        w = dist(rng);
+
+    auto capture = NeuralCapture::create(config, weights);
+    if (capture == nullptr)
+        return { name + " (unsupported)", 1.0, 0.0 };
+    capture->prepare(config.sampleRate);
+
+    const auto input = makeNoise(4800, rng);
+    juce::AudioBuffer<float> buffer(1, (int) input.size());
+    buffer.copyFrom(0, 0, input.data(), (int) input.size());
+
+    // Odd block size, so chunks straddle block boundaries
+    for (int start = 0; start < buffer.getNumSamples(); start += 100)
+    {
+        const int n = juce::jmin(100, buffer.getNumSamples() - start);
+        juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 1, start, n);
+        capture->process(block);
+    }
+
+    const auto reference = config.architecture == NeuralConfig::lstm ? ReferenceKernels::lstm(weights, size, config.skip, input)
+                         : config.architecture == NeuralConfig::gru  ? ReferenceKernels::gru(weights, size, config.skip, input)
+                         : ReferenceKernels::convNet(weights, size, config.kernelSize, config.dilations, input);
+
+    const float* output = buffer.getReadPointer(0);
+    return { name, ReferenceKernels::maxAbsDifference(std::vector<float>(output, output + buffer.getNumSamples()), reference), 1.0e-3 };
+}
+
+std::vector<Check> checkNeuralNetworks(std::mt19937& rng)
+{
+    NeuralConfig lstm;
+    lstm.architecture = NeuralConfig::lstm;
+    lstm.hiddenSize = 16;
+    lstm.skip = true;
+
+    NeuralConfig gru = lstm;
+    gru.architecture = NeuralConfig::gru;
+    gru.hiddenSize = 20;
+
+    NeuralConfig conv;
+    conv.architecture = NeuralConfig::convNet;
+    conv.channels = 8;
+    conv.kernelSize = 3;
+    conv.dilations = { 1, 2, 4, 8, 16, 32, 64, 128 };
+
+    return { checkNeuralNetwork("NeuralAmp LSTM 16", lstm, rng),
+             checkNeuralNetwork("NeuralAmp GRU 20", gru, rng),
+             checkNeuralNetwork("NeuralAmp ConvNet 8ch K3 x8", conv, rng) };
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    bool quick = false;
+    juce::String moduleFilter;
+    juce::File jsonFile, baselineFile;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String arg(argv[i]);
+        if (arg == "--quick")
+            quick = true;
+        else if (arg == "--module" && i + 1 < argc)
+            moduleFilter = argv[++i];
+        else if (arg == "--json" && i + 1 < argc)
+            jsonFile = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        else if (arg == "--baseline" && i + 1 < argc)
+            baselineFile = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        else
+        {
+            std::printf("Usage: ModuleBenchmark [--quick] [--module name] [--json file] [--baseline file]\n");
+            return 2;
+        }
+    }
+
+    const std::vector<int> blockSizes = quick ? std::vector<int> { 64, 512 }
+                                              : std::vector<int> { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    const std::vector<double> sampleRates = quick ? std::vector<double> { 48000.0 }
+                                                  : std::vector<double> { 44100.0, 48000.0, 96000.0, 192000.0 };
+
+    // Earlier results, keyed by case
+    std::map<juce::String, double> baseline;
+    if (baselineFile.existsAsFile())
+    {
+        const auto old = juce::JSON::parse(baselineFile);
+        if (auto* results = old["results"].getArray())
+            for (auto& r : *results)
+                baseline[getCaseKey(r)] = (double) r["nsPerSample"];
+    }
+
+    juce::Array<juce::var> results;
+    int regressions = 0;
+
+    std::printf("%-14s %-16s %8s %6s %3s %10s\n", "Module", "Model", "Rate", "Block", "Ch", "ns/sample");
+
+    for (const auto& c : getCases())
+    {
+        if (moduleFilter.isNotEmpty() && ! c.module.containsIgnoreCase(moduleFilter))
+            continue;
+
+        for (double rate : sampleRates)
+        {
+            // A quarter second per case at the highest block size keeps the full matrix in minutes
+            const int numSamples = juce::jmax(4096 * 4, (int) (rate * 0.25));
+
+            for (int channels = c.stereoOnly ? 2 : 1; channels <= 2; ++channels)
+            {
+                const auto signal = makeSignal(channels, numSamples, rate);
+
+                for (int blockSize : blockSizes)
+                {
+                    const auto process = c.make({ rate, (juce::uint32) blockSize, (juce::uint32) channels });
+                    const double ns = measureNsPerSample(process, signal, blockSize);
+
+                    auto* r = new juce::DynamicObject();
+                    r->setProperty("module", c.module);
+                    r->setProperty("model", c.model);
+                    r->setProperty("modelName", c.modelName);
+                    r->setProperty("sampleRate", rate);
+                    r->setProperty("blockSize", blockSize);
+                    r->setProperty("channels", channels);
+                    r->setProperty("nsPerSample", ns);
+                    const juce::var result(r);
+
+                    juce::String note;
+                    auto old = baseline.find(getCaseKey(result));
+                    if (old != baseline.end() && old->second > 0.0)
+                    {
+                        const double change = ns / old->second - 1.0;
+                        note = juce::String(change >= 0.0 ? " +" : " ") + juce::String(change * 100.0, 1) + "%";
+                        if (change > 0.10)
+                        {
+                            note << " SLOWER";
+                            ++regressions;
+                        }
+                    }
+
+                    std::printf("%-14s %-16s %8.0f %6d %3d %10.2f%s\n", c.module.toRawUTF8(), c.modelName.toRawUTF8(),
+                                rate, blockSize, channels, ns, note.toRawUTF8());
+                    results.add(result);
+                }
+            }
+        }
+    }
+
+    // Optimized kernels against their scalar references
+    std::mt19937 rng(7);
+    std::vector<Check> checks {
+        checkFilterCascade(rng),
+        checkConvolver(rng),
+        checkWaveshaper(),
+        checkMultiplyAdd<16, 16>(rng),
+        checkMultiplyAdd<64, 16>(rng),
+        checkMultiplyAdd<96, 33>(rng),
+        checkDot(rng),
+        checkActivations()
+    };
+
+    for (const auto& c : checkNeuralNetworks(rng))
+        checks.push_back(c);
+
+    juce::Array<juce::var> verification;
+    bool allPass = true;
+
+    std::printf("\n%-32s %12s %12s\n", "Kernel", "Max error", "Tolerance");
+    for (const auto& c : checks)
+    {
+        const bool pass = c.maxError <= c.tolerance;
+        allPass = allPass && pass;
+        std::printf("%-32s %12.3g %12.3g %s\n", c.kernel.toRawUTF8(), c.maxError, c.tolerance, pass ? "ok" : "FAIL");
+
+        auto* v = new juce::DynamicObject();
+        v->setProperty("kernel", c.kernel);
+        v->setProperty("maxError", c.maxError);
+        v->setProperty("tolerance", c.tolerance);
+        v->setProperty("pass", pass);
+        verification.add(juce::var(v));
+    }
+
+    if (regressions > 0)
+        std::printf("\n%d case(s) more than 10%% slower than the baseline\n", regressions);
+
+    if (jsonFile != juce::File{})
+    {
+        auto* root = new juce::DynamicObject();
+        root->setProperty("version", 1);
+        root->setProperty("date", juce::Time::getCurrentTime().toISO8601(true));
+        root->setProperty("cpu", juce::SystemStats::getCpuModel());
+        root->setProperty("os", juce::SystemStats::getOperatingSystemName());
+        root->setProperty("results", results);
+        root->setProperty("verification", verification);
+
+        if (! jsonFile.replaceWithText(juce::JSON::toString(juce::var(root))))
+        {
+            std::fprintf(stderr, "Can't write %s\n", jsonFile.getFullPathName().toRawUTF8());
+            return 1;
+        }
+    }
+
+    return allPass ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+// JAGAT MULTI FX - Neural Amp Benchmark
+// Compares the neural capture engine against the waveshaper Preamp models
+//
+// Usage: NeuralAmpBenchmark [seconds] [blockSize]
+// Output: ns/sample, % of one core at 48 kHz, and real-time factor per case
+//
+// Compile against the plugin's JuceLibraryCode (JuceHeader.h) and JUCE modules, e.g.:
+//   g++ -std=c++17 -O3 -march=native -I../Builds/JuceLibraryCode -I../JUCE/modules
+//       NeuralAmpBenchmark.cpp -o NeuralAmpBenchmark <juce_core/juce_audio_basics objects>
+//
+// The captures use random weights at realistic sizes; only the cost matters here.
+
+#include <JuceHeader.h>
+#include "../Source/DSP/Preamp.h"
+#include "../Source/DSP/NeuralAmp.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+
+namespace {
+
+constexpr double sampleRate = 48000.0;
+
+struct Result
+{
+    double nsPerSample;
+    double percentOfCore;
+    double realtimeFactor;
+};
+
+// Times `process` over the whole signal, block by block, best of three runs
+Result measure(juce::AudioBuffer<float>& signal, int blockSize, const std::function<void(juce::AudioBuffer<float>&)>& process)
+{
+    juce::AudioBuffer<float> block(1, blockSize);
+    const int numSamples = signal.getNumSamples();
+    double best = 1.0e30;
+
+    for (int run = 0; run < 3; ++run)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int pos = 0; pos + blockSize <= numSamples; pos += blockSize)
+        {
+            block.copyFrom(0, 0, signal, 0, pos, blockSize);
+            process(block);
+        }
+
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+
+    const double processed = (double) (numSamples / blockSize * blockSize);
+    const double ns = best / processed;
+    return { ns, ns * sampleRate * 1.0e-7, 1.0e9 / (ns * sampleRate) };
+}
+
+std::unique_ptr<NeuralCapture> makeCapture(const NeuralConfig& config, std::mt19937& rng)
+{
+    const float scale = 1.0f / std::sqrt((float) (config.architecture == NeuralConfig::convNet ? config.channels : config.hiddenSize));
+    std::normal_distribution<float> dist(0.0f, scale);
+
+    std::vector<float> weights((size_t) config.getNumWeights());
+    for (auto& w : weights)
+        w = dist(rng);
+
+    auto capture = NeuralCapture::create(config, weights);
+    if (capture != nullptr)
+        capture->prepare(sampleRate);
+    return capture;
+}
+
+void print(const char* name, const Result& r)
+{
+    std::printf("%-28s %8.2f ns/sample %7.2f %% core %8.1fx realtime\n", name, r.nsPerSample, r.percentOfCore, r.realtimeFactor);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 10.0;
+    const int blockSize = argc > 2 ? std::atoi(argv[2]) : 256;
+
+    // Guitar-like test signal: decaying plucks over a little noise
+    juce::AudioBuffer<float> signal(1, (int) (seconds * sampleRate));
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> noise(-0.01f, 0.01f);
+    for (int s = 0; s < signal.getNumSamples(); ++s)
+    {
+        const double t = std::fmod(s / sampleRate, 0.5);
+        signal.setSample(0, s, (float) (0.6 * std::exp(-6.0 * t) * std::sin(2.0 * juce::MathConstants<double>::pi * 110.0 * s / sampleRate)) + noise(rng));
+    }
+
+    std::printf("%.1f s at %.0f Hz, block %d\n\n", seconds, sampleRate, blockSize);
+
+    juce::dsp::ProcessSpec spec { sampleRate, (juce::uint32) blockSize, 1 };
+
+    // Waveshaper Preamp models
+    const char* modelNames[] = { "Clean", "Crunch", "High Gain", "Metal", "Fender Twin", "Marshall JCM", "Mesa Rectifier", "Soldano Lead" };
+    for (int m = 0; m < 8; ++m)
+    {
+        Preamp preamp;
+        preamp.prepare(spec);
+        preamp.setParameters({ m, 5.0f, 5.0f });
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "Preamp %s", modelNames[m]);
+        print(name, measure(signal, blockSize, [&](juce::AudioBuffer<float>& b) { preamp.process(b); }));
+    }
+
+    std::printf("\n");
+
+    // Neural captures at common sizes
+    struct Case { std::string name; NeuralConfig config; };
+    std::vector<Case> cases;
+
+    for (int h : { 16, 20, 32, 40 })
+    {
+        NeuralConfig lstm;
+        lstm.architecture = NeuralConfig::lstm;
+        lstm.hiddenSize = h;
+        lstm.skip = true;
+        cases.push_back({ "LSTM " + std::to_string(h), lstm });
+
+        NeuralConfig gru = lstm;
+        gru.architecture = NeuralConfig::gru;
+        cases.push_back({ "GRU " + std::to_string(h), gru });
+    }
+
+    for (int c : { 8, 16 })
+    {
+        NeuralConfig conv;
+        conv.architecture = NeuralConfig::convNet;
+        conv.channels = c;
+        conv.kernelSize = 3;
+        conv.dilations = { 1, 2, 4, 8, 16, 32, 64, 128, 256, 512 };
+        cases.push_back({ "ConvNet " + std::to_string(c) + "ch K3 x10", conv });
+    }
+
+    for (auto& c : cases)
+    {
+        auto capture = makeCapture(c.config, rng);
+        if (capture == nullptr)
+        {
+            std::printf("%-28s unsupported\n", c.name.c_str());
+            continue;
+        }
+
+        print(c.name.c_str(), measure(signal, blockSize, [&](juce::AudioBuffer<float>& b) { capture->process(b); }));
+    }
+
+    return 0;
+}
@@ -0,0 +1,530 @@
+// JAGAT MULTI FX - Offline Render
+// Runs audio through the full GuitarMultiFXProcessor with no editor and no audio
+// device, and reports throughput. This is the reproducible benchmark and the
+// regression gate for performance changes; it runs on a headless Linux box.
+//
+// Usage: OfflineRender [options]
+//   --input <file>      Audio file to render (default: generated test signal)
+//   --signal <name>     Generated signal: pluck, chord, noise or silence (default pluck)
+//   --seconds <n>       Length of the generated signal (default 10)
+//   --rate <hz>         Sample rate (default 48000; input files are resampled to it)
+//   --block <n>         Block size (default 256)
+//   --preset <1-35>     Factory preset (default 1)
+//   --state <file>      Plugin state blob or .gfxpreset XML instead of a preset
+//   --sweep             Render every factory preset, one summary line each
+//   --runs <n>          Repeat each render, keep the fastest (default 3)
+//   --output <path>     Write the result as 24-bit WAV (a directory with --sweep)
+//   --min-rtf <x>       Exit with status 1 if any render is slower than x times real time
+//   --check             Run the behaviour checks instead; exit with status 1 if any fails
+//
+// Output: real-time factor, mean / p99 / worst block time against the block budget,
+// and the per-stage breakdown from StageProfiler.
+//
+// Compile against the plugin's JuceLibraryCode with the profiler in and the editor out, e.g.:
+//   g++ -std=c++17 -O3 -DNDEBUG -DJAGATFX_PROFILER=1 -DJAGATFX_HEADLESS=1
+//       -I../Builds/JuceLibraryCode -I../JUCE/modules OfflineRender.cpp ../Source/PluginProcessor.cpp
+//       ../Source/FXEngine.cpp ../Source/DSP/*.cpp -o OfflineRender <JUCE module objects: core, events, data_structures,
+//       audio_basics, audio_formats, audio_processors, dsp and their GUI dependencies>
+// The GUI modules are only linked, never used: no display is needed.
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+#include "../Source/FactoryPresets.h"
+
+#if ! JAGATFX_PROFILER || ! JAGATFX_HEADLESS
+ #error "Build OfflineRender with -DJAGATFX_PROFILER=1 -DJAGATFX_HEADLESS=1"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Options
+{
+    juce::File input, state, output;
+    juce::String signal = "pluck";
+    double seconds = 10.0;
+    double sampleRate = 48000.0;
+    int blockSize = 256;
+    int preset = 1;
+    int runs = 3;
+    bool sweep = false;
+    bool check = false;
+    double minRealtimeFactor = 0.0;
+};
+
+struct RenderResult
+{
+    double realtimeFactor = 0.0;
+    double meanBlockUs = 0.0, p99BlockUs = 0.0, worstBlockUs = 0.0;
+    double budgetUs = 0.0;
+    StageProfiler::Snapshot stages;
+};
+
+void printUsage()
+{
+    std::printf("Usage: OfflineRender [--input file | --signal pluck|chord|noise|silence] [--seconds n]\n"
+                "                     [--rate hz] [--block n] [--preset 1-%d | --state file] [--sweep]\n"
+                "                     [--runs n] [--output path] [--min-rtf x] [--check]\n", FactoryPresets::getNumPresets());
+}
+
+bool parseOptions(int argc, char* argv[], Options& o)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String arg(argv[i]);
+        const bool hasValue = i + 1 < argc;
+        auto value = [&]() { return juce::String(argv[++i]); };
+
+        if (arg == "--sweep")                       o.sweep = true;
+        else if (arg == "--check")                  o.check = true;
+        else if (! hasValue)                        return false;
+        else if (arg == "--input")                  o.input = juce::File::getCurrentWorkingDirectory().getChildFile(value());
+        else if (arg == "--state")                  o.state = juce::File::getCurrentWorkingDirectory().getChildFile(value());
+        else if (arg == "--output")                 o.output = juce::File::getCurrentWorkingDirectory().getChildFile(value());
+        else if (arg == "--signal")                 o.signal = value();
+        else if (arg == "--seconds")                o.seconds = value().getDoubleValue();
+        else if (arg == "--rate")                   o.sampleRate = value().getDoubleValue();
+        else if (arg == "--block")                  o.blockSize = value().getIntValue();
+        else if (arg == "--preset")                 o.preset = value().getIntValue();
+        else if (arg == "--runs")                   o.runs = value().getIntValue();
+        else if (arg == "--min-rtf")                o.minRealtimeFactor = value().getDoubleValue();
+        else                                        return false;
+    }
+
+    return o.sampleRate >= 8000.0 && o.blockSize > 0 && o.runs > 0 && o.seconds > 0.0
+        && o.preset >= 1 && o.preset <= FactoryPresets::getNumPresets();
+}
+
+//==============================================================================
+// Input
+
+juce::AudioBuffer<float> generateSignal(const juce::String& name, double seconds, double sampleRate)
+{
+    juce::AudioBuffer<float> signal(2, (int) (seconds * sampleRate));
+    signal.clear();
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+    const double twoPi = juce::MathConstants<double>::twoPi;
+
+    for (int s = 0; s < signal.getNumSamples(); ++s)
+    {
+        const double t = s / sampleRate;
+        const double pluckTime = std::fmod(t, 0.5);
+        float v = 0.0f;
+
+        if (name == "pluck") // Decaying low A every half second over a little noise
+            v = (float) (0.6 * std::exp(-6.0 * pluckTime) * std::sin(twoPi * 110.0 * t)) + 0.01f * noise(rng);
+        else if (name == "chord") // E major, strummed every two seconds
+            for (double f : { 82.41, 123.47, 164.81, 207.65, 246.94, 329.63 })
+                v += (float) (0.15 * std::exp(-2.0 * std::fmod(t, 2.0)) * std::sin(twoPi * f * t));
+        else if (name == "noise")
+            v = 0.25f * noise(rng);
+
+        signal.setSample(0, s, v);
+    }
+
+    // Guitar input is mono: both channels carry the same signal
+    signal.copyFrom(1, 0, signal, 0, 0, signal.getNumSamples());
+    return signal;
+}
+
+bool readInput(const juce::File& file, double sampleRate, juce::AudioBuffer<float>& signal)
+{
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+    if (reader == nullptr)
+        return false;
+
+    juce::AudioBuffer<float> source(2, (int) reader->lengthInSamples);
+    reader->read(&source, 0, (int) reader->lengthInSamples, 0, true, true);
+
+    // Resample to the render rate if the file differs
+    const double ratio = reader->sampleRate / sampleRate;
+    const int numSamples = (int) (source.getNumSamples() / ratio);
+    signal.setSize(2, numSamples);
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        if (ratio == 1.0)
+        {
+            signal.copyFrom(ch, 0, source, ch, 0, numSamples);
+            continue;
+        }
+
+        juce::LagrangeInterpolator interpolator;
+        interpolator.process(ratio, source.getReadPointer(ch), signal.getWritePointer(ch), numSamples,
+                             source.getNumSamples(), 0);
+    }
+
+    return true;
+}
+
+bool loadState(GuitarMultiFXProcessor& processor, const juce::File& file)
+{
+    juce::MemoryBlock data;
+    if (! file.loadFileAsData(data) || data.getSize() == 0)
+        return false;
+
+    // A saved .gfxpreset is plain XML; anything else is treated as a host state blob
+    if (static_cast<const char*>(data.getData())[0] == '<')
+    {
+        auto xml = juce::parseXML(data.toString());
+        if (xml == nullptr)
+            return false;
+
+        auto state = juce::ValueTree::fromXml(*xml);
+        if (! state.isValid())
+            return false;
+
+        processor.getAPVTS().replaceState(state);
+        return true;
+    }
+
+    processor.setStateInformation(data.getData(), (int) data.getSize());
+    return true;
+}
+
+bool writeOutput(const juce::File& file, const juce::AudioBuffer<float>& audio, double sampleRate)
+{
+    file.deleteFile();
+    auto stream = file.createOutputStream();
+    if (stream == nullptr)
+        return false;
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate,
+        (unsigned int) audio.getNumChannels(), 24, {}, 0));
+    if (writer == nullptr)
+        return false;
+
+    stream.release(); // Now owned by the writer
+    return writer->writeFromAudioSampleBuffer(audio, 0, audio.getNumSamples());
+}
+
+//==============================================================================
+// Render
+
+RenderResult render(GuitarMultiFXProcessor& processor, const juce::AudioBuffer<float>& input,
+                    const Options& o, juce::AudioBuffer<float>* output)
+{
+    using clock = std::chrono::steady_clock;
+
+    const int numSamples = input.getNumSamples();
+    const int numBlocks = (numSamples + o.blockSize - 1) / o.blockSize;
+
+    juce::AudioBuffer<float> block(2, o.blockSize);
+    juce::MidiBuffer midi;
+    std::vector<double> blockNs((size_t) numBlocks);
+
+    RenderResult best;
+    best.realtimeFactor = -1.0;
+
+    for (int run = 0; run < o.runs; ++run)
+    {
+        // Same starting state for every run
+        processor.releaseResources();
+        processor.prepareToPlay(o.sampleRate, o.blockSize);
+        processor.profiler.reset();
+
+        double totalNs = 0.0;
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            const int start = b * o.blockSize;
+            const int length = juce::jmin(o.blockSize, numSamples - start);
+
+            juce::AudioBuffer<float> view(block.getArrayOfWritePointers(), 2, length);
+            for (int ch = 0; ch < 2; ++ch)
+                view.copyFrom(ch, 0, input, ch, start, length);
+
+            const auto t0 = clock::now();
+            processor.processBlock(view, midi);
+            const double ns = std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+
+            blockNs[(size_t) b] = ns;
+            totalNs += ns;
+
+            if (output != nullptr && run == 0)
+                for (int ch = 0; ch < 2; ++ch)
+                    output->copyFrom(ch, start, view, ch, 0, length);
+        }
+
+        const double rtf = (numSamples / o.sampleRate) * 1.0e9 / totalNs;
+        if (rtf <= best.realtimeFactor)
+            continue;
+
+        std::sort(blockNs.begin(), blockNs.end());
+        best.realtimeFactor = rtf;
+        best.meanBlockUs = totalNs / numBlocks / 1000.0;
+        best.p99BlockUs = blockNs[(size_t) ((numBlocks - 1) * 99 / 100)] / 1000.0;
+        best.worstBlockUs = blockNs.back() / 1000.0;
+        best.budgetUs = o.blockSize / o.sampleRate * 1.0e6;
+        best.stages = processor.profiler.summarize();
+    }
+
+    return best;
+}
+
+// Most expensive stage by mean time, excluding the whole-block total
+int getHeaviestStage(const StageProfiler::Snapshot& s)
+{
+    int heaviest = 0;
+    for (int i = 1; i < StageProfiler::total; ++i)
+        if (s.stages[(size_t) i].meanNs > s.stages[(size_t) heaviest].meanNs)
+            heaviest = i;
+    return heaviest;
+}
+
+//==============================================================================
+// Behaviour checks: regressions that only show across many blocks of the
+// whole processor
+
+struct Check
+{
+    const char* name;
+    bool passed;
+    juce::String detail;
+};
+
+void setParameter(GuitarMultiFXProcessor& processor, Params::Index index, float value)
+{
+    auto* param = processor.getAPVTS().getParameter(Params::ids[index]);
+    param->setValueNotifyingHost(param->convertTo0to1(value));
+}
+
+// Processes the next numSamples of input from position on, block by block
+juce::AudioBuffer<float> renderSpan(GuitarMultiFXProcessor& processor, const juce::AudioBuffer<float>& input,
+                                    int& position, int numSamples, int blockSize)
+{
+    juce::AudioBuffer<float> out(2, numSamples);
+    juce::MidiBuffer midi;
+
+    for (int start = 0; start < numSamples; start += blockSize)
+    {
+        const int length = juce::jmin(blockSize, numSamples - start);
+        juce::AudioBuffer<float> view(out.getArrayOfWritePointers(), 2, start, length);
+        for (int ch = 0; ch < 2; ++ch)
+            view.copyFrom(ch, 0, input, ch, position + start, length);
+
+        processor.processBlock(view, midi);
+    }
+
+    position += numSamples;
+    return out;
+}
+
+double getRms(const juce::AudioBuffer<float>& b)
+{
+    double sum = 0.0;
+    for (int ch = 0; ch < b.getNumChannels(); ++ch)
+    {
+        const double rms = b.getRMSLevel(ch, 0, b.getNumSamples());
+        sum += rms * rms;
+    }
+    return std::sqrt(sum / b.getNumChannels());
+}
+
+// A preset switch posted while the tuner mutes the output must still complete:
+// the sound comes back when the tuner goes off, and parameters are read again
+Check checkSwitchWhileTuning(GuitarMultiFXProcessor& processor, const juce::AudioBuffer<float>& input, const Options& o)
+{
+    const int tenth = (int) (0.1 * o.sampleRate), half = (int) (0.5 * o.sampleRate);
+
+    FactoryPresets::apply(processor.getAPVTS(), 1);
+    setParameter(processor, Params::tunerEnabled, 1.0f);
+    processor.prepareToPlay(o.sampleRate, o.blockSize);
+
+    int position = 0;
+    renderSpan(processor, input, position, tenth, o.blockSize);
+    processor.loadPresetSlot(1);
+    renderSpan(processor, input, position, tenth, o.blockSize);
+
+    setParameter(processor, Params::tunerEnabled, 0.0f);
+    renderSpan(processor, input, position, half, o.blockSize);
+
+    // Same half-second of the pluck pattern each time, 12 dB apart
+    const double level = getRms(renderSpan(processor, input, position, half, o.blockSize));
+    const float outputGain = processor.getAPVTS().getRawParameterValue(Params::ids[Params::outputGain])->load();
+    setParameter(processor, Params::outputGain, outputGain - 12.0f);
+    const double quieter = getRms(renderSpan(processor, input, position, half, o.blockSize));
+
+    const bool passed = level > 1.0e-3 && quieter < 0.5 * level;
+    return { "Preset switch while the tuner is on", passed,
+             juce::String::formatted("RMS %.4f after the tuner, %.4f with output gain -12 dB", level, quieter) };
+}
+
+// Dual-mono input runs channel 0 alone. When it turns stereo, channel 1 has
+// to carry on from channel 0's state, not from where it froze: right after
+// the switch it should match a processor that had the stereo input all along
+Check checkMonoToStereo(GuitarMultiFXProcessor& processor, const juce::AudioBuffer<float>& input, const Options& o)
+{
+    const int length = (int) (1.0 * o.sampleRate), transition = (int) (0.75 * o.sampleRate);
+    const int window = (int) (0.05 * o.sampleRate);
+
+    // Channel 1 a hair quieter: stereo to the dual-mono test, but close enough to compare
+    juce::AudioBuffer<float> stereo;
+    stereo.makeCopyOf(input);
+    stereo.applyGain(1, 0, stereo.getNumSamples(), 0.999f);
+
+    juce::AudioBuffer<float> switching;
+    switching.makeCopyOf(stereo);
+    switching.copyFrom(1, 0, input, 1, 0, transition);
+
+    GuitarMultiFXProcessor reference;
+    reference.setPlayConfigDetails(2, 2, o.sampleRate, o.blockSize);
+
+    // Mid-pluck, through the amp, phaser and cab, where stale state shows most
+    for (auto* p : { &processor, &reference })
+    {
+        FactoryPresets::apply(p->getAPVTS(), 1);
+        setParameter(*p, Params::tunerEnabled, 0.0f);
+        setParameter(*p, Params::inputGain, 0.0f);
+        setParameter(*p, Params::outputGain, 0.0f);
+        setParameter(*p, Params::phaserEnabled, 1.0f);
+        p->prepareToPlay(o.sampleRate, o.blockSize);
+    }
+
+    int position = 0, referencePosition = 0;
+    const auto out = renderSpan(processor, switching, position, length, o.blockSize);
+    const auto expected = renderSpan(reference, stereo, referencePosition, length, o.blockSize);
+
+    float error = 0.0f, peak = 0.0f;
+    for (int s = transition; s < transition + window; ++s)
+    {
+        error = juce::jmax(error, std::abs(out.getSample(1, s) - expected.getSample(1, s)));
+        peak = juce::jmax(peak, std::abs(expected.getSample(1, s)));
+    }
+
+    const bool passed = peak > 1.0e-3f && error < 0.05f * peak;
+    return { "Dual mono turning stereo", passed,
+             juce::String::formatted("channel 1 off by %.4f against a %.4f peak in the next 50 ms", error, peak) };
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options o;
+    if (! parseOptions(argc, argv, o))
+    {
+        printUsage();
+        return 2;
+    }
+
+    juce::ScopedJuceInitialiser_GUI juceInit; // Message manager for the parameter tree; opens no window
+
+    juce::AudioBuffer<float> input;
+    if (o.input != juce::File{})
+    {
+        if (! readInput(o.input, o.sampleRate, input))
+        {
+            std::fprintf(stderr, "Can't read %s\n", o.input.getFullPathName().toRawUTF8());
+            return 1;
+        }
+    }
+    else
+    {
+        input = generateSignal(o.signal, o.seconds, o.sampleRate);
+    }
+
+    GuitarMultiFXProcessor processor;
+    processor.setPlayConfigDetails(2, 2, o.sampleRate, o.blockSize);
+
+    if (o.check)
+    {
+        const auto pluck = generateSignal("pluck", 4.0, o.sampleRate);
+        const std::vector<Check> checks { checkSwitchWhileTuning(processor, pluck, o),
+                                          checkMonoToStereo(processor, pluck, o) };
+
+        bool allPass = true;
+        for (const auto& c : checks)
+        {
+            std::printf("%-40s %s  %s\n", c.name, c.passed ? "ok  " : "FAIL", c.detail.toRawUTF8());
+            allPass = allPass && c.passed;
+        }
+        return allPass ? 0 : 1;
+    }
+
+    std::printf("%.2f s at %.0f Hz, block %d (budget %.1f us), best of %d\n\n",
+                input.getNumSamples() / o.sampleRate, o.sampleRate, o.blockSize,
+                o.blockSize / o.sampleRate * 1.0e6, o.runs);
+
+    bool tooSlow = false;
+    juce::AudioBuffer<float> output(2, input.getNumSamples());
+    const auto names = FactoryPresets::getNames();
+
+    if (o.sweep)
+    {
+        if (o.output != juce::File{})
+            o.output.createDirectory();
+
+        std::printf("%-3s %-34s %8s %9s %9s %9s %8s  %s\n", "#", "Preset", "RTF", "Mean us", "P99 us", "Worst us", "Worst %", "Heaviest stage");
+
+        for (int id = 1; id <= FactoryPresets::getNumPresets(); ++id)
+        {
+            FactoryPresets::apply(processor.getAPVTS(), id);
+            const bool write = o.output != juce::File{};
+            auto r = render(processor, input, o, write ? &output : nullptr);
+
+            const int heaviest = getHeaviestStage(r.stages);
+            std::printf("%-3d %-34s %8.1f %9.1f %9.1f %9.1f %8.1f  %s (%.1f us)\n", id, names[id - 1].toRawUTF8(),
+                        r.realtimeFactor, r.meanBlockUs, r.p99BlockUs, r.worstBlockUs, 100.0 * r.worstBlockUs / r.budgetUs,
+                        StageProfiler::getStageName((StageProfiler::Stage) heaviest), r.stages.stages[(size_t) heaviest].meanNs / 1000.0f);
+
+            if (write)
+                writeOutput(o.output.getChildFile(juce::String(id).paddedLeft('0', 2) + " "
+                                                  + juce::File::createLegalFileName(names[id - 1]) + ".wav"),
+                            output, o.sampleRate);
+
+            tooSlow = tooSlow || r.realtimeFactor < o.minRealtimeFactor;
+        }
+    }
+    else
+    {
+        if (o.state != juce::File{})
+        {
+            if (! loadState(processor, o.state))
+            {
+                std::fprintf(stderr, "Can't load state from %s\n", o.state.getFullPathName().toRawUTF8());
+                return 1;
+            }
+            std::printf("State: %s\n", o.state.getFileName().toRawUTF8());
+        }
+        else
+        {
+            FactoryPresets::apply(processor.getAPVTS(), o.preset);
+            std::printf("Preset %d: %s\n", o.preset, names[o.preset - 1].toRawUTF8());
+        }
+
+        auto r = render(processor, input, o, o.output != juce::File{} ? &output : nullptr);
+
+        std::printf("Real-time factor %.1fx\n", r.realtimeFactor);
+        std::printf("Block time: mean %.1f us, p99 %.1f us, worst %.1f us (%.1f %% of budget)\n\n",
+                    r.meanBlockUs, r.p99BlockUs, r.worstBlockUs, 100.0 * r.worstBlockUs / r.budgetUs);
+        std::printf("%s", StageProfiler::formatReport(r.stages).toRawUTF8());
+
+        if (o.output != juce::File{} && ! writeOutput(o.output, output, o.sampleRate))
+        {
+            std::fprintf(stderr, "Can't write %s\n", o.output.getFullPathName().toRawUTF8());
+            return 1;
+        }
+
+        tooSlow = r.realtimeFactor < o.minRealtimeFactor;
+    }
+
+    if (tooSlow)
+    {
+        std::fprintf(stderr, "Slower than the required %.1fx real time\n", o.minRealtimeFactor);
+        return 1;
+    }
+
+    return 0;
+}
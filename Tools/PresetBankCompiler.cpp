@@ -0,0 +1,151 @@
+// JAGAT MULTI FX - Preset Bank Compiler
+// Compiles a text preset source into a binary .gfxbank (see Source/PresetBank.h).
+// The factory bank is built from Resources/FactoryPresets.txt into
+// Resources/FactoryPresets.gfxbank, which the project embeds as BinaryData:
+// rerun this whenever the source changes.
+//
+// Usage: PresetBankCompiler <source.txt> <output.gfxbank>
+//
+// Source format:
+//   # comment (also after a value)
+//   [Preset Name]
+//   parameterId = value      plain units as shown in the plugin; choices by index
+// Parameters a preset leaves out take their default. Unknown IDs, the session-wide
+// settings (gains, oversampling, tuner; recall keeps them) and values out of range
+// are errors, reported with their line number.
+//
+// Compile against the plugin's JuceLibraryCode with the editor out, e.g.:
+//   g++ -std=c++17 -O2 -DJAGATFX_HEADLESS=1 -I../Builds/JuceLibraryCode -I../JUCE/modules
+//       PresetBankCompiler.cpp ../Source/PluginProcessor.cpp ../Source/FXEngine.cpp ../Source/DSP/*.cpp
+//       -o PresetBankCompiler <JUCE module objects, as for OfflineRender>
+// The processor is only instantiated to read each parameter's range and default.
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+#include "../Source/PresetBank.h"
+
+#if ! JAGATFX_HEADLESS
+ #error "Build PresetBankCompiler with -DJAGATFX_HEADLESS=1"
+#endif
+
+#include <cstdio>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        std::printf("Usage: PresetBankCompiler <source.txt> <output.gfxbank>\n");
+        return 2;
+    }
+
+    const auto cwd = juce::File::getCurrentWorkingDirectory();
+    const auto sourceFile = cwd.getChildFile(argv[1]);
+    const auto outputFile = cwd.getChildFile(argv[2]);
+
+    juce::StringArray lines;
+    sourceFile.readLines(lines);
+    if (lines.isEmpty())
+    {
+        std::fprintf(stderr, "Can't read %s\n", sourceFile.getFullPathName().toRawUTF8());
+        return 1;
+    }
+
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    GuitarMultiFXProcessor processor;
+    auto& apvts = processor.getAPVTS();
+
+    ParameterValues defaults;
+    for (int i = 0; i < Params::count; ++i)
+    {
+        auto* param = apvts.getParameter(Params::ids[i]);
+        defaults.set(static_cast<Params::Index>(i), param->convertFrom0to1(param->getDefaultValue()));
+    }
+
+    juce::StringArray names;
+    std::vector<ParameterValues> presets;
+    int errors = 0;
+
+    auto fail = [&](int line, const juce::String& message)
+    {
+        std::fprintf(stderr, "%s:%d: %s\n", sourceFile.getFileName().toRawUTF8(), line + 1, message.toRawUTF8());
+        ++errors;
+    };
+
+    for (int n = 0; n < lines.size(); ++n)
+    {
+        const auto line = lines[n].upToFirstOccurrenceOf("#", false, false).trim();
+        if (line.isEmpty())
+            continue;
+
+        if (line.startsWithChar('[') && line.endsWithChar(']'))
+        {
+            const auto name = line.substring(1, line.length() - 1).trim();
+            if (name.isEmpty() || (int) name.getNumBytesAsUTF8() >= PresetBank::nameLength)
+                fail(n, "preset name must be 1-" + juce::String(PresetBank::nameLength - 1) + " bytes");
+
+            names.add(name);
+            presets.push_back(defaults);
+            continue;
+        }
+
+        if (presets.empty())
+        {
+            fail(n, "value before the first [Preset Name]");
+            continue;
+        }
+
+        const auto id = line.upToFirstOccurrenceOf("=", false, false).trim();
+        const auto valueText = line.fromFirstOccurrenceOf("=", false, false).trim();
+        const int index = Params::indexOf(id.toRawUTF8());
+
+        if (! line.containsChar('=') || valueText.isEmpty())
+        {
+            fail(n, "expected parameterId = value");
+            continue;
+        }
+
+        if (index < 0)
+        {
+            fail(n, "unknown parameter '" + id + "'");
+            continue;
+        }
+
+        if (Params::isGlobal(index))
+        {
+            fail(n, id + " is a session setting, not part of a preset");
+            continue;
+        }
+
+        const float value = valueText.getFloatValue();
+        const auto range = apvts.getParameter(id)->getNormalisableRange();
+        if (value < range.start || value > range.end)
+        {
+            fail(n, id + " = " + valueText + " is outside " + juce::String(range.start) + " to " + juce::String(range.end));
+            continue;
+        }
+
+        presets.back().set(static_cast<Params::Index>(index), value);
+    }
+
+    if (errors > 0)
+        return 1;
+
+    if (presets.empty())
+    {
+        std::fprintf(stderr, "%s has no presets\n", sourceFile.getFileName().toRawUTF8());
+        return 1;
+    }
+
+    outputFile.deleteFile();
+    juce::FileOutputStream out(outputFile);
+    if (! out.openedOk() || ! PresetBank::write(out, names, presets))
+    {
+        std::fprintf(stderr, "Can't write %s\n", outputFile.getFullPathName().toRawUTF8());
+        return 1;
+    }
+
+    std::printf("%d presets x %d parameters -> %s (%lld bytes)\n", (int) presets.size(), (int) Params::count,
+                outputFile.getFileName().toRawUTF8(), (long long) out.getPosition());
+    return 0;
+}
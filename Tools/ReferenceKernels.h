@@ -0,0 +1,204 @@
+// JAGAT MULTI FX - Reference Kernels
+// Plain scalar, double-precision versions of the optimized DSP kernels. They
+// favour obviousness over speed and are only used by the benchmark tools to
+// check that an optimized kernel still agrees with the math it replaces.
+
+#pragma once
+#include <JuceHeader.h>
+#include "../Source/DSP/Biquad.h"
+
+#include <cmath>
+#include <vector>
+
+namespace ReferenceKernels
+{
+    /** Biquads in series, direct form I, one channel. Same result as FilterCascade. */
+    inline std::vector<double> biquadCascade(const std::vector<Biquad::Coefficients>& sections,
+                                             const std::vector<float>& input, double gain = 1.0)
+    {
+        std::vector<double> signal(input.begin(), input.end());
+        for (auto& s : signal)
+            s *= gain;
+
+        for (const auto& c : sections)
+        {
+            double x1 = 0.0, x2 = 0.0, y1 = 0.0, y2 = 0.0;
+            for (auto& s : signal)
+            {
+                const double y = c.b0 * s + c.b1 * x1 + c.b2 * x2 - c.a1 * y1 - c.a2 * y2;
+                x2 = x1; x1 = s;
+                y2 = y1; y1 = y;
+                s = y;
+            }
+        }
+
+        return signal;
+    }
+
+    /** Direct time-domain convolution, one channel. Same result as PartitionedConvolver. */
+    inline std::vector<double> convolve(const std::vector<float>& ir, const std::vector<float>& input)
+    {
+        std::vector<double> out(input.size(), 0.0);
+        for (size_t n = 0; n < input.size(); ++n)
+        {
+            double sum = 0.0;
+            const size_t taps = std::min(ir.size(), n + 1);
+            for (size_t k = 0; k < taps; ++k)
+                sum += (double) ir[k] * input[n - k];
+            out[n] = sum;
+        }
+        return out;
+    }
+
+    /** y += M x with M row-major [rows][cols]. Same result as NeuralKernels::multiplyAdd. */
+    inline void multiplyAdd(std::vector<double>& y, const std::vector<float>& m, const std::vector<float>& x)
+    {
+        const size_t cols = x.size();
+        for (size_t r = 0; r < y.size(); ++r)
+            for (size_t c = 0; c < cols; ++c)
+                y[r] += (double) m[r * cols + c] * x[c];
+    }
+
+    inline double dot(const std::vector<float>& a, const std::vector<float>& b)
+    {
+        double sum = 0.0;
+        for (size_t i = 0; i < a.size(); ++i)
+            sum += (double) a[i] * b[i];
+        return sum;
+    }
+
+    inline double sigmoid(double x) { return 1.0 / (1.0 + std::exp(-x)); }
+
+    /** Single-layer LSTM plus dense head, weights as documented on LSTMNetwork. */
+    inline std::vector<double> lstm(const std::vector<float>& w, int h, bool skip, const std::vector<float>& input)
+    {
+        const size_t H = (size_t) h, G = 4 * H;
+        const float* wIh = w.data();
+        const float* wHh = wIh + G;
+        const float* bIh = wHh + G * H;
+        const float* bHh = bIh + G;
+        const float* head = bHh + G;
+        const double headBias = head[H];
+
+        std::vector<double> hidden(H, 0.0), cell(H, 0.0), gates(G), out(input.size());
+        for (size_t n = 0; n < input.size(); ++n)
+        {
+            const double x = input[n];
+            for (size_t r = 0; r < G; ++r)
+            {
+                gates[r] = (double) bIh[r] + bHh[r] + wIh[r] * x;
+                for (size_t c = 0; c < H; ++c)
+                    gates[r] += (double) wHh[r * H + c] * hidden[c];
+            }
+
+            double y = headBias + (skip ? x : 0.0);
+            for (size_t r = 0; r < H; ++r)
+            {
+                cell[r] = sigmoid(gates[H + r]) * cell[r] + sigmoid(gates[r]) * std::tanh(gates[2 * H + r]);
+                hidden[r] = sigmoid(gates[3 * H + r]) * std::tanh(cell[r]);
+                y += head[r] * hidden[r];
+            }
+            out[n] = y;
+        }
+        return out;
+    }
+
+    /** Single-layer GRU plus dense head, weights as documented on GRUNetwork. */
+    inline std::vector<double> gru(const std::vector<float>& w, int h, bool skip, const std::vector<float>& input)
+    {
+        const size_t H = (size_t) h, G = 3 * H;
+        const float* wIh = w.data();
+        const float* wHh = wIh + G;
+        const float* bIh = wHh + G * H;
+        const float* bHh = bIh + G;
+        const float* head = bHh + G;
+        const double headBias = head[H];
+
+        std::vector<double> hidden(H, 0.0), hh(G), out(input.size());
+        for (size_t n = 0; n < input.size(); ++n)
+        {
+            const double x = input[n];
+            for (size_t r = 0; r < G; ++r)
+            {
+                hh[r] = bHh[r];
+                for (size_t c = 0; c < H; ++c)
+                    hh[r] += (double) wHh[r * H + c] * hidden[c];
+            }
+
+            double y = headBias + (skip ? x : 0.0);
+            for (size_t r = 0; r < H; ++r)
+            {
+                const double reset = sigmoid(wIh[r] * x + bIh[r] + hh[r]);
+                const double update = sigmoid(wIh[H + r] * x + bIh[H + r] + hh[H + r]);
+                const double n = std::tanh(wIh[2 * H + r] * x + bIh[2 * H + r] + reset * hh[2 * H + r]);
+                hidden[r] = (1.0 - update) * n + update * hidden[r];
+                y += head[r] * hidden[r];
+            }
+            out[n] = y;
+        }
+        return out;
+    }
+
+    /** Dilated conv stack, weights as documented on ConvNetwork; the whole signal at once. */
+    inline std::vector<double> convNet(const std::vector<float>& w, int channels, int kernelSize,
+                                       const std::vector<int>& dilations, const std::vector<float>& input)
+    {
+        const size_t C = (size_t) channels, K = (size_t) kernelSize, N = input.size();
+        const float* p = w.data();
+
+        std::vector<std::vector<double>> x(C, std::vector<double>(N)), skip(C, std::vector<double>(N, 0.0)), a = skip;
+        for (size_t c = 0; c < C; ++c)
+            for (size_t n = 0; n < N; ++n)
+                x[c][n] = (double) p[c] * input[n] + p[C + c];
+        p += 2 * C;
+
+        for (int dilation : dilations)
+        {
+            const float* conv = p;
+            const float* convBias = conv + C * C * K;
+            const float* mix = convBias + C;
+            const float* mixBias = mix + C * C;
+            p = mixBias + C;
+
+            for (size_t o = 0; o < C; ++o)
+                for (size_t n = 0; n < N; ++n)
+                {
+                    double z = convBias[o];
+                    for (size_t i = 0; i < C; ++i)
+                        for (size_t k = 0; k < K; ++k)
+                        {
+                            const size_t back = (K - 1 - k) * (size_t) dilation;
+                            if (n >= back)
+                                z += (double) conv[(o * C + i) * K + k] * x[i][n - back];
+                        }
+                    a[o][n] = std::tanh(z);
+                    skip[o][n] += a[o][n];
+                }
+
+            for (size_t o = 0; o < C; ++o)
+                for (size_t n = 0; n < N; ++n)
+                {
+                    double sum = mixBias[o];
+                    for (size_t i = 0; i < C; ++i)
+                        sum += (double) mix[o * C + i] * a[i][n];
+                    x[o][n] += sum;
+                }
+        }
+
+        std::vector<double> out(N, (double) p[C]);
+        for (size_t c = 0; c < C; ++c)
+            for (size_t n = 0; n < N; ++n)
+                out[n] += p[c] * skip[c][n];
+        return out;
+    }
+
+    /** Largest absolute difference between two signals of the same length. */
+    template <typename A, typename B>
+    inline double maxAbsDifference(const A& a, const B& b)
+    {
+        double worst = 0.0;
+        for (size_t i = 0; i < a.size() && i < b.size(); ++i)
+            worst = std::max(worst, std::abs((double) a[i] - (double) b[i]));
+        return worst;
+    }
+}